@@ -0,0 +1,539 @@
+//*****************************************************************************
+//
+// telemetrydecode.c - Host decoder for the uarttelemetry records.
+//
+// Reads the console port of a board that sends records with uarttelemetry.c,
+// passes the console text through to stdout and decodes the records in
+// between, checking their CRC and sequence numbers.  Once a second, and at
+// the end, it reports on stderr:
+//
+//   records and samples per second, ADC samples and control loop records
+//   counting as samples;
+//   payload and wire bytes per second, the latter also as a share of what
+//   the line can carry when the baud rate is known;
+//   records lost, from gaps in the sequence numbers, which covers both those
+//   the board dropped for lack of buffer space and those lost on the way;
+//   frames that failed their CRC or were malformed.
+//
+// Build and run, for example:
+//
+//   gcc -O2 -o telemetrydecode telemetrydecode.c
+//   ./telemetrydecode -b 921600 /dev/ttyACM0
+//
+// Options:
+//
+//   -b baud  set the serial port to this rate (and use it for the line
+//            share); without it the port is left as it is
+//   -r       print each record on stdout as well as the text
+//   -q       do not print the console text
+//
+// The input may also be a file, or - for stdin, to decode a capture.
+//
+//*****************************************************************************
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../uarttelemetry.h"
+
+//*****************************************************************************
+//
+// Options.
+//
+//*****************************************************************************
+static uint32_t g_ui32Baud;
+static bool g_bRecords;
+static bool g_bQuiet;
+
+//*****************************************************************************
+//
+// Set by Ctrl-C, to stop and give the overall figures.
+//
+//*****************************************************************************
+static volatile sig_atomic_t g_bStop;
+
+static void
+DecodeStop(int iSignal)
+{
+    (void)iSignal;
+    g_bStop = 1;
+}
+
+//*****************************************************************************
+//
+// Totals since the start, and their values at the last report.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint64_t ui64Wire;
+    uint64_t ui64Payload;
+    uint64_t ui64Records;
+    uint64_t ui64Samples;
+    uint64_t ui64Lost;
+    uint64_t ui64Bad;
+}
+tDecodeStats;
+
+static tDecodeStats g_sTotal;
+static tDecodeStats g_sLast;
+
+//*****************************************************************************
+//
+// The frame being received, and the sequence number expected next.
+//
+//*****************************************************************************
+static unsigned char g_pucFrame[UART_TELEMETRY_MAX_FRAME];
+static uint32_t g_ui32FrameLen;
+static bool g_bInFrame;
+static bool g_bFrameOverflow;
+static bool g_bHaveSeq;
+static uint16_t g_ui16NextSeq;
+
+//*****************************************************************************
+//
+// CRC-16/CCITT-FALSE.
+//
+//*****************************************************************************
+static uint16_t
+DecodeCRC(const unsigned char *pucData, uint32_t ui32Len)
+{
+    uint16_t ui16CRC = 0xFFFF;
+    uint32_t ui32Bit;
+
+    while(ui32Len--)
+    {
+        ui16CRC ^= (uint16_t)*pucData++ << 8;
+        for(ui32Bit = 0; ui32Bit < 8; ui32Bit++)
+        {
+            ui16CRC = (ui16CRC & 0x8000) ? ((ui16CRC << 1) ^ 0x1021) :
+                                            (ui16CRC << 1);
+        }
+    }
+    return(ui16CRC);
+}
+
+//*****************************************************************************
+//
+// Undo the COBS encoding of a frame, without its delimiters.  Returns the
+// length of the record, or -1 if the frame is malformed.
+//
+//*****************************************************************************
+static int
+DecodeCOBS(const unsigned char *pucIn, uint32_t ui32Len, unsigned char *pucOut)
+{
+    uint32_t ui32In, ui32Out, ui32Code, ui32Idx;
+
+    for(ui32In = 0, ui32Out = 0; ui32In < ui32Len; )
+    {
+        ui32Code = pucIn[ui32In++];
+        if((ui32In + ui32Code - 1) > ui32Len)
+        {
+            return(-1);
+        }
+        for(ui32Idx = 1; ui32Idx < ui32Code; ui32Idx++)
+        {
+            pucOut[ui32Out++] = pucIn[ui32In++];
+        }
+        if((ui32Code != 0xFF) && (ui32In < ui32Len))
+        {
+            pucOut[ui32Out++] = 0;
+        }
+    }
+    return(ui32Out);
+}
+
+//*****************************************************************************
+//
+// Little-endian fields of a record.
+//
+//*****************************************************************************
+static uint32_t
+DecodeU16(const unsigned char *pucData)
+{
+    return(pucData[0] | (pucData[1] << 8));
+}
+
+static uint32_t
+DecodeU32(const unsigned char *pucData)
+{
+    return(DecodeU16(pucData) | (DecodeU16(pucData + 2) << 16));
+}
+
+//*****************************************************************************
+//
+// Check and account for a frame.  Returns false if it is not a valid record.
+//
+//*****************************************************************************
+static bool
+DecodeFrame(const unsigned char *pucFrame, uint32_t ui32Len)
+{
+    unsigned char pucRecord[UART_TELEMETRY_MAX_FRAME];
+    const unsigned char *pucPayload;
+    uint32_t ui32Type, ui32Seq, ui32Payload, ui32Idx;
+    int iLen;
+
+    iLen = DecodeCOBS(pucFrame, ui32Len, pucRecord);
+    if((iLen < 5) ||
+       (DecodeCRC(pucRecord, iLen - 2) != DecodeU16(&pucRecord[iLen - 2])))
+    {
+        return(false);
+    }
+
+    ui32Type = pucRecord[0];
+    ui32Seq = DecodeU16(&pucRecord[1]);
+    pucPayload = &pucRecord[3];
+    ui32Payload = iLen - 5;
+
+    //
+    // Anything between the last record and this one was lost.
+    //
+    if(g_bHaveSeq)
+    {
+        g_sTotal.ui64Lost += (uint16_t)(ui32Seq - g_ui16NextSeq);
+    }
+    g_bHaveSeq = true;
+    g_ui16NextSeq = ui32Seq + 1;
+
+    g_sTotal.ui64Records++;
+    g_sTotal.ui64Payload += ui32Payload;
+
+    switch(ui32Type)
+    {
+        case UART_TELEMETRY_ADC:
+        {
+            if((ui32Payload < 4) || (ui32Payload & 1))
+            {
+                break;
+            }
+            g_sTotal.ui64Samples += (ui32Payload - 4) / 2;
+            if(g_bRecords)
+            {
+                printf("adc %u t=%u:", ui32Seq, DecodeU32(pucPayload));
+                for(ui32Idx = 4; ui32Idx < ui32Payload; ui32Idx += 2)
+                {
+                    printf(" %u", DecodeU16(&pucPayload[ui32Idx]));
+                }
+                printf("\n");
+            }
+            return(true);
+        }
+
+        case UART_TELEMETRY_LOOP:
+        {
+            if(ui32Payload != 16)
+            {
+                break;
+            }
+            g_sTotal.ui64Samples++;
+            if(g_bRecords)
+            {
+                printf("loop %u t=%u set=%d meas=%d out=%d\n", ui32Seq,
+                       DecodeU32(pucPayload),
+                       (int32_t)DecodeU32(pucPayload + 4),
+                       (int32_t)DecodeU32(pucPayload + 8),
+                       (int32_t)DecodeU32(pucPayload + 12));
+            }
+            return(true);
+        }
+
+        default:
+        {
+            if(g_bRecords)
+            {
+                printf("type 0x%02x %u: %u bytes\n", ui32Type, ui32Seq,
+                       ui32Payload);
+            }
+            return(true);
+        }
+    }
+
+    if(g_bRecords)
+    {
+        printf("type 0x%02x %u: bad length %u\n", ui32Type, ui32Seq,
+               ui32Payload);
+    }
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Print text that arrived where a frame was expected, if it looks like text.
+//
+//*****************************************************************************
+static void
+DecodeStrayText(const unsigned char *pucData, uint32_t ui32Len)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < ui32Len; ui32Idx++)
+    {
+        if((pucData[ui32Idx] < ' ') && !strchr("\r\n\t\b", pucData[ui32Idx]))
+        {
+            return;
+        }
+    }
+    if(!g_bQuiet)
+    {
+        fwrite(pucData, 1, ui32Len, stdout);
+    }
+}
+
+//*****************************************************************************
+//
+// Split the input into text and frames.  Text never contains a zero byte and
+// a frame is enclosed by two.  A decoder that starts in the middle of a frame
+// takes its closing zero for an opening one, so a zero that ends something
+// other than a valid record is treated as the start of a frame, which brings
+// it back into step at the next record.
+//
+//*****************************************************************************
+static void
+DecodeBytes(const unsigned char *pucData, uint32_t ui32Len)
+{
+    uint32_t ui32Idx, ui32Start;
+
+    g_sTotal.ui64Wire += ui32Len;
+
+    for(ui32Idx = 0, ui32Start = 0; ui32Idx < ui32Len; ui32Idx++)
+    {
+        if(!g_bInFrame)
+        {
+            if(pucData[ui32Idx] == 0)
+            {
+                if(!g_bQuiet)
+                {
+                    fwrite(pucData + ui32Start, 1, ui32Idx - ui32Start,
+                           stdout);
+                }
+                g_bInFrame = true;
+                g_ui32FrameLen = 0;
+                g_bFrameOverflow = false;
+            }
+            continue;
+        }
+
+        if(pucData[ui32Idx] != 0)
+        {
+            if(g_ui32FrameLen < sizeof(g_pucFrame))
+            {
+                g_pucFrame[g_ui32FrameLen++] = pucData[ui32Idx];
+            }
+            else
+            {
+                g_bFrameOverflow = true;
+            }
+            continue;
+        }
+
+        //
+        // A zero: the end of the frame, unless there was nothing before it.
+        //
+        if(!g_ui32FrameLen)
+        {
+            continue;
+        }
+        if(!g_bFrameOverflow && DecodeFrame(g_pucFrame, g_ui32FrameLen))
+        {
+            g_bInFrame = false;
+            ui32Start = ui32Idx + 1;
+        }
+        else
+        {
+            g_sTotal.ui64Bad++;
+            if(!g_bFrameOverflow)
+            {
+                DecodeStrayText(g_pucFrame, g_ui32FrameLen);
+            }
+        }
+        g_ui32FrameLen = 0;
+        g_bFrameOverflow = false;
+    }
+
+    if(!g_bInFrame && !g_bQuiet)
+    {
+        fwrite(pucData + ui32Start, 1, ui32Len - ui32Start, stdout);
+    }
+    fflush(stdout);
+}
+
+//*****************************************************************************
+//
+// Report the rates since the last report, over dSeconds, and the totals.
+//
+//*****************************************************************************
+static void
+DecodeReport(double dSeconds)
+{
+    double dWire;
+
+    dWire = (g_sTotal.ui64Wire - g_sLast.ui64Wire) / dSeconds;
+    fprintf(stderr, "%.0f records/s, %.0f samples/s, payload %.0f B/s, "
+            "wire %.0f B/s",
+            (g_sTotal.ui64Records - g_sLast.ui64Records) / dSeconds,
+            (g_sTotal.ui64Samples - g_sLast.ui64Samples) / dSeconds,
+            (g_sTotal.ui64Payload - g_sLast.ui64Payload) / dSeconds, dWire);
+    if(g_ui32Baud)
+    {
+        fprintf(stderr, " (%.0f%% of line)", dWire * 1000.0 / g_ui32Baud);
+    }
+    fprintf(stderr, "; total %llu records, %llu lost, %llu bad\n",
+            (unsigned long long)g_sTotal.ui64Records,
+            (unsigned long long)g_sTotal.ui64Lost,
+            (unsigned long long)g_sTotal.ui64Bad);
+    g_sLast = g_sTotal;
+}
+
+//*****************************************************************************
+//
+// Put a serial port into raw mode at the given rate.
+//
+//*****************************************************************************
+static int
+DecodePortSetup(int iFd, uint32_t ui32Baud)
+{
+    static const struct
+    {
+        uint32_t ui32Baud;
+        speed_t tSpeed;
+    }
+    psSpeeds[] =
+    {
+        { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 },
+        { 57600, B57600 }, { 115200, B115200 }, { 230400, B230400 },
+        { 460800, B460800 }, { 921600, B921600 },
+    };
+    struct termios sTerm;
+    uint32_t ui32Idx;
+
+    if(tcgetattr(iFd, &sTerm))
+    {
+        return(-1);
+    }
+    cfmakeraw(&sTerm);
+    sTerm.c_cc[VMIN] = 1;
+    sTerm.c_cc[VTIME] = 0;
+
+    if(ui32Baud)
+    {
+        for(ui32Idx = 0; ui32Idx < (sizeof(psSpeeds) / sizeof(psSpeeds[0]));
+            ui32Idx++)
+        {
+            if(psSpeeds[ui32Idx].ui32Baud == ui32Baud)
+            {
+                break;
+            }
+        }
+        if(ui32Idx == (sizeof(psSpeeds) / sizeof(psSpeeds[0])))
+        {
+            errno = EINVAL;
+            return(-1);
+        }
+        cfsetispeed(&sTerm, psSpeeds[ui32Idx].tSpeed);
+        cfsetospeed(&sTerm, psSpeeds[ui32Idx].tSpeed);
+    }
+
+    return(tcsetattr(iFd, TCSANOW, &sTerm));
+}
+
+static double
+DecodeNow(void)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+    return(sTime.tv_sec + (sTime.tv_nsec / 1e9));
+}
+
+int
+main(int argc, char *argv[])
+{
+    unsigned char pucBuf[4096];
+    const char *pcInput;
+    struct pollfd sPoll;
+    double dStart, dLast, dNow;
+    ssize_t iRead;
+    int iOpt, iFd;
+
+    while((iOpt = getopt(argc, argv, "b:rq")) != -1)
+    {
+        switch(iOpt)
+        {
+            case 'b':
+                g_ui32Baud = strtoul(optarg, 0, 0);
+                break;
+            case 'r':
+                g_bRecords = true;
+                break;
+            case 'q':
+                g_bQuiet = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-b baud] [-r] [-q] "
+                        "[device | file | -]\n", argv[0]);
+                return(2);
+        }
+    }
+    pcInput = (optind < argc) ? argv[optind] : "-";
+
+    if(!strcmp(pcInput, "-"))
+    {
+        iFd = STDIN_FILENO;
+    }
+    else if((iFd = open(pcInput, O_RDONLY | O_NOCTTY)) < 0)
+    {
+        perror(pcInput);
+        return(1);
+    }
+    if(isatty(iFd) && DecodePortSetup(iFd, g_ui32Baud))
+    {
+        perror(pcInput);
+        return(1);
+    }
+
+    //
+    // Decode until the input ends or Ctrl-C, reporting once a second
+    // meanwhile.
+    //
+    signal(SIGINT, DecodeStop);
+    dStart = dLast = DecodeNow();
+    sPoll.fd = iFd;
+    sPoll.events = POLLIN;
+    while(!g_bStop)
+    {
+        if(poll(&sPoll, 1, 100) > 0)
+        {
+            iRead = read(iFd, pucBuf, sizeof(pucBuf));
+            if(iRead <= 0)
+            {
+                break;
+            }
+            DecodeBytes(pucBuf, iRead);
+        }
+
+        dNow = DecodeNow();
+        if((dNow - dLast) >= 1.0)
+        {
+            DecodeReport(dNow - dLast);
+            dLast = dNow;
+        }
+    }
+
+    //
+    // Overall figures.
+    //
+    memset(&g_sLast, 0, sizeof(g_sLast));
+    DecodeReport(DecodeNow() - dStart);
+
+    return(0);
+}
@@ -0,0 +1,216 @@
+//*****************************************************************************
+//
+// uartbench.c - Host benchmark for the buffered uartstdio ring buffers.
+//
+// Builds ../uartstdio.c for UART_BUFFERED operation on a PC, with the few
+// driverlib calls it makes replaced by a model UART, and times the two paths
+// that move data through the ring buffers:
+//
+//   UARTwrite()  console lines into the transmit buffer, with the UART
+//                transmit FIFO held full so that nothing drains meanwhile;
+//   UARTgets()   lines out of a receive buffer that the interrupt handler
+//                has filled, echo off.
+//
+// Only the time spent inside those calls is counted, and the result is given
+// in bytes per cycle of the host's time stamp counter (bytes per nanosecond
+// where there is none).  Run it against two revisions of uartstdio.c to
+// compare them; the absolute figures say little about a Cortex-M4.
+//
+// Build from this directory against the TivaWare headers, for example:
+//
+//   gcc -O2 -I$TIVAWARE -o uartbench uartbench.c && ./uartbench
+//
+// UART_TX_BUFFER_SIZE and UART_RX_BUFFER_SIZE may be given with -D.
+//
+//*****************************************************************************
+
+#define UART_BUFFERED
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE     1024
+#endif
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE     1024
+#endif
+
+#include "../uartstdio.c"
+
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT              "cycle"
+#define BenchNow()              __rdtsc()
+#else
+#define BENCH_UNIT              "ns"
+static uint64_t
+BenchNow(void)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+    return((uint64_t)sTime.tv_sec * 1000000000u + sTime.tv_nsec);
+}
+#endif
+
+//*****************************************************************************
+//
+// The model UART.  The transmit FIFO never has space, so UARTwrite() only
+// fills the buffer; the receive side hands out the bytes of
+// g_pcBenchRx[g_ui32BenchRxPos..g_ui32BenchRxEnd) and reports a receive
+// interrupt while there are any.
+//
+//*****************************************************************************
+static const char *g_pcBenchRx;
+static uint32_t g_ui32BenchRxPos;
+static uint32_t g_ui32BenchRxEnd;
+
+bool SysCtlPeripheralPresent(uint32_t ui32Peripheral) { return(true); }
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral) { }
+void UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk,
+                         uint32_t ui32Baud, uint32_t ui32Config) { }
+void UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel,
+                      uint32_t ui32RxLevel) { }
+void UARTEnable(uint32_t ui32Base) { }
+void UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags) { }
+void UARTIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags) { }
+void UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags) { }
+void UARTRxErrorClear(uint32_t ui32Base) { }
+void IntEnable(uint32_t ui32Interrupt) { }
+void IntDisable(uint32_t ui32Interrupt) { }
+void IntPendSet(uint32_t ui32Interrupt) { }
+bool IntMasterEnable(void) { return(false); }
+bool IntMasterDisable(void) { return(false); }
+bool UARTSpaceAvail(uint32_t ui32Base) { return(false); }
+bool UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+    return(false);
+}
+void UARTCharPut(uint32_t ui32Base, unsigned char ucData) { }
+
+uint32_t
+UARTIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    return((g_ui32BenchRxPos < g_ui32BenchRxEnd) ? UART_INT_RX : 0);
+}
+
+bool
+UARTCharsAvail(uint32_t ui32Base)
+{
+    return(g_ui32BenchRxPos < g_ui32BenchRxEnd);
+}
+
+int32_t
+UARTCharGetNonBlocking(uint32_t ui32Base)
+{
+    return((g_ui32BenchRxPos < g_ui32BenchRxEnd) ?
+           (unsigned char)g_pcBenchRx[g_ui32BenchRxPos++] : -1);
+}
+
+int32_t
+UARTCharGet(uint32_t ui32Base)
+{
+    return(UARTCharGetNonBlocking(ui32Base));
+}
+
+//*****************************************************************************
+//
+// Typical console traffic: short status lines, each ending in a newline.
+//
+//*****************************************************************************
+static const char * const g_ppcBenchLines[] =
+{
+    "ADC0 ch0=1234 ch1=0567 ch2=4095\n",
+    "T=25.3C duty=50% rpm=1500 state=RUN\n",
+    "ok\n",
+    "uart: 115200 8N1, rx 1024 tx 1024, echo off, lines buffered\n",
+};
+#define BENCH_NUM_LINES (sizeof(g_ppcBenchLines) / sizeof(g_ppcBenchLines[0]))
+
+#define BENCH_ROUNDS            200000
+
+int
+main(void)
+{
+    static char pcRx[UART_RX_BUFFER_SIZE];
+    char pcLine[UART_RX_BUFFER_SIZE];
+    uint64_t ui64Start, ui64Write, ui64Gets;
+    uint64_t ui64WriteBytes, ui64GetsBytes;
+    uint32_t ui32Round, ui32Idx, ui32Len, ui32Fill, ui32Lines;
+
+    UARTStdioConfig(0, 115200, 80000000);
+    UARTEchoSet(false);
+
+    //
+    // UARTwrite(): as many lines as fit in the transmit buffer, each \n
+    // taking two bytes there, written back to back and then discarded.
+    //
+    for(ui32Fill = 0, ui32Lines = 0; ; ui32Lines++)
+    {
+        ui32Len = strlen(g_ppcBenchLines[ui32Lines % BENCH_NUM_LINES]) + 1;
+        if(ui32Fill + ui32Len >= UART_TX_BUFFER_SIZE)
+        {
+            break;
+        }
+        ui32Fill += ui32Len;
+    }
+
+    ui64Write = 0;
+    ui64WriteBytes = 0;
+    for(ui32Round = 0; ui32Round < BENCH_ROUNDS; ui32Round++)
+    {
+        ui64Start = BenchNow();
+        for(ui32Idx = 0; ui32Idx < ui32Lines; ui32Idx++)
+        {
+            ui64WriteBytes += UARTwrite(g_ppcBenchLines[ui32Idx %
+                                                        BENCH_NUM_LINES],
+                                        UART_TX_BUFFER_SIZE);
+        }
+        ui64Write += BenchNow() - ui64Start;
+        UARTFlushTx(true);
+    }
+
+    //
+    // UARTgets(): a buffer's worth of lines, ended by \r, received through
+    // the interrupt handler and then read back.
+    //
+    for(ui32Fill = 0, ui32Lines = 0; ; ui32Lines++)
+    {
+        const char *pcText = g_ppcBenchLines[ui32Lines % BENCH_NUM_LINES];
+
+        ui32Len = strlen(pcText);
+        if(ui32Fill + ui32Len >= UART_RX_BUFFER_SIZE)
+        {
+            break;
+        }
+        memcpy(&pcRx[ui32Fill], pcText, ui32Len - 1);
+        pcRx[ui32Fill + ui32Len - 1] = '\r';
+        ui32Fill += ui32Len;
+    }
+    g_pcBenchRx = pcRx;
+
+    ui64Gets = 0;
+    ui64GetsBytes = 0;
+    for(ui32Round = 0; ui32Round < BENCH_ROUNDS; ui32Round++)
+    {
+        g_ui32BenchRxPos = 0;
+        g_ui32BenchRxEnd = ui32Fill;
+        UARTStdioIntHandler();
+
+        ui64Start = BenchNow();
+        for(ui32Idx = 0; ui32Idx < ui32Lines; ui32Idx++)
+        {
+            ui64GetsBytes += UARTgets(pcLine, sizeof(pcLine)) + 1;
+        }
+        ui64Gets += BenchNow() - ui64Start;
+    }
+
+    printf("UARTwrite: %llu bytes, %.3f bytes/" BENCH_UNIT "\n",
+           (unsigned long long)ui64WriteBytes,
+           (double)ui64WriteBytes / (double)ui64Write);
+    printf("UARTgets:  %llu bytes, %.3f bytes/" BENCH_UNIT "\n",
+           (unsigned long long)ui64GetsBytes,
+           (double)ui64GetsBytes / (double)ui64Gets);
+
+    return(0);
+}
@@ -0,0 +1,872 @@
+//*****************************************************************************
+//
+// uartdmasim.c - Host model of the UART and uDMA for the buffered uartstdio.
+//
+// Builds ../uartstdio.c for UART_BUFFERED operation on a PC against a model
+// of the parts of a TM4C123 it drives: one UART with its 16 byte FIFOs, the
+// uDMA channels and control structures of its transmitter and receiver, and
+// the NVIC line they share.  Time advances one character at a time at the
+// chosen baud rate.  Each step the UART sends a byte from its transmit FIFO
+// and may receive one, the uDMA serves whatever requests the FIFO levels
+// raise, any interrupt that is pending and enabled is taken, and then the
+// application gets a turn.
+//
+// The model follows the data sheet where the driver depends on it:
+//
+//   - the transmit and receive interrupts fire as the FIFO level passes the
+//     trigger set with UARTFIFOLevelSet(), and the receive timeout once the
+//     line has been idle for 32 bits with data left in the FIFO;
+//   - the UART asks the uDMA for a single transfer while the transmit FIFO
+//     has room or the receive FIFO holds data, and for a burst while the
+//     level is past the trigger; UDMA_ATTR_USEBURST ignores single requests,
+//     and a burst moves the arbitration size set with uDMAChannelControlSet();
+//   - a control structure stops when its count runs out; in ping-pong mode
+//     the channel goes on with the other structure if that is armed, and
+//     otherwise it disables itself;
+//   - completion raises the UART's own interrupt, with no status bit in the
+//     UART, as on this device.
+//
+// Three workloads run in turn for the given time each:
+//
+//   tx    heavy logging: lines of random text, newlines included, written
+//         through UARTwrite() as fast as the transmit buffer takes them;
+//   rx    messages of random bytes with idle gaps between them, read
+//         through UARTRxSpan()/UARTRxConsume();
+//   both  the two at once.
+//
+// For each the bytes per second in each direction and the interrupts per
+// second are reported, and the bytes on the wire and the bytes read must
+// match what was written and sent.  Interrupts are taken between the
+// application's calls, not in the middle of them; uartstress checks that for
+// the ring buffers.
+//
+// Build from this directory against the TivaWare headers with the transfer
+// paths to model, for example:
+//
+//   gcc -O2 -I$TIVAWARE -DUART_DMA -o uartdmasim uartdmasim.c && ./uartdmasim
+//
+// UART_DMA, UART_RX_DMA, both or neither may be given; with neither, the
+// figures are those of the interrupt-driven ring buffers, for comparison.
+// Optional arguments give the baud rate (default 921600) and the seconds of
+// line time for each workload (default 1).  UART_TX_BUFFER_SIZE and
+// UART_RX_BUFFER_SIZE may be given with -D.
+//
+//*****************************************************************************
+
+#define UART_BUFFERED
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE     1024
+#endif
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE     1024
+#endif
+
+#include "../uartstdio.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+//*****************************************************************************
+//
+// A small random number generator, one per stream so that each end of a
+// stream can generate it independently.
+//
+//*****************************************************************************
+static uint32_t
+SimRand(uint32_t *pui32State)
+{
+    uint32_t ui32X = *pui32State;
+
+    ui32X ^= ui32X << 13;
+    ui32X ^= ui32X >> 17;
+    ui32X ^= ui32X << 5;
+    *pui32State = ui32X;
+    return(ui32X);
+}
+
+//*****************************************************************************
+//
+// The model UART.  The FIFO trigger levels are in characters: the transmit
+// interrupt fires as the transmit FIFO falls to g_ui32SimTxTrigger, the
+// receive interrupt as the receive FIFO rises to g_ui32SimRxTrigger.
+//
+//*****************************************************************************
+#define SIM_FIFO_SIZE           16
+#define SIM_TIMEOUT_STEPS       4
+
+static unsigned char g_pucSimTxFIFO[SIM_FIFO_SIZE];
+static uint32_t g_ui32SimTxHead;
+static uint32_t g_ui32SimTxLevel;
+static unsigned char g_pucSimRxFIFO[SIM_FIFO_SIZE];
+static uint32_t g_ui32SimRxHead;
+static uint32_t g_ui32SimRxLevel;
+static uint32_t g_ui32SimTxTrigger = 8;
+static uint32_t g_ui32SimRxTrigger = 8;
+static uint32_t g_ui32SimIdle;
+static uint32_t g_ui32SimIntStatus;
+static uint32_t g_ui32SimIntEnable;
+static uint32_t g_ui32SimDMAEnable;
+
+//
+// The trigger levels selected by the UART_FIFO_TX and UART_FIFO_RX values,
+// 1/8 to 7/8 of the FIFO.
+//
+static const uint32_t g_pui32SimTrigger[5] = { 2, 4, 8, 12, 14 };
+
+//*****************************************************************************
+//
+// The model uDMA.  Each channel has a primary and an alternate control
+// structure; UDMA_ATTR_ALTSELECT in the attributes says which is in use.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Mode;
+    const unsigned char *pucSrc;
+    unsigned char *pucDst;
+    uint32_t ui32Count;
+}
+tSimControl;
+
+typedef struct
+{
+    bool bEnabled;
+    uint32_t ui32Attr;
+    uint32_t ui32Arb;
+    tSimControl psControl[2];
+}
+tSimChannel;
+
+static tSimChannel g_psSimChannel[32];
+static void *g_pvSimControlBase;
+
+//
+// The channels of UART0, which the model is configured as.
+//
+#define SIM_RX_CHANNEL          (UDMA_CH8_UART0RX & 0x1F)
+#define SIM_TX_CHANNEL          (UDMA_CH9_UART0TX & 0x1F)
+
+//
+// Programming errors the model catches: a control structure changed while
+// the uDMA is using it, or a transfer the controller cannot do.
+//
+static uint32_t g_ui32SimErrors;
+
+//*****************************************************************************
+//
+// The model NVIC line of the UART: enabled, masked by IntMasterDisable(),
+// pending, and whether its handler is running.  Handler runs are counted.
+//
+//*****************************************************************************
+static bool g_bSimIntEnabled;
+static bool g_bSimMasked;
+static bool g_bSimPending;
+static bool g_bSimInHandler;
+static uint32_t g_ui32SimInts;
+
+//*****************************************************************************
+//
+// The wire and the receive stream.  g_pucSimWire holds what has left the
+// transmitter.  The receive stream is messages of 1 to 256 random bytes with
+// gaps of up to 16 character times between them; the bytes come from their
+// own generator, which the reader runs too.
+//
+//*****************************************************************************
+static unsigned char *g_pucSimWire;
+static uint32_t g_ui32SimWireSize;
+static uint32_t g_ui32SimWireCount;
+static uint32_t g_ui32SimRxSeed = 0x2545F491;
+static uint32_t g_ui32SimRxDataSeed = 0x9E3779B9;
+static uint32_t g_ui32SimRxSent;
+static uint32_t g_ui32SimRxLeft;
+static uint32_t g_ui32SimRxGap;
+
+static void SimDMA(void);
+static void SimInterrupt(void);
+
+//*****************************************************************************
+//
+// The driverlib calls that uartstdio.c makes.
+//
+//*****************************************************************************
+bool SysCtlPeripheralPresent(uint32_t ui32Peripheral) { return(true); }
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral) { }
+void UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk,
+                         uint32_t ui32Baud, uint32_t ui32Config) { }
+void UARTEnable(uint32_t ui32Base) { }
+void UARTRxErrorClear(uint32_t ui32Base) { }
+void uDMAEnable(void) { }
+void uDMAChannelAssign(uint32_t ui32Mapping) { }
+
+void
+UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel,
+                 uint32_t ui32RxLevel)
+{
+    g_ui32SimTxTrigger = g_pui32SimTrigger[ui32TxLevel & 7];
+    g_ui32SimRxTrigger = g_pui32SimTrigger[ui32RxLevel >> 3];
+}
+
+void
+UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_ui32SimIntEnable |= ui32IntFlags;
+}
+
+void
+UARTIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_ui32SimIntEnable &= ~ui32IntFlags;
+}
+
+uint32_t
+UARTIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    return(g_ui32SimIntStatus & (bMasked ? g_ui32SimIntEnable : 0xFFFFFFFF));
+}
+
+void
+UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_ui32SimIntStatus &= ~ui32IntFlags;
+    if(ui32IntFlags & UART_INT_RT)
+    {
+        g_ui32SimIdle = 0;
+    }
+}
+
+void
+UARTDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    g_ui32SimDMAEnable |= ui32DMAFlags;
+}
+
+bool
+UARTSpaceAvail(uint32_t ui32Base)
+{
+    return(g_ui32SimTxLevel < SIM_FIFO_SIZE);
+}
+
+bool
+UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+    if(g_ui32SimTxLevel == SIM_FIFO_SIZE)
+    {
+        return(false);
+    }
+    g_pucSimTxFIFO[(g_ui32SimTxHead + g_ui32SimTxLevel++) % SIM_FIFO_SIZE] =
+        ucData;
+    return(true);
+}
+
+void
+UARTCharPut(uint32_t ui32Base, unsigned char ucData)
+{
+    UARTCharPutNonBlocking(ui32Base, ucData);
+}
+
+//
+// The uDMA runs alongside the CPU, so a handler polling the receive FIFO
+// sees it being emptied.  One that would wait forever fails the run.
+//
+bool
+UARTCharsAvail(uint32_t ui32Base)
+{
+    static uint32_t ui32Polls;
+
+    SimDMA();
+    if(!g_ui32SimRxLevel)
+    {
+        ui32Polls = 0;
+        return(false);
+    }
+    if(++ui32Polls == 1000000)
+    {
+        printf("FAIL: the receive FIFO never empties, %u bytes left\n",
+               g_ui32SimRxLevel);
+        exit(1);
+    }
+    return(true);
+}
+
+int32_t
+UARTCharGetNonBlocking(uint32_t ui32Base)
+{
+    unsigned char ucData;
+
+    if(!g_ui32SimRxLevel)
+    {
+        return(-1);
+    }
+    ucData = g_pucSimRxFIFO[g_ui32SimRxHead];
+    g_ui32SimRxHead = (g_ui32SimRxHead + 1) % SIM_FIFO_SIZE;
+    g_ui32SimRxLevel--;
+    return(ucData);
+}
+
+int32_t
+UARTCharGet(uint32_t ui32Base)
+{
+    return(UARTCharGetNonBlocking(ui32Base));
+}
+
+void
+IntEnable(uint32_t ui32Interrupt)
+{
+    g_bSimIntEnabled = true;
+    SimInterrupt();
+}
+
+void
+IntDisable(uint32_t ui32Interrupt)
+{
+    g_bSimIntEnabled = false;
+}
+
+void
+IntPendSet(uint32_t ui32Interrupt)
+{
+    g_bSimPending = true;
+    SimInterrupt();
+}
+
+bool
+IntMasterDisable(void)
+{
+    bool bWas = g_bSimMasked;
+
+    g_bSimMasked = true;
+    return(bWas);
+}
+
+bool
+IntMasterEnable(void)
+{
+    bool bWas = g_bSimMasked;
+
+    g_bSimMasked = false;
+    SimInterrupt();
+    return(bWas);
+}
+
+void *
+uDMAControlBaseGet(void)
+{
+    return(g_pvSimControlBase);
+}
+
+void
+uDMAControlBaseSet(void *pvControlTable)
+{
+    if((uintptr_t)pvControlTable & 1023)
+    {
+        g_ui32SimErrors++;
+    }
+    g_pvSimControlBase = pvControlTable;
+}
+
+void
+uDMAChannelAttributeEnable(uint32_t ui32Channel, uint32_t ui32Attr)
+{
+    g_psSimChannel[ui32Channel & 0x1F].ui32Attr |= ui32Attr;
+}
+
+void
+uDMAChannelAttributeDisable(uint32_t ui32Channel, uint32_t ui32Attr)
+{
+    g_psSimChannel[ui32Channel & 0x1F].ui32Attr &= ~ui32Attr;
+}
+
+uint32_t
+uDMAChannelAttributeGet(uint32_t ui32Channel)
+{
+    return(g_psSimChannel[ui32Channel & 0x1F].ui32Attr);
+}
+
+void
+uDMAChannelControlSet(uint32_t ui32Channel, uint32_t ui32Control)
+{
+    g_psSimChannel[ui32Channel & 0x1F].ui32Arb = 1 << ((ui32Control >> 14) &
+                                                       0xF);
+}
+
+//
+// Only moves between memory and the UART data register are modelled; the
+// register is recognized by its address.
+//
+void
+uDMAChannelTransferSet(uint32_t ui32Channel, uint32_t ui32Mode,
+                       void *pvSrcAddr, void *pvDstAddr,
+                       uint32_t ui32TransferSize)
+{
+    tSimChannel *psChannel = &g_psSimChannel[ui32Channel & 0x1F];
+    tSimControl *psControl;
+    uint32_t ui32Select;
+
+    ui32Select = (ui32Channel & UDMA_ALT_SELECT) ? 1 : 0;
+    psControl = &psChannel->psControl[ui32Select];
+    if((psChannel->bEnabled && (psControl->ui32Mode != UDMA_MODE_STOP) &&
+        (((psChannel->ui32Attr & UDMA_ATTR_ALTSELECT) ? 1 : 0) ==
+         ui32Select)) ||
+       !ui32TransferSize || (ui32TransferSize > 1024))
+    {
+        g_ui32SimErrors++;
+    }
+
+    psControl->ui32Mode = ui32Mode;
+    psControl->ui32Count = ui32TransferSize;
+    psControl->pucSrc = ((uintptr_t)pvSrcAddr == (UART0_BASE + UART_O_DR)) ?
+                        0 : pvSrcAddr;
+    psControl->pucDst = ((uintptr_t)pvDstAddr == (UART0_BASE + UART_O_DR)) ?
+                        0 : pvDstAddr;
+}
+
+void
+uDMAChannelEnable(uint32_t ui32Channel)
+{
+    g_psSimChannel[ui32Channel & 0x1F].bEnabled = true;
+    SimDMA();
+}
+
+void
+uDMAChannelDisable(uint32_t ui32Channel)
+{
+    g_psSimChannel[ui32Channel & 0x1F].bEnabled = false;
+}
+
+uint32_t
+uDMAChannelModeGet(uint32_t ui32Channel)
+{
+    return(g_psSimChannel[ui32Channel & 0x1F].psControl[
+               (ui32Channel & UDMA_ALT_SELECT) ? 1 : 0].ui32Mode);
+}
+
+uint32_t
+uDMAChannelSizeGet(uint32_t ui32Channel)
+{
+    tSimControl *psControl;
+
+    psControl = &g_psSimChannel[ui32Channel & 0x1F].psControl[
+                    (ui32Channel & UDMA_ALT_SELECT) ? 1 : 0];
+    return((psControl->ui32Mode == UDMA_MODE_STOP) ? 0 :
+           psControl->ui32Count);
+}
+
+//*****************************************************************************
+//
+// Move up to ui32Items bytes on a channel, between its active control
+// structure and the UART FIFOs, then retire the structure if its count has
+// run out.  Returns false if the channel has nothing to do.
+//
+//*****************************************************************************
+static bool
+SimDMAMove(tSimChannel *psChannel, uint32_t ui32Items)
+{
+    tSimControl *psControl;
+    uint32_t ui32Select, ui32Mode;
+
+    ui32Select = (psChannel->ui32Attr & UDMA_ATTR_ALTSELECT) ? 1 : 0;
+    psControl = &psChannel->psControl[ui32Select];
+    if(!psChannel->bEnabled || (psControl->ui32Mode == UDMA_MODE_STOP))
+    {
+        return(false);
+    }
+
+    while(ui32Items-- && psControl->ui32Count)
+    {
+        if(psControl->pucSrc)
+        {
+            UARTCharPutNonBlocking(UART0_BASE, *psControl->pucSrc++);
+        }
+        else
+        {
+            *psControl->pucDst++ = UARTCharGetNonBlocking(UART0_BASE);
+        }
+        psControl->ui32Count--;
+    }
+
+    //
+    // At the end of a transfer the structure stops and the UART interrupt is
+    // raised.  A ping-pong transfer carries on with the other structure if
+    // it has been set up; otherwise the channel is done.
+    //
+    if(!psControl->ui32Count)
+    {
+        ui32Mode = psControl->ui32Mode;
+        psControl->ui32Mode = UDMA_MODE_STOP;
+        g_bSimPending = true;
+        if((ui32Mode == UDMA_MODE_PINGPONG) &&
+           (psChannel->psControl[ui32Select ^ 1].ui32Mode ==
+            UDMA_MODE_PINGPONG))
+        {
+            psChannel->ui32Attr ^= UDMA_ATTR_ALTSELECT;
+        }
+        else
+        {
+            psChannel->bEnabled = false;
+        }
+    }
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Serve the UART's uDMA requests until there are none.  A burst request moves
+// the channel's arbitration size, a single request one byte; channels with
+// UDMA_ATTR_USEBURST set do not see single requests, and those with
+// UDMA_ATTR_REQMASK set see none.
+//
+//*****************************************************************************
+static void
+SimDMA(void)
+{
+    tSimChannel *psChannel;
+    uint32_t ui32Items;
+
+    for(;;)
+    {
+        ui32Items = 0;
+        psChannel = &g_psSimChannel[SIM_TX_CHANNEL];
+        if((g_ui32SimDMAEnable & UART_DMA_TX) &&
+           !(psChannel->ui32Attr & UDMA_ATTR_REQMASK))
+        {
+            if((g_ui32SimTxLevel <= g_ui32SimTxTrigger) &&
+               (g_ui32SimTxLevel <= (SIM_FIFO_SIZE - psChannel->ui32Arb)))
+            {
+                ui32Items = psChannel->ui32Arb;
+            }
+            else if((g_ui32SimTxLevel < SIM_FIFO_SIZE) &&
+                    !(psChannel->ui32Attr & UDMA_ATTR_USEBURST))
+            {
+                ui32Items = 1;
+            }
+        }
+        if(ui32Items && SimDMAMove(psChannel, ui32Items))
+        {
+            continue;
+        }
+
+        ui32Items = 0;
+        psChannel = &g_psSimChannel[SIM_RX_CHANNEL];
+        if((g_ui32SimDMAEnable & UART_DMA_RX) &&
+           !(psChannel->ui32Attr & UDMA_ATTR_REQMASK))
+        {
+            if(g_ui32SimRxLevel >= g_ui32SimRxTrigger)
+            {
+                ui32Items = psChannel->ui32Arb;
+            }
+            else if(g_ui32SimRxLevel &&
+                    !(psChannel->ui32Attr & UDMA_ATTR_USEBURST))
+            {
+                ui32Items = 1;
+            }
+            if(ui32Items > g_ui32SimRxLevel)
+            {
+                ui32Items = g_ui32SimRxLevel;
+            }
+        }
+        if(ui32Items && SimDMAMove(psChannel, ui32Items))
+        {
+            continue;
+        }
+
+        break;
+    }
+}
+
+//*****************************************************************************
+//
+// Take the UART interrupt for as long as it is pending or asserted, unless it
+// is disabled or masked, or its handler is already running.
+//
+//*****************************************************************************
+static void
+SimInterrupt(void)
+{
+    while(g_bSimIntEnabled && !g_bSimMasked && !g_bSimInHandler &&
+          (g_bSimPending || (g_ui32SimIntStatus & g_ui32SimIntEnable)))
+    {
+        g_bSimPending = false;
+        g_bSimInHandler = true;
+        g_ui32SimInts++;
+        UARTStdioIntHandler();
+        g_bSimInHandler = false;
+        SimDMA();
+    }
+}
+
+//*****************************************************************************
+//
+// The next byte of the receive stream, or -1 for an idle character time.
+//
+//*****************************************************************************
+static int32_t
+SimRxNext(void)
+{
+    if(!g_ui32SimRxLeft)
+    {
+        if(g_ui32SimRxGap)
+        {
+            g_ui32SimRxGap--;
+            return(-1);
+        }
+        g_ui32SimRxLeft = 1 + (SimRand(&g_ui32SimRxSeed) % 256);
+        g_ui32SimRxGap = SimRand(&g_ui32SimRxSeed) % 17;
+    }
+    g_ui32SimRxLeft--;
+    g_ui32SimRxSent++;
+    return(SimRand(&g_ui32SimRxDataSeed) & 0xFF);
+}
+
+//*****************************************************************************
+//
+// One character time: the transmitter sends a byte, the receiver takes
+// i32Rx unless it is negative, the uDMA serves the FIFOs and the interrupt is
+// taken if due.
+//
+//*****************************************************************************
+static void
+SimStep(int32_t i32Rx)
+{
+    if(g_ui32SimTxLevel)
+    {
+        if(g_ui32SimWireCount < g_ui32SimWireSize)
+        {
+            g_pucSimWire[g_ui32SimWireCount] = g_pucSimTxFIFO[g_ui32SimTxHead];
+        }
+        g_ui32SimWireCount++;
+        g_ui32SimTxHead = (g_ui32SimTxHead + 1) % SIM_FIFO_SIZE;
+        if(--g_ui32SimTxLevel == g_ui32SimTxTrigger)
+        {
+            g_ui32SimIntStatus |= UART_INT_TX;
+        }
+    }
+
+    if(i32Rx >= 0)
+    {
+        g_ui32SimIdle = 0;
+        if(g_ui32SimRxLevel == SIM_FIFO_SIZE)
+        {
+            g_ui32SimIntStatus |= UART_INT_OE;
+        }
+        else
+        {
+            g_pucSimRxFIFO[(g_ui32SimRxHead + g_ui32SimRxLevel) %
+                           SIM_FIFO_SIZE] = (unsigned char)i32Rx;
+            if(++g_ui32SimRxLevel == g_ui32SimRxTrigger)
+            {
+                g_ui32SimIntStatus |= UART_INT_RX;
+            }
+        }
+    }
+
+    SimDMA();
+
+    if((i32Rx < 0) && g_ui32SimRxLevel &&
+       (++g_ui32SimIdle == SIM_TIMEOUT_STEPS))
+    {
+        g_ui32SimIntStatus |= UART_INT_RT;
+    }
+
+    SimInterrupt();
+}
+
+//*****************************************************************************
+//
+// The application's side of the tx workload: the log it writes, the line
+// being written and how much of it UARTwrite() has taken, and what should
+// appear on the wire, \n becoming \r\n.
+//
+//*****************************************************************************
+static uint32_t g_ui32SimTxSeed = 0x12345678;
+static char g_pcSimLine[128];
+static uint32_t g_ui32SimLineLen;
+static uint32_t g_ui32SimLinePos;
+static unsigned char *g_pucSimExpect;
+static uint32_t g_ui32SimExpect;
+
+//
+// The application's side of the rx workload: the generator that checks the
+// bytes read, how many were read, and how many differed.
+//
+static uint32_t g_ui32SimReadSeed = 0x9E3779B9;
+static uint32_t g_ui32SimRead;
+static uint32_t g_ui32SimBad;
+
+//*****************************************************************************
+//
+// Write as much of the log as the transmit buffer takes: lines of up to 100
+// printable characters, each ended by a newline.
+//
+//*****************************************************************************
+static void
+SimWrite(void)
+{
+    uint32_t ui32Idx;
+    int iCount;
+
+    while((g_ui32SimExpect + (2 * sizeof(g_pcSimLine))) < g_ui32SimWireSize)
+    {
+        if(g_ui32SimLinePos == g_ui32SimLineLen)
+        {
+            g_ui32SimLineLen = SimRand(&g_ui32SimTxSeed) % 101;
+            for(ui32Idx = 0; ui32Idx < g_ui32SimLineLen; ui32Idx++)
+            {
+                g_pcSimLine[ui32Idx] = ' ' + (SimRand(&g_ui32SimTxSeed) % 95);
+            }
+            g_pcSimLine[g_ui32SimLineLen++] = '\n';
+            g_ui32SimLinePos = 0;
+        }
+
+        iCount = UARTwrite(g_pcSimLine + g_ui32SimLinePos,
+                           g_ui32SimLineLen - g_ui32SimLinePos);
+        for(ui32Idx = g_ui32SimLinePos;
+            ui32Idx < (g_ui32SimLinePos + iCount); ui32Idx++)
+        {
+            if(g_pcSimLine[ui32Idx] == '\n')
+            {
+                g_pucSimExpect[g_ui32SimExpect++] = '\r';
+            }
+            g_pucSimExpect[g_ui32SimExpect++] = g_pcSimLine[ui32Idx];
+        }
+        g_ui32SimLinePos += iCount;
+        if(g_ui32SimLinePos < g_ui32SimLineLen)
+        {
+            break;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Read and check whatever has been received.
+//
+//*****************************************************************************
+static void
+SimReadAll(void)
+{
+    const unsigned char *pucData;
+    uint32_t ui32Avail, ui32Idx;
+
+    while((ui32Avail = UARTRxSpan(&pucData)) != 0)
+    {
+        for(ui32Idx = 0; ui32Idx < ui32Avail; ui32Idx++)
+        {
+            if(pucData[ui32Idx] != (SimRand(&g_ui32SimReadSeed) & 0xFF))
+            {
+                g_ui32SimBad++;
+            }
+        }
+        UARTRxConsume(ui32Avail);
+        g_ui32SimRead += ui32Avail;
+    }
+}
+
+//*****************************************************************************
+//
+// The transfer paths built in, for the report.
+//
+//*****************************************************************************
+#if defined(UART_DMA) && defined(UART_RX_DMA)
+#define SIM_PATHS               "UART_DMA, UART_RX_DMA"
+#elif defined(UART_DMA)
+#define SIM_PATHS               "UART_DMA"
+#elif defined(UART_RX_DMA)
+#define SIM_PATHS               "UART_RX_DMA"
+#else
+#define SIM_PATHS               "interrupt-driven"
+#endif
+
+int
+main(int argc, char *argv[])
+{
+    static const char * const ppcWork[3] = { "tx", "rx", "both" };
+    uint32_t ui32Baud, ui32Seconds, ui32Steps, ui32Step, ui32Work;
+    uint32_t ui32Wire, ui32Read, ui32Ints, ui32Dropped, ui32Overruns;
+    bool bWireOK, bStalled;
+
+    ui32Baud = (argc > 1) ? atoi(argv[1]) : 921600;
+    ui32Seconds = (argc > 2) ? atoi(argv[2]) : 1;
+    ui32Steps = (ui32Baud / 10) * ui32Seconds;
+    if(!ui32Steps)
+    {
+        printf("FAIL: no time to run for\n");
+        return(1);
+    }
+
+    //
+    // Two of the workloads transmit, each for at most one byte a step.
+    //
+    g_ui32SimWireSize = (ui32Steps * 2) + (UART_TX_BUFFER_SIZE * 2) + 1024;
+    g_pucSimWire = malloc(g_ui32SimWireSize);
+    g_pucSimExpect = malloc(g_ui32SimWireSize);
+    if(!g_pucSimWire || !g_pucSimExpect)
+    {
+        printf("FAIL: out of memory\n");
+        return(1);
+    }
+
+    UARTStdioConfig(0, ui32Baud, 80000000);
+    UARTEchoSet(false);
+
+    printf("%s, %u baud, %u byte transmit and %u byte receive buffers\n",
+           SIM_PATHS, ui32Baud, UART_TX_BUFFER_SIZE, UART_RX_BUFFER_SIZE);
+
+    for(ui32Work = 0, bStalled = false; ui32Work < 3; ui32Work++)
+    {
+        //
+        // Run the workload, counting only this part for the rates.
+        //
+        ui32Wire = g_ui32SimWireCount;
+        ui32Read = g_ui32SimRead;
+        ui32Ints = g_ui32SimInts;
+        for(ui32Step = 0; ui32Step < ui32Steps; ui32Step++)
+        {
+            SimStep((ui32Work != 0) ? SimRxNext() : -1);
+            if(ui32Work != 1)
+            {
+                SimWrite();
+            }
+            SimReadAll();
+        }
+        printf("%-5s %8u bytes/s out, %8u bytes/s in, %8u interrupts/s\n",
+               ppcWork[ui32Work], (g_ui32SimWireCount - ui32Wire) / ui32Seconds,
+               (g_ui32SimRead - ui32Read) / ui32Seconds,
+               (g_ui32SimInts - ui32Ints) / ui32Seconds);
+
+        //
+        // Then let the line go quiet until everything written has been sent
+        // and everything sent has been read, which takes no longer than
+        // sending a transmit buffer.
+        //
+        for(ui32Step = 0;
+            ((g_ui32SimWireCount < g_ui32SimExpect) ||
+             (g_ui32SimRead < g_ui32SimRxSent)) &&
+            (ui32Step < ((UART_TX_BUFFER_SIZE * 2) + 64)); ui32Step++)
+        {
+            SimStep(-1);
+            SimReadAll();
+        }
+        if((g_ui32SimWireCount < g_ui32SimExpect) ||
+           (g_ui32SimRead < g_ui32SimRxSent))
+        {
+            printf("FAIL: %u bytes still to send and %u to read once the "
+                   "line is idle\n", g_ui32SimExpect - g_ui32SimWireCount,
+                   g_ui32SimRxSent - g_ui32SimRead);
+            bStalled = true;
+        }
+    }
+
+    UARTRxOverrunGet(&ui32Dropped, &ui32Overruns);
+    bWireOK = ((g_ui32SimWireCount == g_ui32SimExpect) &&
+               !memcmp(g_pucSimWire, g_pucSimExpect, g_ui32SimExpect));
+    printf("tx %u bytes %s, rx %u of %u bytes %s (%u bad), "
+           "%u dropped, %u overruns, %u uDMA errors\n", g_ui32SimWireCount,
+           bWireOK ? "match" : "MISMATCH", g_ui32SimRead, g_ui32SimRxSent,
+           (g_ui32SimBad || (g_ui32SimRead != g_ui32SimRxSent)) ?
+           "MISMATCH" : "match", g_ui32SimBad, ui32Dropped, ui32Overruns,
+           g_ui32SimErrors);
+
+    return((bWireOK && !bStalled && !g_ui32SimBad && (g_ui32SimRead == g_ui32SimRxSent) &&
+            !ui32Dropped && !ui32Overruns && !g_ui32SimErrors) ? 0 : 1);
+}
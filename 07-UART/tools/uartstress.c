@@ -0,0 +1,801 @@
+//*****************************************************************************
+//
+// uartstress.c - Host stress test for the buffered uartstdio ring buffers.
+//
+// Builds ../uartstdio.c for UART_BUFFERED operation on a PC and runs its
+// interrupt handler on a second thread, against a model UART, while the main
+// thread uses the console as an application would.  The two threads run truly
+// concurrently, which is harsher than an interrupt preempting a Cortex-M4:
+// any access to the ring buffers that is not ordered by the indices and
+// barriers shows up here as lost, repeated or corrupted data, and a missed
+// wake-up as a transmitter that stops.
+//
+// The model UART has 16 byte FIFOs.  Its transmitter drains a random number
+// of bytes each time round the interrupt thread's loop and raises the
+// transmit interrupt when the FIFO falls to the trigger level, as the real
+// one does, so a handler that stops refilling it early is not woken again.
+// The receiver takes bytes from a seeded random stream whenever the receive
+// buffer has room for them, raising the receive interrupt at the trigger
+// level and the timeout interrupt when the stream pauses.  IntPendSet() pends
+// the interrupt as the NVIC would.
+//
+// Three phases are run:
+//
+//   raw   echo off; random writes, \n included, through UARTwrite() while
+//         random bytes are read through UARTRxSpan()/UARTRxConsume().  Both
+//         streams must arrive exactly, \n becoming \r\n on the wire.
+//   lines echo on; random lines with backspaces, some ended by CR LF, are
+//         typed in and read back through UARTgets(), which must return each
+//         line as edited.
+//   frames echo on; telemetry records of random length, zeros included, are
+//         queued through UARTTelemetrySend() while lines are typed and
+//         echoed as in the lines phase.  Every record queued must decode
+//         from the wire, which it cannot if echo lands inside its frame.
+//
+// Neither phase may mask the UART interrupt; the calls that would are counted
+// and reported.
+//
+// Build from this directory against the TivaWare headers, for example:
+//
+//   gcc -O2 -pthread -I$TIVAWARE -o uartstress uartstress.c && ./uartstress
+//
+// An optional argument gives the number of megabytes to send each way in the
+// raw phase (default 8).  UART_TX_BUFFER_SIZE and UART_RX_BUFFER_SIZE may be
+// given with -D; small buffers wrap more often.
+//
+//*****************************************************************************
+
+#define UART_BUFFERED
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE     64
+#endif
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE     64
+#endif
+
+#include "../uartstdio.c"
+#include "../uarttelemetry.c"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+//*****************************************************************************
+//
+// A small random number generator, one per stream so that each side of a
+// stream can generate it independently.
+//
+//*****************************************************************************
+static uint32_t
+StressRand(uint32_t *pui32State)
+{
+    uint32_t ui32X = *pui32State;
+
+    ui32X ^= ui32X << 13;
+    ui32X ^= ui32X >> 17;
+    ui32X ^= ui32X << 5;
+    *pui32State = ui32X;
+    return(ui32X);
+}
+
+//*****************************************************************************
+//
+// Now and then give up the CPU in the middle of a driverlib call.  On a host
+// with fewer cores than threads this is what lets the other thread run
+// between two steps of the code under test rather than only at the end of
+// a time slice.
+//
+//*****************************************************************************
+static _Thread_local uint32_t g_ui32StressPreemptSeed = 0x6A09E667;
+
+static void
+StressPreempt(void)
+{
+    if((StressRand(&g_ui32StressPreemptSeed) % 32) == 0)
+    {
+        sched_yield();
+    }
+}
+
+//*****************************************************************************
+//
+// The model UART and NVIC.  Everything but the transmit FIFO level and the
+// pending flag belongs to the interrupt thread; the main thread reads the
+// level through UARTSpaceAvail() and sets the flag through IntPendSet().
+//
+//*****************************************************************************
+#define STRESS_FIFO_SIZE        16
+#define STRESS_TX_TRIGGER       2
+#define STRESS_RX_TRIGGER       2
+
+static unsigned char g_pucStressTxFIFO[STRESS_FIFO_SIZE];
+static uint32_t g_ui32StressTxHead;
+static atomic_uint g_ui32StressTxLevel;
+static unsigned char g_pucStressRxFIFO[STRESS_FIFO_SIZE];
+static uint32_t g_ui32StressRxHead;
+static uint32_t g_ui32StressRxLevel;
+static uint32_t g_ui32StressIntStatus;
+static uint32_t g_ui32StressIntEnable;
+static atomic_bool g_bStressPend;
+static atomic_bool g_bStressRunning;
+static atomic_uint g_ui32StressMasks;
+
+//
+// What has left the transmitter, and how much, published to the main thread.
+// Only the phases that check the wire record it.
+//
+static unsigned char *g_pucStressWire;
+static uint32_t g_ui32StressWireSize;
+static atomic_uint g_ui32StressWireCount;
+static atomic_bool g_bStressCapture;
+
+//
+// The receive stream: raw bytes, or typed lines when echo is on.
+//
+static atomic_bool g_bStressLines;
+static uint32_t g_ui32StressRxSeed;
+static atomic_uint g_ui32StressRxTotal;
+static uint32_t g_ui32StressRxSent;
+static unsigned char g_pucStressLine[UART_RX_BUFFER_SIZE * 2];
+static uint32_t g_ui32StressLinePos;
+static uint32_t g_ui32StressLineLen;
+
+//
+// Interrupt handler runs and wake-ups requested by UARTwrite().
+//
+static atomic_uint g_ui32StressISRs;
+static atomic_uint g_ui32StressKicks;
+
+bool SysCtlPeripheralPresent(uint32_t ui32Peripheral) { return(true); }
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral) { }
+void UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk,
+                         uint32_t ui32Baud, uint32_t ui32Config) { }
+void UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel,
+                      uint32_t ui32RxLevel) { }
+void UARTEnable(uint32_t ui32Base) { }
+void UARTRxErrorClear(uint32_t ui32Base) { }
+void IntEnable(uint32_t ui32Interrupt) { }
+
+void
+UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_ui32StressIntEnable |= ui32IntFlags;
+}
+
+void
+UARTIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_ui32StressIntEnable &= ~ui32IntFlags;
+}
+
+void
+UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_ui32StressIntStatus &= ~ui32IntFlags;
+}
+
+uint32_t
+UARTIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    return(g_ui32StressIntStatus &
+           (bMasked ? g_ui32StressIntEnable : 0xFFFFFFFF));
+}
+
+//
+// Masking the interrupt is exactly what the ring buffers must not need, so
+// once the threads are running these only count.
+//
+void
+IntDisable(uint32_t ui32Interrupt)
+{
+    if(atomic_load(&g_bStressRunning))
+    {
+        atomic_fetch_add(&g_ui32StressMasks, 1);
+    }
+}
+
+bool
+IntMasterDisable(void)
+{
+    IntDisable(0);
+    return(false);
+}
+
+bool IntMasterEnable(void) { return(false); }
+
+void
+IntPendSet(uint32_t ui32Interrupt)
+{
+    atomic_fetch_add(&g_ui32StressKicks, 1);
+    atomic_store(&g_bStressPend, true);
+}
+
+bool
+UARTSpaceAvail(uint32_t ui32Base)
+{
+    StressPreempt();
+    return(atomic_load(&g_ui32StressTxLevel) < STRESS_FIFO_SIZE);
+}
+
+bool
+UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+    uint32_t ui32Level = atomic_load(&g_ui32StressTxLevel);
+
+    StressPreempt();
+    if(ui32Level == STRESS_FIFO_SIZE)
+    {
+        return(false);
+    }
+    g_pucStressTxFIFO[(g_ui32StressTxHead + ui32Level) % STRESS_FIFO_SIZE] =
+        ucData;
+    atomic_store(&g_ui32StressTxLevel, ui32Level + 1);
+    return(true);
+}
+
+void
+UARTCharPut(uint32_t ui32Base, unsigned char ucData)
+{
+    while(!UARTCharPutNonBlocking(ui32Base, ucData))
+    {
+    }
+}
+
+bool
+UARTCharsAvail(uint32_t ui32Base)
+{
+    return(g_ui32StressRxLevel != 0);
+}
+
+int32_t
+UARTCharGetNonBlocking(uint32_t ui32Base)
+{
+    unsigned char ucData;
+
+    StressPreempt();
+    if(!g_ui32StressRxLevel)
+    {
+        return(-1);
+    }
+    ucData = g_pucStressRxFIFO[g_ui32StressRxHead];
+    g_ui32StressRxHead = (g_ui32StressRxHead + 1) % STRESS_FIFO_SIZE;
+    g_ui32StressRxLevel--;
+    return(ucData);
+}
+
+int32_t
+UARTCharGet(uint32_t ui32Base)
+{
+    return(UARTCharGetNonBlocking(ui32Base));
+}
+
+//*****************************************************************************
+//
+// The next line typed in the lines phase: up to half a receive buffer of
+// printable characters with backspaces among them, ended by CR or CR LF.
+// The main thread builds the same lines from the same seed.
+//
+//*****************************************************************************
+static uint32_t
+StressLineMake(uint32_t *pui32Seed, unsigned char *pucLine)
+{
+    uint32_t ui32Len, ui32Count, ui32Idx;
+
+    ui32Count = StressRand(pui32Seed) % (UART_RX_BUFFER_SIZE / 2);
+    for(ui32Idx = 0, ui32Len = 0; ui32Idx < ui32Count; ui32Idx++)
+    {
+        pucLine[ui32Len++] = ((StressRand(pui32Seed) % 8) == 0) ?
+                             '\b' : (' ' + (StressRand(pui32Seed) % 95));
+    }
+    pucLine[ui32Len++] = '\r';
+    if(StressRand(pui32Seed) & 1)
+    {
+        pucLine[ui32Len++] = '\n';
+    }
+    return(ui32Len);
+}
+
+//*****************************************************************************
+//
+// The next byte of the receive stream, or -1 if it is finished.
+//
+//*****************************************************************************
+static int32_t
+StressRxNext(void)
+{
+    if(g_ui32StressRxSent == atomic_load(&g_ui32StressRxTotal))
+    {
+        return(-1);
+    }
+    if(!atomic_load(&g_bStressLines))
+    {
+        g_ui32StressRxSent++;
+        return(StressRand(&g_ui32StressRxSeed) & 0xFF);
+    }
+    if(g_ui32StressLinePos == g_ui32StressLineLen)
+    {
+        g_ui32StressLineLen = StressLineMake(&g_ui32StressRxSeed,
+                                             g_pucStressLine);
+        g_ui32StressLinePos = 0;
+    }
+    if(++g_ui32StressLinePos == g_ui32StressLineLen)
+    {
+        g_ui32StressRxSent++;
+    }
+    return(g_pucStressLine[g_ui32StressLinePos - 1]);
+}
+
+//*****************************************************************************
+//
+// The interrupt thread: the UART hardware, the NVIC and the handler.
+//
+//*****************************************************************************
+static void *
+StressISRThread(void *pvArg)
+{
+    uint32_t ui32Seed = 0x2545F491;
+    uint32_t ui32Count, ui32Level, ui32Wire, ui32Room;
+    int32_t i32Char;
+    bool bPend;
+
+    while(atomic_load(&g_bStressRunning))
+    {
+        //
+        // Send some bytes, raising the transmit interrupt if the FIFO falls
+        // through the trigger level.
+        //
+        ui32Count = StressRand(&ui32Seed) % 4;
+        ui32Level = atomic_load(&g_ui32StressTxLevel);
+        ui32Wire = atomic_load(&g_ui32StressWireCount);
+        while(ui32Count-- && ui32Level)
+        {
+            if(atomic_load(&g_bStressCapture) &&
+               (ui32Wire < g_ui32StressWireSize))
+            {
+                g_pucStressWire[ui32Wire++] =
+                    g_pucStressTxFIFO[g_ui32StressTxHead];
+            }
+            g_ui32StressTxHead = (g_ui32StressTxHead + 1) % STRESS_FIFO_SIZE;
+            atomic_store(&g_ui32StressTxLevel, --ui32Level);
+            if(ui32Level == STRESS_TX_TRIGGER)
+            {
+                g_ui32StressIntStatus |= UART_INT_TX;
+            }
+        }
+        atomic_store(&g_ui32StressWireCount, ui32Wire);
+
+        //
+        // Receive some bytes, as many as the receive buffer will take
+        // without dropping any, or note a pause in the stream.  Lines are
+        // kept to half the buffer so that a whole line always fits, as the
+        // reader waits for its end with UARTPeek().
+        //
+        ui32Count = StressRand(&ui32Seed) % 4;
+        if(!ui32Count && g_ui32StressRxLevel)
+        {
+            g_ui32StressIntStatus |= UART_INT_RT;
+        }
+        ui32Room = atomic_load(&g_bStressLines) ? (UART_RX_BUFFER_SIZE / 2) :
+                   UART_RX_BUFFER_SIZE;
+        while(ui32Count-- && (g_ui32StressRxLevel < STRESS_FIFO_SIZE) &&
+              ((g_ui32UARTRxWriteIndex - g_ui32UARTRxReadIndex +
+                g_ui32StressRxLevel) < ui32Room))
+        {
+            i32Char = StressRxNext();
+            if(i32Char < 0)
+            {
+                break;
+            }
+            g_pucStressRxFIFO[(g_ui32StressRxHead + g_ui32StressRxLevel) %
+                              STRESS_FIFO_SIZE] = i32Char;
+            if(++g_ui32StressRxLevel == STRESS_RX_TRIGGER)
+            {
+                g_ui32StressIntStatus |= UART_INT_RX;
+            }
+        }
+
+        //
+        // Take the interrupt if it is asserted or has been pended.
+        //
+        bPend = atomic_exchange(&g_bStressPend, false);
+        if(bPend || (g_ui32StressIntStatus & g_ui32StressIntEnable))
+        {
+            atomic_fetch_add(&g_ui32StressISRs, 1);
+            UARTStdioIntHandler();
+        }
+        else if(!atomic_load(&g_ui32StressTxLevel))
+        {
+            //
+            // Idle, so let the main thread run if it shares the CPU.
+            //
+            sched_yield();
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Fails if the wire has not moved for a second while the main thread waits on
+// it, which is what a lost transmit wake-up looks like.
+//
+//*****************************************************************************
+static uint32_t g_ui32StressLastWire;
+static time_t g_tStressLastMove;
+
+static void
+StressProgress(const char *pcWhere)
+{
+    uint32_t ui32Wire = atomic_load(&g_ui32StressWireCount);
+
+    if(ui32Wire != g_ui32StressLastWire)
+    {
+        g_ui32StressLastWire = ui32Wire;
+        g_tStressLastMove = time(0);
+    }
+    else if((time(0) - g_tStressLastMove) > 1)
+    {
+        printf("FAIL: transmitter stalled in %s after %u bytes, "
+               "%u waiting\n", pcWhere, ui32Wire, UART_TX_BUFFER_SIZE -
+               UARTTxBytesFree());
+        exit(1);
+    }
+}
+
+//*****************************************************************************
+//
+// The payload of the record with sequence number ui32Seq in the frames phase:
+// random bytes, an eighth of them zero, as many as will let the frame fit in
+// the transmit buffer.  The check builds the same payload from the number it
+// decodes.
+//
+//*****************************************************************************
+#define STRESS_PAYLOAD_MAX                                                    \
+    (((UART_TX_BUFFER_SIZE - 8) < UART_TELEMETRY_MAX_PAYLOAD) ?              \
+     (UART_TX_BUFFER_SIZE - 8) : UART_TELEMETRY_MAX_PAYLOAD)
+
+static uint32_t
+StressPayloadMake(uint32_t ui32Seq, unsigned char *pucPayload)
+{
+    uint32_t ui32Seed, ui32Len, ui32Idx;
+
+    ui32Seed = (ui32Seq * 0x9E3779B1) | 1;
+    ui32Len = StressRand(&ui32Seed) % (STRESS_PAYLOAD_MAX + 1);
+    for(ui32Idx = 0; ui32Idx < ui32Len; ui32Idx++)
+    {
+        pucPayload[ui32Idx] = ((StressRand(&ui32Seed) % 8) == 0) ? 0 :
+                              (StressRand(&ui32Seed) & 0xFF);
+    }
+    return(ui32Len);
+}
+
+//*****************************************************************************
+//
+// Decode one frame, the bytes between its delimiters, and check it against
+// the record that was sent with its sequence number.  *pui32Seq holds the
+// full sequence number of the previous record and is moved on to this one,
+// which must come later.  Returns false if the frame is corrupt.
+//
+//*****************************************************************************
+static bool
+StressFrameCheck(const unsigned char *pucFrame, uint32_t ui32Len,
+                 uint32_t *pui32Seq)
+{
+    unsigned char pucRecord[UART_TELEMETRY_MAX_FRAME];
+    unsigned char pucPayload[UART_TELEMETRY_MAX_PAYLOAD];
+    uint32_t ui32Pos, ui32Out, ui32Code, ui32Seq;
+    uint16_t ui16CRC;
+
+    //
+    // Undo the COBS encoding.
+    //
+    for(ui32Pos = 0, ui32Out = 0; ui32Pos < ui32Len; )
+    {
+        ui32Code = pucFrame[ui32Pos++];
+        if(!ui32Code || ((ui32Pos + ui32Code - 1) > ui32Len) ||
+           ((ui32Out + ui32Code) > sizeof(pucRecord)))
+        {
+            return(false);
+        }
+        memcpy(pucRecord + ui32Out, pucFrame + ui32Pos, ui32Code - 1);
+        ui32Out += ui32Code - 1;
+        ui32Pos += ui32Code - 1;
+        if((ui32Code != 0xFF) && (ui32Pos < ui32Len))
+        {
+            pucRecord[ui32Out++] = 0;
+        }
+    }
+
+    //
+    // Type, sequence number and payload, then the CRC of all three.
+    //
+    if(ui32Out < 5)
+    {
+        return(false);
+    }
+    for(ui32Pos = 0, ui16CRC = 0xFFFF; ui32Pos < (ui32Out - 2); ui32Pos++)
+    {
+        ui16CRC = (ui16CRC << 8) ^
+                  g_pui16TelemetryCRCTable[(ui16CRC >> 8) ^ pucRecord[ui32Pos]];
+    }
+    if((pucRecord[0] != UART_TELEMETRY_USER) ||
+       (pucRecord[ui32Out - 2] != (ui16CRC & 0xFF)) ||
+       (pucRecord[ui32Out - 1] != (ui16CRC >> 8)))
+    {
+        return(false);
+    }
+
+    //
+    // Records may have been dropped for want of room, but none can come back
+    // or be repeated.
+    //
+    ui32Seq = pucRecord[1] | (pucRecord[2] << 8);
+    ui32Seq = *pui32Seq + 1 + ((ui32Seq - *pui32Seq - 1) & 0xFFFF);
+    *pui32Seq = ui32Seq;
+    return((StressPayloadMake(ui32Seq, pucPayload) == (ui32Out - 5)) &&
+           !memcmp(pucRecord + 3, pucPayload, ui32Out - 5));
+}
+
+int
+main(int argc, char *argv[])
+{
+    static char pcLine[UART_RX_BUFFER_SIZE * 2];
+    static unsigned char pucLine[UART_RX_BUFFER_SIZE * 2];
+    static unsigned char pucPayload[UART_TELEMETRY_MAX_PAYLOAD];
+    unsigned char *pucExpect;
+    unsigned char pucChunk[256];
+    const unsigned char *pucData;
+    uint32_t ui32Total, ui32Written, ui32Expect, ui32Received;
+    uint32_t ui32TxSeed, ui32RxSeed, ui32LineSeed;
+    uint32_t ui32Len, ui32Idx, ui32Done, ui32Avail, ui32Lines, ui32Bad;
+    uint32_t ui32Seq, ui32Frames, ui32Corrupt, ui32Sent, ui32Dropped;
+    uint32_t ui32Text, ui32Wire;
+    pthread_t sThread;
+    int iCount;
+
+    ui32Total = ((argc > 1) ? atoi(argv[1]) : 8) << 20;
+    g_ui32StressWireSize = ui32Total * 2;
+    g_pucStressWire = malloc(g_ui32StressWireSize);
+    pucExpect = malloc(ui32Total * 2);
+    if(!g_pucStressWire || !pucExpect)
+    {
+        printf("FAIL: out of memory\n");
+        return(1);
+    }
+
+    UARTStdioConfig(0, 115200, 80000000);
+    UARTEchoSet(false);
+
+    g_ui32StressRxSeed = 0x9E3779B9;
+    atomic_store(&g_ui32StressRxTotal, ui32Total);
+    atomic_store(&g_bStressCapture, true);
+    atomic_store(&g_bStressRunning, true);
+    pthread_create(&sThread, 0, StressISRThread, 0);
+
+    //
+    // Raw phase: write chunks of random bytes, a few of them \n, retrying
+    // what did not fit, and read back whatever has arrived in between.
+    //
+    ui32TxSeed = 0x12345678;
+    ui32RxSeed = 0x9E3779B9;
+    ui32Written = 0;
+    ui32Expect = 0;
+    ui32Received = 0;
+    ui32Bad = 0;
+    g_tStressLastMove = time(0);
+    while((ui32Written < ui32Total) || (ui32Received < ui32Total))
+    {
+        if(ui32Written < ui32Total)
+        {
+            ui32Len = 1 + (StressRand(&ui32TxSeed) % sizeof(pucChunk));
+            if(ui32Len > (ui32Total - ui32Written))
+            {
+                ui32Len = ui32Total - ui32Written;
+            }
+            for(ui32Idx = 0; ui32Idx < ui32Len; ui32Idx++)
+            {
+                pucChunk[ui32Idx] = ((StressRand(&ui32TxSeed) % 16) == 0) ?
+                                    '\n' :
+                                    1 + (StressRand(&ui32TxSeed) % 255);
+            }
+            for(ui32Done = 0; ui32Done < ui32Len; )
+            {
+                iCount = UARTwrite((const char *)pucChunk + ui32Done,
+                                   ui32Len - ui32Done);
+                for(ui32Idx = ui32Done; ui32Idx < (ui32Done + iCount);
+                    ui32Idx++)
+                {
+                    if(pucChunk[ui32Idx] == '\n')
+                    {
+                        pucExpect[ui32Expect++] = '\r';
+                    }
+                    pucExpect[ui32Expect++] = pucChunk[ui32Idx];
+                }
+                ui32Done += iCount;
+                if(ui32Done < ui32Len)
+                {
+                    StressProgress("UARTwrite");
+                    sched_yield();
+                }
+            }
+            ui32Written += ui32Len;
+        }
+
+        ui32Avail = UARTRxSpan(&pucData);
+        for(ui32Idx = 0; ui32Idx < ui32Avail; ui32Idx++)
+        {
+            if(pucData[ui32Idx] != (StressRand(&ui32RxSeed) & 0xFF))
+            {
+                ui32Bad++;
+            }
+        }
+        UARTRxConsume(ui32Avail);
+        ui32Received += ui32Avail;
+        if(!ui32Avail)
+        {
+            sched_yield();
+        }
+    }
+
+    //
+    // Wait for the last of the transmit data to leave.
+    //
+    while(atomic_load(&g_ui32StressWireCount) < ui32Expect)
+    {
+        StressProgress("the final drain");
+        sched_yield();
+    }
+    printf("raw:   tx %u bytes %s, rx %u bytes %s (%u bad)\n", ui32Expect,
+           (!memcmp(g_pucStressWire, pucExpect, ui32Expect) &&
+            (atomic_load(&g_ui32StressWireCount) == ui32Expect)) ?
+           "match" : "MISMATCH", ui32Received, ui32Bad ? "MISMATCH" : "match",
+           ui32Bad);
+    if(memcmp(g_pucStressWire, pucExpect, ui32Expect) || ui32Bad)
+    {
+        return(1);
+    }
+
+    //
+    // Lines phase: the interrupt thread types lines and echoes them, the
+    // main thread reads them with UARTgets() and checks them against the
+    // same lines with the backspaces applied.
+    //
+    ui32Lines = (ui32Total >> 4) / UART_RX_BUFFER_SIZE;
+    atomic_store(&g_bStressCapture, false);
+    UARTEchoSet(true);
+    ui32LineSeed = 0xC0FFEE11;
+    g_ui32StressRxSeed = ui32LineSeed;
+    g_ui32StressRxSent = 0;
+    atomic_store(&g_bStressLines, true);
+    atomic_store(&g_ui32StressRxTotal, ui32Lines);
+
+    for(ui32Idx = 0, ui32Bad = 0; ui32Idx < ui32Lines; ui32Idx++)
+    {
+        ui32Len = StressLineMake(&ui32LineSeed, pucLine);
+        for(ui32Done = 0, ui32Avail = 0; ui32Done < ui32Len; ui32Done++)
+        {
+            if(pucLine[ui32Done] == '\b')
+            {
+                ui32Avail -= (ui32Avail != 0);
+            }
+            else if((pucLine[ui32Done] != '\r') && (pucLine[ui32Done] != '\n'))
+            {
+                pucLine[ui32Avail++] = pucLine[ui32Done];
+            }
+        }
+        while(UARTPeek('\r') < 0)
+        {
+            sched_yield();
+        }
+        iCount = UARTgets(pcLine, sizeof(pcLine));
+        if((iCount != ui32Avail) || memcmp(pcLine, pucLine, ui32Avail))
+        {
+            ui32Bad++;
+        }
+    }
+    printf("lines: %u lines %s (%u bad)\n", ui32Lines,
+           ui32Bad ? "MISMATCH" : "match", ui32Bad);
+
+    //
+    // Frames phase: queue records until an eighth of the raw phase's data has
+    // gone, retrying each one that does not fit, and now and then wait for
+    // the transmit buffer to empty so that echo can go out between frames.
+    // Meanwhile the interrupt thread types as many lines again, which are
+    // read and thrown away.
+    //
+    while(atomic_load(&g_ui32StressTxLevel) ||
+          (UARTTxBytesFree() != UART_TX_BUFFER_SIZE))
+    {
+        StressProgress("the lines drain");
+        sched_yield();
+    }
+    ui32Wire = atomic_load(&g_ui32StressWireCount);
+    atomic_store(&g_bStressCapture, true);
+    g_ui32StressRxSeed = 0xBADC0DE5;
+    atomic_store(&g_ui32StressRxTotal, ui32Lines * 2);
+
+    for(ui32Seq = 0, ui32Done = 0, ui32Idx = ui32Lines;
+        (ui32Idx < (ui32Lines * 2)) || (ui32Done < (ui32Total >> 3)); )
+    {
+        if(ui32Done < (ui32Total >> 3))
+        {
+            ui32Len = StressPayloadMake(ui32Seq, pucPayload);
+            if(UARTTelemetrySend(UART_TELEMETRY_USER, pucPayload, ui32Len))
+            {
+                ui32Done += ui32Len + 8;
+            }
+            else
+            {
+                StressProgress("UARTTelemetrySend");
+                sched_yield();
+            }
+            ui32Seq++;
+
+            while(((StressRand(&ui32TxSeed) % 16) == 0) &&
+                  (UARTTxBytesFree() != UART_TX_BUFFER_SIZE))
+            {
+                StressProgress("the frames drain");
+                sched_yield();
+            }
+        }
+
+        if((ui32Idx < (ui32Lines * 2)) && (UARTPeek('\r') >= 0))
+        {
+            UARTgets(pcLine, sizeof(pcLine));
+            ui32Idx++;
+        }
+    }
+
+    //
+    // Wait for the frames and the last of the echo to leave, then take the
+    // wire apart: text up to a zero, then a frame up to the next.
+    //
+    while(atomic_load(&g_ui32StressTxLevel) ||
+          (UARTTxBytesFree() != UART_TX_BUFFER_SIZE) ||
+          (g_ui32UARTEchoReadIndex != g_ui32UARTEchoWriteIndex))
+    {
+        StressProgress("the final drain");
+        sched_yield();
+    }
+    UARTTelemetryStatsGet(&ui32Sent, &ui32Dropped);
+    ui32Len = atomic_load(&g_ui32StressWireCount);
+    for(ui32Frames = 0, ui32Text = 0, ui32Seq = 0xFFFFFFFF, ui32Corrupt = 0;
+        ui32Wire < ui32Len; ui32Wire = ui32Idx + 1)
+    {
+        if(g_pucStressWire[ui32Wire])
+        {
+            ui32Text++;
+            ui32Idx = ui32Wire;
+            continue;
+        }
+        for(ui32Idx = ui32Wire + 1;
+            (ui32Idx < ui32Len) && g_pucStressWire[ui32Idx]; ui32Idx++)
+        {
+        }
+        if((ui32Idx == ui32Len) ||
+           !StressFrameCheck(g_pucStressWire + ui32Wire + 1,
+                             ui32Idx - ui32Wire - 1, &ui32Seq))
+        {
+            ui32Corrupt++;
+        }
+        ui32Frames++;
+    }
+    printf("frames: %u of %u frames %s (%u bad, %u dropped), "
+           "%u bytes of echo\n", ui32Frames - ui32Corrupt, ui32Sent,
+           (ui32Corrupt || (ui32Frames != ui32Sent)) ? "MISMATCH" : "match",
+           ui32Corrupt, ui32Dropped, ui32Text);
+    ui32Bad += ui32Corrupt + (ui32Frames != ui32Sent);
+
+    atomic_store(&g_bStressRunning, false);
+    pthread_join(sThread, 0);
+
+    printf("interrupts %u, wake-ups %u, interrupt masks %u\n",
+           atomic_load(&g_ui32StressISRs), atomic_load(&g_ui32StressKicks),
+           atomic_load(&g_ui32StressMasks));
+
+    return((ui32Bad || atomic_load(&g_ui32StressMasks)) ? 1 : 0);
+}
@@ -25,6 +25,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdarg.h>
+#include <string.h>
 #include "inc/hw_ints.h"
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
@@ -35,6 +36,12 @@
 #include "driverlib/rom_map.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/uart.h"
+#if defined(UART_DMA) || defined(UART_RX_DMA)
+#include "driverlib/udma.h"
+#endif
+#if defined(ewarm)
+#include <intrinsics.h>
+#endif
 #include "utils/uartstdio.h"
 
 //*****************************************************************************
@@ -63,59 +70,193 @@
 //*****************************************************************************
 static bool g_bDisableEcho;
 
+#ifdef UART_DMA
+//*****************************************************************************
+//
+// Output ping-pong buffers.  UARTwrite() appends to the half selected by
+// g_ui32UARTTxFill while the uDMA streams the other half, holding
+// g_pui32UARTTxCount[] bytes, into the UART data register.  The count of the
+// half being sent stays non-zero until its transfer has completed, so both
+// counts are zero only once everything has been handed to the UART.
+//
 //*****************************************************************************
+#define UART_TX_BLOCK_SIZE      (UART_TX_BUFFER_SIZE / 2)
+#if UART_TX_BLOCK_SIZE > 1024
+#error "UART_TX_BUFFER_SIZE / 2 exceeds the 1024 items of a uDMA transfer"
+#endif
+static unsigned char g_pcUARTTxBuffer[2][UART_TX_BLOCK_SIZE];
+static volatile uint32_t g_pui32UARTTxCount[2];
+static volatile uint32_t g_ui32UARTTxFill = 0;
+static volatile bool g_bUARTTxBusy = false;
+#else
+//*****************************************************************************
+//
+// Output ring buffer.  The indices run freely and are masked to the buffer
+// size, a power of two, only to address the buffer.  It holds
+// g_ui32UARTTxWriteIndex - g_ui32UARTTxReadIndex bytes, so it is empty when
+// the indices are the same and full when they are a whole buffer apart.
 //
-// Output ring buffer.  Buffer is full if g_ui32UARTTxReadIndex is one ahead of
-// g_ui32UARTTxWriteIndex.  Buffer is empty if the two indices are the same.
+// The buffer is a single-producer, single-consumer queue: UARTwrite() alone
+// moves the write index and the interrupt handler alone moves the read index,
+// so neither has to lock the other out.
 //
 //*****************************************************************************
+#if UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1)
+#error "UART_TX_BUFFER_SIZE must be a power of two"
+#endif
 static unsigned char g_pcUARTTxBuffer[UART_TX_BUFFER_SIZE];
 static volatile uint32_t g_ui32UARTTxWriteIndex = 0;
 static volatile uint32_t g_ui32UARTTxReadIndex = 0;
 
+//
+// The index just past the last block queued by UARTTxBlock().  Until the read
+// index reaches it a block is still to be sent, or partly sent, and no echo
+// may be put in front of the rest.
+//
+static volatile uint32_t g_ui32UARTTxBlockEnd = 0;
+
 //*****************************************************************************
 //
-// Input ring buffer.  Buffer is full if g_ui32UARTTxReadIndex is one ahead of
-// g_ui32UARTTxWriteIndex.  Buffer is empty if the two indices are the same.
+// Echoed characters.  These are produced and sent by the interrupt handler,
+// ahead of the output buffer, so that it never has to write to the output
+// buffer itself.  They are held back while a block from UARTTxBlock() is
+// waiting, and dropped if more arrive than fit meanwhile.
 //
 //*****************************************************************************
+#define UART_ECHO_BUFFER_SIZE   16
+static unsigned char g_pcUARTEchoBuffer[UART_ECHO_BUFFER_SIZE];
+static uint32_t g_ui32UARTEchoWriteIndex = 0;
+static uint32_t g_ui32UARTEchoReadIndex = 0;
+#endif
+
+#ifdef UART_RX_DMA
+//*****************************************************************************
+//
+// Input circular buffer, written by the uDMA in ping-pong mode: the primary
+// control structure fills the first half, the alternate one the second, and
+// each is re-armed as soon as it completes.  The indices count bytes since the
+// buffer was flushed; g_ui32UARTRxWriteIndex is advanced by the interrupt
+// handler when a half completes or the line goes idle, and only the reader
+// moves g_ui32UARTRxReadIndex.  The half the uDMA is writing may already hold
+// newer bytes than the write index shows, so only data from the start of the
+// half before it can still be read; older data has been overwritten.
+//
+//*****************************************************************************
+#define UART_RX_HALF_SIZE       (UART_RX_BUFFER_SIZE / 2)
+#if (UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)) ||                     \
+    (UART_RX_HALF_SIZE > 1024) || (UART_RX_HALF_SIZE < 8)
+#error "UART_RX_BUFFER_SIZE must be a power of two from 16 to 2048"
+#endif
+#else
+//*****************************************************************************
+//
+// Input ring buffer, organized like the output ring buffer, with the
+// interrupt handler as the producer and the reading functions as the
+// consumer.  Each character is handed to the reader as soon as it is stored,
+// and since the reader may already have taken it, it is never withdrawn: a
+// backspace typed while echo is enabled is stored as well, for UARTgets() to
+// apply.  g_ui32UARTRxLineCount counts the characters of the current line
+// still on the terminal, which is how far backspace may rub out.
+//
+//*****************************************************************************
+#if UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)
+#error "UART_RX_BUFFER_SIZE must be a power of two"
+#endif
+static uint32_t g_ui32UARTRxLineCount = 0;
+#endif
 static unsigned char g_pcUARTRxBuffer[UART_RX_BUFFER_SIZE];
 static volatile uint32_t g_ui32UARTRxWriteIndex = 0;
 static volatile uint32_t g_ui32UARTRxReadIndex = 0;
 
 //*****************************************************************************
 //
-// Macros to determine number of free and used bytes in the transmit buffer.
+// Receive data lost: bytes discarded or overwritten because the buffer was
+// full, and overruns of the UART receive FIFO.
+//
+//*****************************************************************************
+static volatile uint32_t g_ui32UARTRxDropped = 0;
+static volatile uint32_t g_ui32UARTRxOverruns = 0;
+
+#if defined(UART_DMA) || defined(UART_RX_DMA)
+//*****************************************************************************
+//
+// The uDMA channel control table, unless the application has installed one.
+// The controller requires it to be aligned to its size.
 //
 //*****************************************************************************
+#if defined(ccs)
+#pragma DATA_ALIGN(g_pui8UARTDMAControl, 1024)
+static uint8_t g_pui8UARTDMAControl[1024];
+#else
+static uint8_t g_pui8UARTDMAControl[1024] __attribute__((aligned(1024)));
+#endif
+#endif
+
+//*****************************************************************************
+//
+// Macros to determine number of free and used bytes in the transmit buffer.
+// With the ping-pong buffers, free space is what is left in the half being
+// filled.
+//
+//*****************************************************************************
+#ifdef UART_DMA
+#define TX_BUFFER_USED          (g_pui32UARTTxCount[0] + g_pui32UARTTxCount[1])
+#define TX_BUFFER_FREE          (UART_TX_BLOCK_SIZE -                       \
+                                 g_pui32UARTTxCount[g_ui32UARTTxFill])
+#define TX_BUFFER_EMPTY         (TX_BUFFER_USED == 0)
+#define TX_BUFFER_FULL          (TX_BUFFER_FREE == 0)
+#define TX_BUFFER_PUT(cChar)                                                \
+        g_pcUARTTxBuffer[g_ui32UARTTxFill]                                  \
+                        [g_pui32UARTTxCount[g_ui32UARTTxFill]++] = (cChar)
+#else
 #define TX_BUFFER_USED          (GetBufferCount(&g_ui32UARTTxReadIndex,  \
-                                                &g_ui32UARTTxWriteIndex, \
-                                                UART_TX_BUFFER_SIZE))
+                                                &g_ui32UARTTxWriteIndex))
 #define TX_BUFFER_FREE          (UART_TX_BUFFER_SIZE - TX_BUFFER_USED)
-#define TX_BUFFER_EMPTY         (IsBufferEmpty(&g_ui32UARTTxReadIndex,   \
-                                               &g_ui32UARTTxWriteIndex))
-#define TX_BUFFER_FULL          (IsBufferFull(&g_ui32UARTTxReadIndex,  \
-                                              &g_ui32UARTTxWriteIndex, \
-                                              UART_TX_BUFFER_SIZE))
-#define ADVANCE_TX_BUFFER_INDEX(Index) \
-                                (Index) = ((Index) + 1) % UART_TX_BUFFER_SIZE
+#define TX_BUFFER_EMPTY         (TX_BUFFER_USED == 0)
+#define TX_BUFFER_FULL          (TX_BUFFER_FREE == 0)
+#define TX_BUFFER_OFFSET(Index) ((Index) & (UART_TX_BUFFER_SIZE - 1))
+#endif
 
 //*****************************************************************************
 //
-// Macros to determine number of free and used bytes in the receive buffer.
+// Macros to determine number of free and used bytes in the receive buffer,
+// and to access it.
 //
 //*****************************************************************************
+#ifdef UART_RX_DMA
+#define RX_BUFFER_USED          (GetRxDMACount())
+#else
 #define RX_BUFFER_USED          (GetBufferCount(&g_ui32UARTRxReadIndex,  \
-                                                &g_ui32UARTRxWriteIndex, \
-                                                UART_RX_BUFFER_SIZE))
-#define RX_BUFFER_FREE          (UART_RX_BUFFER_SIZE - RX_BUFFER_USED)
-#define RX_BUFFER_EMPTY         (IsBufferEmpty(&g_ui32UARTRxReadIndex,   \
-                                               &g_ui32UARTRxWriteIndex))
-#define RX_BUFFER_FULL          (IsBufferFull(&g_ui32UARTRxReadIndex,  \
-                                              &g_ui32UARTRxWriteIndex, \
-                                              UART_RX_BUFFER_SIZE))
+                                                &g_ui32UARTRxWriteIndex))
+#define RX_BUFFER_FULL          (RX_BUFFER_USED == UART_RX_BUFFER_SIZE)
+#endif
+#define RX_BUFFER_EMPTY         (RX_BUFFER_USED == 0)
+#define RX_BUFFER_OFFSET(Index) ((Index) & (UART_RX_BUFFER_SIZE - 1))
 #define ADVANCE_RX_BUFFER_INDEX(Index) \
-                                (Index) = ((Index) + 1) % UART_RX_BUFFER_SIZE
+                                (Index) = (Index) + 1
+#define ADVANCE_RX_BUFFER_INDEX_BY(Index, Count) \
+                                (Index) = (Index) + (Count)
+#define RX_BUFFER_CHAR(Index)   (g_pcUARTRxBuffer[RX_BUFFER_OFFSET(Index)])
+
+//*****************************************************************************
+//
+// A memory barrier, placed between accessing buffer contents and moving the
+// index that passes them to the other side, between reading the other
+// side's index and accessing what it covers, and between publishing an index
+// and checking whether the other side has caught up.  On a Cortex-M4 this
+// chiefly stops the compiler from moving buffer accesses past the volatile
+// index.
+//
+//*****************************************************************************
+#if defined(ccs)
+#define MEMORY_BARRIER()        __asm("    dmb")
+#elif defined(ewarm)
+#define MEMORY_BARRIER()        __DMB()
+#elif defined(rvmdk) || defined(__ARMCC_VERSION)
+#define MEMORY_BARRIER()        __dmb(0xF)
+#else
+#define MEMORY_BARRIER()        __sync_synchronize()
+#endif
 #endif
 
 //*****************************************************************************
@@ -162,6 +303,34 @@ static const uint32_t g_ui32UARTInt[3] =
 static uint32_t g_ui32PortNum;
 #endif
 
+#ifdef UART_DMA
+//*****************************************************************************
+//
+// The list of uDMA channel assignments for the console UART's transmitter,
+// and the channel in use.
+//
+//*****************************************************************************
+static const uint32_t g_ui32UARTTxDMA[3] =
+{
+    UDMA_CH9_UART0TX, UDMA_CH23_UART1TX, UDMA_CH13_UART2TX
+};
+static uint32_t g_ui32UARTTxChannel;
+#endif
+
+#ifdef UART_RX_DMA
+//*****************************************************************************
+//
+// The list of uDMA channel assignments for the console UART's receiver, and
+// the channel in use.
+//
+//*****************************************************************************
+static const uint32_t g_ui32UARTRxDMA[3] =
+{
+    UDMA_CH8_UART0RX, UDMA_CH22_UART1RX, UDMA_CH12_UART2RX
+};
+static uint32_t g_ui32UARTRxChannel;
+#endif
+
 //*****************************************************************************
 //
 // The list of UART peripherals.
@@ -174,138 +343,373 @@ static const uint32_t g_ui32UARTPeriph[3] =
 
 //*****************************************************************************
 //
-//! Determines whether the ring buffer whose pointers and size are provided
-//! is full or not.
+//! Determines the number of bytes of data contained in a ring buffer.
 //!
 //! \param pui32Read points to the read index for the buffer.
 //! \param pui32Write points to the write index for the buffer.
-//! \param ui32Size is the size of the buffer in bytes.
 //!
-//! This function is used to determine whether or not a given ring buffer is
-//! full.  The structure of the code is specifically to ensure that we do not
-//! see warnings from the compiler related to the order of volatile accesses
-//! being undefined.
+//! This function is used to determine how many bytes of data a given ring
+//! buffer currently contains.  The indices run freely, so this is simply their
+//! difference, which stays correct when they wrap.  The barrier makes the
+//! contents the other side published along with its index visible before the
+//! caller goes on to use them.  The structure of the code is specifically to
+//! ensure that we do not see warnings from the compiler related to the order
+//! of volatile accesses being undefined.  With both \b UART_DMA and
+//! \b UART_RX_DMA neither buffer is a ring of this kind.
 //!
-//! \return Returns \b true if the buffer is full or \b false otherwise.
+//! \return Returns the number of bytes of data currently in the buffer.
 //
 //*****************************************************************************
-#ifdef UART_BUFFERED
-static bool
-IsBufferFull(volatile uint32_t *pui32Read,
-             volatile uint32_t *pui32Write, uint32_t ui32Size)
+#if defined(UART_BUFFERED) &&                                                \
+    !(defined(UART_DMA) && defined(UART_RX_DMA))
+static uint32_t
+GetBufferCount(volatile uint32_t *pui32Read,
+               volatile uint32_t *pui32Write)
 {
     uint32_t ui32Write;
     uint32_t ui32Read;
 
     ui32Write = *pui32Write;
     ui32Read = *pui32Read;
+    MEMORY_BARRIER();
 
-    return((((ui32Write + 1) % ui32Size) == ui32Read) ? true : false);
+    return(ui32Write - ui32Read);
 }
 #endif
 
 //*****************************************************************************
 //
-//! Determines whether the ring buffer whose pointers and size are provided
-//! is empty or not.
+//! Determines the number of bytes of data that can be read from the uDMA
+//! receive buffer.
 //!
-//! \param pui32Read points to the read index for the buffer.
-//! \param pui32Write points to the write index for the buffer.
-//!
-//! This function is used to determine whether or not a given ring buffer is
-//! empty.  The structure of the code is specifically to ensure that we do not
-//! see warnings from the compiler related to the order of volatile accesses
-//! being undefined.
+//! If the reader has fallen so far behind that the uDMA has started
+//! overwriting unread data, the read index is first moved up to the oldest
+//! byte still intact and the bytes skipped are counted as dropped.  Only
+//! called by the reader, so it is the only place other than the reader itself
+//! that moves the read index.
 //!
-//! \return Returns \b true if the buffer is empty or \b false otherwise.
+//! \return Returns the number of bytes of data currently in the buffer.
 //
 //*****************************************************************************
-#ifdef UART_BUFFERED
-static bool
-IsBufferEmpty(volatile uint32_t *pui32Read,
-              volatile uint32_t *pui32Write)
+#ifdef UART_RX_DMA
+static uint32_t
+GetRxDMACount(void)
 {
     uint32_t ui32Write;
-    uint32_t ui32Read;
+    uint32_t ui32Oldest;
 
-    ui32Write = *pui32Write;
-    ui32Read = *pui32Read;
+    ui32Write = g_ui32UARTRxWriteIndex;
+    MEMORY_BARRIER();
+
+    //
+    // The uDMA is writing the half that starts at or after the write index,
+    // so only the half before that one is safe.
+    //
+    ui32Oldest = (ui32Write & ~(UART_RX_HALF_SIZE - 1)) - UART_RX_HALF_SIZE;
+    if((int32_t)(ui32Oldest - g_ui32UARTRxReadIndex) > 0)
+    {
+        g_ui32UARTRxDropped += ui32Oldest - g_ui32UARTRxReadIndex;
+        g_ui32UARTRxReadIndex = ui32Oldest;
+    }
 
-    return((ui32Write == ui32Read) ? true : false);
+    return(ui32Write - g_ui32UARTRxReadIndex);
 }
-#endif
 
 //*****************************************************************************
 //
-//! Determines the number of bytes of data contained in a ring buffer.
-//!
-//! \param pui32Read points to the read index for the buffer.
-//! \param pui32Write points to the write index for the buffer.
-//! \param ui32Size is the size of the buffer in bytes.
-//!
-//! This function is used to determine how many bytes of data a given ring
-//! buffer currently contains.  The structure of the code is specifically to
-//! ensure that we do not see warnings from the compiler related to the order
-//! of volatile accesses being undefined.
-//!
-//! \return Returns the number of bytes of data currently in the buffer.
+// Point one of the receive channel's control structures (primary for the
+// first half of the buffer, alternate for the second) at its half again.
 //
 //*****************************************************************************
-#ifdef UART_BUFFERED
-static uint32_t
-GetBufferCount(volatile uint32_t *pui32Read,
-               volatile uint32_t *pui32Write, uint32_t ui32Size)
+static void
+UARTRxDMAArm(uint32_t ui32Select)
+{
+    MAP_uDMAChannelTransferSet(g_ui32UARTRxChannel | ui32Select,
+                               UDMA_MODE_PINGPONG,
+                               (void *)(g_ui32Base + UART_O_DR),
+                               &g_pcUARTRxBuffer[(ui32Select ==
+                                                  UDMA_ALT_SELECT) ?
+                                                 UART_RX_HALF_SIZE : 0],
+                               UART_RX_HALF_SIZE);
+}
+
+//*****************************************************************************
+//
+// Advance the receive write index to where the uDMA has got to: the half its
+// active control structure fills, less what that structure has still to
+// transfer.  Called from the interrupt handler at least once per half, so the
+// uDMA never gets a whole buffer ahead of the index.
+//
+//*****************************************************************************
+static void
+UARTRxDMAUpdate(void)
 {
+    uint32_t ui32Pos;
     uint32_t ui32Write;
-    uint32_t ui32Read;
 
-    ui32Write = *pui32Write;
-    ui32Read = *pui32Read;
+    if(MAP_uDMAChannelAttributeGet(g_ui32UARTRxChannel) & UDMA_ATTR_ALTSELECT)
+    {
+        ui32Pos = UART_RX_BUFFER_SIZE -
+                  MAP_uDMAChannelSizeGet(g_ui32UARTRxChannel |
+                                         UDMA_ALT_SELECT);
+    }
+    else
+    {
+        ui32Pos = UART_RX_HALF_SIZE -
+                  MAP_uDMAChannelSizeGet(g_ui32UARTRxChannel |
+                                         UDMA_PRI_SELECT);
+    }
 
-    return((ui32Write >= ui32Read) ? (ui32Write - ui32Read) :
-           (ui32Size - (ui32Read - ui32Write)));
+    ui32Write = g_ui32UARTRxWriteIndex;
+    g_ui32UARTRxWriteIndex = ui32Write +
+                             RX_BUFFER_OFFSET(ui32Pos - ui32Write);
 }
 #endif
 
 //*****************************************************************************
 //
-// Take as many bytes from the transmit buffer as we have space for and move
-// them into the UART transmit FIFO.
+// If the uDMA is idle, hand it the half of the transmit buffer being filled
+// and switch filling to the other half, whose transfer has completed.  Must be
+// called with the UART interrupt disabled or from the interrupt handler.
 //
 //*****************************************************************************
-#ifdef UART_BUFFERED
+#if defined(UART_DMA)
 static void
 UARTPrimeTransmit(uint32_t ui32Base)
 {
+    uint32_t ui32Fill;
+
+    ui32Fill = g_ui32UARTTxFill;
+
     //
-    // Do we have any data to transmit?
+    // Is the channel free and is there anything to send?
     //
-    if(!TX_BUFFER_EMPTY)
+    if(!g_bUARTTxBusy && g_pui32UARTTxCount[ui32Fill])
     {
         //
-        // Disable the UART interrupt.  If we don't do this there is a race
-        // condition which can cause the read index to be corrupted.
+        // Stream the whole half into the data register.  The UART requests
+        // bytes as its transmit FIFO drains, and the CPU only hears about it
+        // once the block is done.
         //
-        MAP_IntDisable(g_ui32UARTInt[g_ui32PortNum]);
+        MAP_uDMAChannelTransferSet(g_ui32UARTTxChannel | UDMA_PRI_SELECT,
+                                   UDMA_MODE_BASIC,
+                                   g_pcUARTTxBuffer[ui32Fill],
+                                   (void *)(ui32Base + UART_O_DR),
+                                   g_pui32UARTTxCount[ui32Fill]);
+        g_bUARTTxBusy = true;
+        MAP_uDMAChannelEnable(g_ui32UARTTxChannel);
 
         //
-        // Yes - take some characters out of the transmit buffer and feed
-        // them to the UART transmit FIFO.
+        // New characters go to the other half from now on.
         //
-        while(MAP_UARTSpaceAvail(ui32Base) && !TX_BUFFER_EMPTY)
+        g_ui32UARTTxFill = ui32Fill ^ 1;
+    }
+}
+
+//*****************************************************************************
+//
+// Move echoed characters into the UART transmit FIFO, as many as it has space
+// for, unless the output buffer is in the middle of a block from UARTTxBlock()
+// at index ui32Read.  The block end is set before the write index that makes
+// the block visible, and only moves on, so once the read index has reached it
+// nothing sent so far belongs to a block that is not finished.
+//
+//*****************************************************************************
+#elif defined(UART_BUFFERED)
+static void
+UARTPrimeEcho(uint32_t ui32Base, uint32_t ui32Read)
+{
+    MEMORY_BARRIER();
+    if((int32_t)(g_ui32UARTTxBlockEnd - ui32Read) > 0)
+    {
+        return;
+    }
+
+    while((g_ui32UARTEchoReadIndex != g_ui32UARTEchoWriteIndex) &&
+          MAP_UARTSpaceAvail(ui32Base))
+    {
+        MAP_UARTCharPutNonBlocking(ui32Base,
+                                   g_pcUARTEchoBuffer[g_ui32UARTEchoReadIndex %
+                                                      UART_ECHO_BUFFER_SIZE]);
+        g_ui32UARTEchoReadIndex++;
+    }
+}
+
+//*****************************************************************************
+//
+// Take as many bytes from the echo and transmit buffers as we have space for
+// and move them into the UART transmit FIFO.  Only called from the interrupt
+// handler, which is the sole consumer of both buffers.
+//
+//*****************************************************************************
+static void
+UARTPrimeTransmit(uint32_t ui32Base)
+{
+    uint32_t ui32Read;
+    uint32_t ui32Write;
+
+    //
+    // Echoed characters go first, to keep the terminal responsive.
+    //
+    ui32Read = g_ui32UARTTxReadIndex;
+    UARTPrimeEcho(ui32Base, ui32Read);
+
+    //
+    // Then feed the UART transmit FIFO from what UARTwrite() has made
+    // available.  The read index is only written back, releasing the space,
+    // once the characters are in the FIFO.  UARTwrite() may add more
+    // meanwhile without seeing that we had caught up, so look again after
+    // each write back and stop only when the FIFO is full, in which case its
+    // transmit interrupt is still to come, or there is nothing left.
+    //
+    while(MAP_UARTSpaceAvail(ui32Base))
+    {
+        ui32Write = g_ui32UARTTxWriteIndex;
+        MEMORY_BARRIER();
+        if(ui32Read == ui32Write)
+        {
+            break;
+        }
+
+        while((ui32Read != ui32Write) && MAP_UARTSpaceAvail(ui32Base))
         {
             MAP_UARTCharPutNonBlocking(ui32Base,
-                                      g_pcUARTTxBuffer[g_ui32UARTTxReadIndex]);
-            ADVANCE_TX_BUFFER_INDEX(g_ui32UARTTxReadIndex);
+                                 g_pcUARTTxBuffer[TX_BUFFER_OFFSET(ui32Read)]);
+            ui32Read++;
         }
+        MEMORY_BARRIER();
+        g_ui32UARTTxReadIndex = ui32Read;
+        MEMORY_BARRIER();
+    }
 
-        //
-        // Reenable the UART interrupt.
-        //
-        MAP_IntEnable(g_ui32UARTInt[g_ui32PortNum]);
+    //
+    // Echo held back by a block can follow it once the whole block is in the
+    // FIFO.  If it is not, either the FIFO is full and its transmit interrupt
+    // is still to come, or another block has just been published, which
+    // pends the interrupt.
+    //
+    UARTPrimeEcho(ui32Base, ui32Read);
+}
+
+//*****************************************************************************
+//
+// Copy ui32Count characters into the transmit ring buffer at index ui32Write,
+// in at most two pieces either side of the end of the buffer.  The caller
+// checks for space and advances the write index.
+//
+//*****************************************************************************
+static void
+UARTTxBufferCopy(uint32_t ui32Write, const char *pcBuf, uint32_t ui32Count)
+{
+    uint32_t ui32Offset;
+    uint32_t ui32Part;
+
+    ui32Offset = TX_BUFFER_OFFSET(ui32Write);
+    ui32Part = UART_TX_BUFFER_SIZE - ui32Offset;
+    if(ui32Part > ui32Count)
+    {
+        ui32Part = ui32Count;
+    }
+
+    memcpy(&g_pcUARTTxBuffer[ui32Offset], pcBuf, ui32Part);
+    memcpy(g_pcUARTTxBuffer, pcBuf + ui32Part, ui32Count - ui32Part);
+}
+
+//*****************************************************************************
+//
+// Hand the characters written to the transmit ring buffer from index
+// ui32Start up to ui32Write to the interrupt handler.  The handler refills the
+// transmit FIFO each time it drains, and looks for more after releasing
+// space, so it only needs waking if it has already sent everything written
+// before and the FIFO has room; when the FIFO is full its transmit interrupt
+// is still to come.  Pending the interrupt runs the handler, which sends
+// these characters, instead of reaching into the FIFO from here.
+//
+//*****************************************************************************
+static void
+UARTTxPublish(uint32_t ui32Start, uint32_t ui32Write)
+{
+    MEMORY_BARRIER();
+    g_ui32UARTTxWriteIndex = ui32Write;
+    MEMORY_BARRIER();
+
+    if((ui32Write != ui32Start) && (g_ui32UARTTxReadIndex == ui32Start) &&
+       MAP_UARTSpaceAvail(g_ui32Base))
+    {
+        MAP_IntPendSet(g_ui32UARTInt[g_ui32PortNum]);
+    }
+}
+#endif
+
+//*****************************************************************************
+//
+// Count the characters at the start of pcBuf, at most ui32Len, that UARTwrite()
+// sends as they are: those before the first \n, which needs a \r adding, or
+// the null character that ends the string.
+//
+//*****************************************************************************
+#ifdef UART_BUFFERED
+static uint32_t
+UARTPlainRun(const char *pcBuf, uint32_t ui32Len)
+{
+    uint32_t ui32Run;
+
+    for(ui32Run = 0; ui32Run < ui32Len; ui32Run++)
+    {
+        if((pcBuf[ui32Run] == '\n') || (pcBuf[ui32Run] == 0))
+        {
+            break;
+        }
+    }
+
+    return(ui32Run);
+}
+#endif
+
+//*****************************************************************************
+//
+// Echo received characters back to the terminal, translating \n to \r\n as
+// UARTwrite() does.  Called from the interrupt handler.  With the output ring
+// buffer, which only UARTwrite() may add to, the characters go to the echo
+// buffer instead, and are dropped if that is full.
+//
+//*****************************************************************************
+#ifndef UART_RX_DMA
+#if defined(UART_DMA)
+static void
+UARTEcho(const char *pcBuf, uint32_t ui32Len)
+{
+    UARTwrite(pcBuf, ui32Len);
+}
+#elif defined(UART_BUFFERED)
+static void
+UARTEchoPut(unsigned char ucChar)
+{
+    if((g_ui32UARTEchoWriteIndex - g_ui32UARTEchoReadIndex) <
+       UART_ECHO_BUFFER_SIZE)
+    {
+        g_pcUARTEchoBuffer[g_ui32UARTEchoWriteIndex % UART_ECHO_BUFFER_SIZE] =
+            ucChar;
+        g_ui32UARTEchoWriteIndex++;
+    }
+}
+
+static void
+UARTEcho(const char *pcBuf, uint32_t ui32Len)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < ui32Len; ui32Idx++)
+    {
+        if(pcBuf[ui32Idx] == '\n')
+        {
+            UARTEchoPut('\r');
+        }
+        UARTEchoPut(pcBuf[ui32Idx]);
     }
 }
 #endif
+#endif
 
 //*****************************************************************************
 //
@@ -333,6 +737,10 @@ UARTPrimeTransmit(uint32_t ui32Base)
 void
 UARTStdioConfig(uint32_t ui32PortNum, uint32_t ui32Baud, uint32_t ui32SrcClock)
 {
+#ifdef UART_BUFFERED
+    uint32_t ui32Ints;
+#endif
+
     //
     // Check the arguments.
     //
@@ -371,12 +779,75 @@ UARTStdioConfig(uint32_t ui32PortNum, uint32_t ui32Baud, uint32_t ui32SrcClock)
                             (UART_CONFIG_PAR_NONE | UART_CONFIG_STOP_ONE |
                              UART_CONFIG_WLEN_8));
 
+#if defined(UART_DMA) || defined(UART_RX_DMA)
+    //
+    // Enable the uDMA controller, giving it a control table if the
+    // application has not.
+    //
+    MAP_SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    if(!MAP_uDMAControlBaseGet())
+    {
+        MAP_uDMAEnable();
+        MAP_uDMAControlBaseSet(g_pui8UARTDMAControl);
+    }
+#endif
+
+#ifdef UART_DMA
+    //
+    // Set up the transmit channel to move bytes from memory into the UART
+    // data register.
+    //
+    g_ui32UARTTxChannel = g_ui32UARTTxDMA[ui32PortNum] & 0x1F;
+    MAP_uDMAChannelAssign(g_ui32UARTTxDMA[ui32PortNum]);
+    MAP_uDMAChannelAttributeDisable(g_ui32UARTTxChannel,
+                                    UDMA_ATTR_ALTSELECT |
+                                    UDMA_ATTR_HIGH_PRIORITY |
+                                    UDMA_ATTR_REQMASK);
+    MAP_uDMAChannelControlSet(g_ui32UARTTxChannel | UDMA_PRI_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_8 |
+                              UDMA_DST_INC_NONE | UDMA_ARB_4);
+    MAP_UARTDMAEnable(g_ui32Base, UART_DMA_TX);
+#endif
+
+#ifdef UART_RX_DMA
+    //
+    // Set up the receive channel to move bytes from the UART data register
+    // into the receive buffer, in bursts only.  The UART asks for a burst
+    // while its receive FIFO holds 8 bytes or more, and each burst takes 4,
+    // so at least 4 bytes of a message always stay in the FIFO.  That is
+    // what makes the UART raise its receive timeout interrupt once the line
+    // goes idle; were the FIFO emptied by the last burst, the end of the
+    // message would wait for the next one.  The channel is armed by
+    // UARTFlushRx() below.
+    //
+    g_ui32UARTRxChannel = g_ui32UARTRxDMA[ui32PortNum] & 0x1F;
+    MAP_uDMAChannelAssign(g_ui32UARTRxDMA[ui32PortNum]);
+    MAP_uDMAChannelAttributeDisable(g_ui32UARTRxChannel,
+                                    UDMA_ATTR_ALTSELECT |
+                                    UDMA_ATTR_HIGH_PRIORITY |
+                                    UDMA_ATTR_REQMASK);
+    MAP_uDMAChannelAttributeEnable(g_ui32UARTRxChannel, UDMA_ATTR_USEBURST);
+    MAP_uDMAChannelControlSet(g_ui32UARTRxChannel | UDMA_PRI_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_NONE |
+                              UDMA_DST_INC_8 | UDMA_ARB_4);
+    MAP_uDMAChannelControlSet(g_ui32UARTRxChannel | UDMA_ALT_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_NONE |
+                              UDMA_DST_INC_8 | UDMA_ARB_4);
+    MAP_UARTDMAEnable(g_ui32Base, UART_DMA_RX);
+#endif
+
 #ifdef UART_BUFFERED
     //
     // Set the UART to interrupt whenever the TX FIFO is almost empty or
-    // when any character is received.
+    // when any character is received.  With UART_DMA the same level makes
+    // the UART request a burst of 4 bytes once there is room for them.  With
+    // UART_RX_DMA the receive level is half full, twice the burst size.
     //
+#ifdef UART_RX_DMA
+    MAP_UARTFIFOLevelSet(g_ui32Base, UART_FIFO_TX1_8, UART_FIFO_RX4_8);
+#else
     MAP_UARTFIFOLevelSet(g_ui32Base, UART_FIFO_TX1_8, UART_FIFO_RX1_8);
+#endif
 
     //
     // Flush both the buffers.
@@ -391,12 +862,23 @@ UARTStdioConfig(uint32_t ui32PortNum, uint32_t ui32Baud, uint32_t ui32SrcClock)
 
     //
     // We are configured for buffered output so enable the master interrupt
-    // for this UART and the receive interrupts.  We don't actually enable the
-    // transmit interrupt in the UART itself until some data has been placed
-    // in the transmit buffer.
+    // for this UART and the receive interrupts.  Receive FIFO overruns are
+    // counted.  With UART_RX_DMA the uDMA takes the received characters, and
+    // only the idle line timeout is of interest.  Without UART_DMA the
+    // transmit interrupt stays enabled too: it only fires as the transmit
+    // FIFO drains, and leaving it on means the interrupt mask is never
+    // changed while characters are being written.
     //
     MAP_UARTIntDisable(g_ui32Base, 0xFFFFFFFF);
-    MAP_UARTIntEnable(g_ui32Base, UART_INT_RX | UART_INT_RT);
+#ifdef UART_RX_DMA
+    ui32Ints = UART_INT_RT | UART_INT_OE;
+#else
+    ui32Ints = UART_INT_RX | UART_INT_RT | UART_INT_OE;
+#endif
+#ifndef UART_DMA
+    ui32Ints |= UART_INT_TX;
+#endif
+    MAP_UARTIntEnable(g_ui32Base, ui32Ints);
     MAP_IntEnable(g_ui32UARTInt[ui32PortNum]);
 #endif
 
@@ -427,7 +909,14 @@ UARTStdioConfig(uint32_t ui32PortNum, uint32_t ui32Baud, uint32_t ui32SrcClock)
 //! all the characters have been written to the output FIFO.  In buffered mode,
 //! the characters are written to the UART transmit buffer and the call returns
 //! immediately.  If insufficient space remains in the transmit buffer,
-//! additional characters are discarded.
+//! additional characters are discarded.  With \b UART_DMA the space is that
+//! of one half of the buffer, plus the other half once the uDMA has finished
+//! sending it.
+//!
+//! In buffered mode without \b UART_DMA the transmit buffer is shared with
+//! the interrupt handler without disabling interrupts, which relies on this
+//! function, and so UARTprintf(), being called from one context only: the
+//! application's main loop or a single task, but not interrupt handlers.
 //!
 //! \return Returns the count of characters written.
 //
@@ -435,8 +924,104 @@ UARTStdioConfig(uint32_t ui32PortNum, uint32_t ui32Baud, uint32_t ui32SrcClock)
 int
 UARTwrite(const char *pcBuf, uint32_t ui32Len)
 {
-#ifdef UART_BUFFERED
+#if defined(UART_DMA)
+    unsigned int uIdx;
+    uint32_t ui32Run;
+    uint32_t ui32Copy;
+    uint32_t ui32Fill;
+
+    //
+    // Check for valid arguments.
+    //
+    ASSERT(pcBuf != 0);
+    ASSERT(g_ui32Base != 0);
+
+    //
+    // Keep the transfer complete interrupt from switching halves while we
+    // are filling one.  This is also called from the interrupt handler, where
+    // this changes nothing.
+    //
+    MAP_IntDisable(g_ui32UARTInt[g_ui32PortNum]);
+
+    //
+    // Send the characters a run at a time, each run ending at a \n that has
+    // to be sent as \r\n.
+    //
+    uIdx = 0;
+    while(uIdx < ui32Len)
+    {
+        //
+        // Copy the characters up to the next \n or null into the half being
+        // filled, starting to send it if it has no room and the other half
+        // is done.
+        //
+        ui32Run = UARTPlainRun(pcBuf + uIdx, ui32Len - uIdx);
+        while(ui32Run)
+        {
+            if(TX_BUFFER_FULL)
+            {
+                UARTPrimeTransmit(g_ui32Base);
+                if(TX_BUFFER_FULL)
+                {
+                    break;
+                }
+            }
+
+            ui32Fill = g_ui32UARTTxFill;
+            ui32Copy = TX_BUFFER_FREE;
+            if(ui32Copy > ui32Run)
+            {
+                ui32Copy = ui32Run;
+            }
+            memcpy(&g_pcUARTTxBuffer[ui32Fill][g_pui32UARTTxCount[ui32Fill]],
+                   pcBuf + uIdx, ui32Copy);
+            g_pui32UARTTxCount[ui32Fill] += ui32Copy;
+            uIdx += ui32Copy;
+            ui32Run -= ui32Copy;
+        }
+
+        //
+        // Stop at the end of the string, or if the buffer is full - discard
+        // remaining characters and return.
+        //
+        if(ui32Run || (uIdx == ui32Len) || (pcBuf[uIdx] == 0))
+        {
+            break;
+        }
+
+        //
+        // This is a \n, which takes two bytes.
+        //
+        if(TX_BUFFER_FREE < 2)
+        {
+            UARTPrimeTransmit(g_ui32Base);
+            if(TX_BUFFER_FREE < 2)
+            {
+                break;
+            }
+        }
+        TX_BUFFER_PUT('\r');
+        TX_BUFFER_PUT('\n');
+        uIdx++;
+    }
+
+    //
+    // Start sending if the uDMA is idle; otherwise the characters go out
+    // with the next block.
+    //
+    UARTPrimeTransmit(g_ui32Base);
+    MAP_IntEnable(g_ui32UARTInt[g_ui32PortNum]);
+
+    //
+    // Return the number of characters written.
+    //
+    return(uIdx);
+#elif defined(UART_BUFFERED)
     unsigned int uIdx;
+    uint32_t ui32Run;
+    uint32_t ui32Free;
+    uint32_t ui32Write;
+    uint32_t ui32Start;
 
     //
     // Check for valid arguments.
@@ -445,60 +1030,55 @@ UARTwrite(const char *pcBuf, uint32_t ui32Len)
     ASSERT(g_ui32Base != 0);
 
     //
-    // Send the characters
+    // Find out how much room there is once rather than for every character.
+    // Meanwhile the interrupt handler can only make more.
     //
-    for(uIdx = 0; uIdx < ui32Len; uIdx++)
+    ui32Start = g_ui32UARTTxWriteIndex;
+    ui32Write = ui32Start;
+    ui32Free = TX_BUFFER_FREE;
+
+    //
+    // Send the characters a run at a time, each run ending at a \n that has
+    // to be sent as \r\n.
+    //
+    uIdx = 0;
+    while(uIdx < ui32Len)
     {
         //
-        // If the character to the UART is \n, then add a \r before it so that
-        // \n is translated to \n\r in the output.
+        // Copy the characters up to the next \n or null into the buffer, as
+        // many as fit.
         //
-        if(pcBuf[uIdx] == '\n')
+        ui32Run = UARTPlainRun(pcBuf + uIdx, ui32Len - uIdx);
+        if(ui32Run > ui32Free)
         {
-            if(!TX_BUFFER_FULL)
-            {
-                g_pcUARTTxBuffer[g_ui32UARTTxWriteIndex] = '\r';
-                ADVANCE_TX_BUFFER_INDEX(g_ui32UARTTxWriteIndex);
-            }
-            else
-            {
-                //
-                // Buffer is full - discard remaining characters and return.
-                //
-                break;
-            }
+            ui32Run = ui32Free;
         }
-        else if(pcBuf[uIdx] == 0)
-		{
-        	break;
-		}
+        UARTTxBufferCopy(ui32Write, pcBuf + uIdx, ui32Run);
+        ui32Write += ui32Run;
+        ui32Free -= ui32Run;
+        uIdx += ui32Run;
 
         //
-        // Send the character to the UART output.
+        // Stop at the end of the string, or if the buffer is full - discard
+        // remaining characters and return.  Otherwise this is a \n, which
+        // takes two bytes.
         //
-        if(!TX_BUFFER_FULL)
-        {
-            g_pcUARTTxBuffer[g_ui32UARTTxWriteIndex] = pcBuf[uIdx];
-            ADVANCE_TX_BUFFER_INDEX(g_ui32UARTTxWriteIndex);
-        }
-        else
+        if((uIdx == ui32Len) || (pcBuf[uIdx] == 0) || (ui32Free < 2))
         {
-            //
-            // Buffer is full - discard remaining characters and return.
-            //
             break;
         }
+
+        g_pcUARTTxBuffer[TX_BUFFER_OFFSET(ui32Write)] = '\r';
+        g_pcUARTTxBuffer[TX_BUFFER_OFFSET(ui32Write + 1)] = '\n';
+        ui32Write += 2;
+        ui32Free -= 2;
+        uIdx++;
     }
 
     //
-    // If we have anything in the buffer, make sure that the UART is set
-    // up to transmit it.
+    // Hand the characters to the interrupt handler.
     //
-    if(!TX_BUFFER_EMPTY)
-    {
-        UARTPrimeTransmit(g_ui32Base);
-        MAP_UARTIntEnable(g_ui32Base, UART_INT_TX);
-    }
+    UARTTxPublish(ui32Start, ui32Write);
 
     //
     // Return the number of characters written.
@@ -544,6 +1124,119 @@ UARTwrite(const char *pcBuf, uint32_t ui32Len)
 #endif
 }
 
+//*****************************************************************************
+//
+//! Sends a block of binary data to the UART.
+//!
+//! \param pucData points to the bytes to send.
+//! \param ui32Len is the number of bytes to send.
+//!
+//! This function sends the bytes exactly as given, nulls and \\n included,
+//! for binary protocols that share the port with the text console.  In
+//! buffered mode the block is queued whole or not at all, so it never reaches
+//! the UART cut short or with text in the middle of it; with \b UART_DMA it
+//! must fit in half of the transmit buffer.  Without \b UART_DMA, characters
+//! echoed meanwhile wait until the block has gone and are dropped if more are
+//! typed than the small echo buffer holds, so an application that keeps the
+//! transmit buffer full of blocks loses its echo.  The same rule applies as
+//! for UARTwrite(): call it from the context that writes the console text.
+//! In unbuffered mode it blocks until the last byte is in the UART transmit
+//! FIFO.
+//!
+//! \return Returns \b true if the block was sent or queued, or \b false if
+//! there was no room for it in the transmit buffer.
+//
+//*****************************************************************************
+bool
+UARTTxBlock(const unsigned char *pucData, uint32_t ui32Len)
+{
+#if defined(UART_DMA)
+    bool bQueued;
+
+    //
+    // Check for valid arguments.
+    //
+    ASSERT(pucData != 0);
+    ASSERT(g_ui32Base != 0);
+
+    //
+    // Keep the transfer complete interrupt from switching halves while we
+    // are filling one.
+    //
+    MAP_IntDisable(g_ui32UARTInt[g_ui32PortNum]);
+
+    //
+    // If the half being filled has no room, start sending it if the other
+    // half is done, then copy the block in if it fits.
+    //
+    if(TX_BUFFER_FREE < ui32Len)
+    {
+        UARTPrimeTransmit(g_ui32Base);
+    }
+    bQueued = (TX_BUFFER_FREE >= ui32Len);
+    if(bQueued)
+    {
+        memcpy(&g_pcUARTTxBuffer[g_ui32UARTTxFill]
+                                [g_pui32UARTTxCount[g_ui32UARTTxFill]],
+               pucData, ui32Len);
+        g_pui32UARTTxCount[g_ui32UARTTxFill] += ui32Len;
+    }
+
+    //
+    // Start sending if the uDMA is idle.
+    //
+    UARTPrimeTransmit(g_ui32Base);
+    MAP_IntEnable(g_ui32UARTInt[g_ui32PortNum]);
+
+    return(bQueued);
+#elif defined(UART_BUFFERED)
+    uint32_t ui32Start;
+
+    //
+    // Check for valid arguments.
+    //
+    ASSERT(pucData != 0);
+    ASSERT(g_ui32Base != 0);
+
+    //
+    // Is there room for the whole block?
+    //
+    if(TX_BUFFER_FREE < ui32Len)
+    {
+        return(false);
+    }
+
+    //
+    // Copy it in, mark where it ends so that no echo is sent until it has
+    // gone, and hand it to the interrupt handler.
+    //
+    ui32Start = g_ui32UARTTxWriteIndex;
+    UARTTxBufferCopy(ui32Start, (const char *)pucData, ui32Len);
+    g_ui32UARTTxBlockEnd = ui32Start + ui32Len;
+    UARTTxPublish(ui32Start, ui32Start + ui32Len);
+
+    return(true);
+#else
+    uint32_t ui32Idx;
+
+    //
+    // Check for valid UART base address, and valid arguments.
+    //
+    ASSERT(g_ui32Base != 0);
+    ASSERT(pucData != 0);
+
+    //
+    // Send the bytes.
+    //
+    for(ui32Idx = 0; ui32Idx < ui32Len; ui32Idx++)
+    {
+        MAP_UARTCharPut(g_ui32Base, pucData[ui32Idx]);
+    }
+
+    return(true);
+#endif
+}
+
 //*****************************************************************************
 //
 //! A simple UART based get string function, with some line processing.
@@ -578,7 +1271,17 @@ UARTgets(char *pcBuf, uint32_t ui32Len)
 {
 #ifdef UART_BUFFERED
     uint32_t ui32Count = 0;
-    int8_t cChar;
+    uint32_t ui32Typed = 0;
+    uint32_t ui32Avail;
+    uint32_t ui32Run;
+    uint32_t ui32Copy;
+    const unsigned char *pucData;
+    unsigned char ucChar;
+#ifdef UART_RX_DMA
+    bool bEdit = false;
+#else
+    bool bEdit = !g_bDisableEcho;
+#endif
 
     //
     // Check the arguments.
@@ -594,47 +1297,72 @@ UARTgets(char *pcBuf, uint32_t ui32Len)
     ui32Len--;
 
     //
-    // Process characters until a newline is received.
+    // Process characters until a newline is received, taking them from the
+    // receive buffer as many at a time as are contiguous there.
     //
     while(1)
     {
+        ui32Avail = UARTRxSpan(&pucData);
+
         //
-        // Read the next character from the receive buffer.
+        // See if a newline or escape character was received, or a backspace
+        // if the interrupt handler passes those on while echoing.
         //
-        if(!RX_BUFFER_EMPTY)
+        for(ui32Run = 0; ui32Run < ui32Avail; ui32Run++)
         {
-            cChar = g_pcUARTRxBuffer[g_ui32UARTRxReadIndex];
-            ADVANCE_RX_BUFFER_INDEX(g_ui32UARTRxReadIndex);
-
-            //
-            // See if a newline or escape character was received.
-            //
-            if((cChar == '\r') || (cChar == '\n') || (cChar == 0x1b))
+            if((pucData[ui32Run] == '\r') || (pucData[ui32Run] == '\n') ||
+               (pucData[ui32Run] == 0x1b) || (bEdit && (pucData[ui32Run] == '\b')))
             {
-                //
-                // Stop processing the input and end the line.
-                //
                 break;
             }
+        }
 
-            //
-            // Process the received character as long as we are not at the end
-            // of the buffer.  If the end of the buffer has been reached then
-            // all additional characters are ignored until a newline is
-            // received.
-            //
-            if(ui32Count < ui32Len)
-            {
-                //
-                // Store the character in the caller supplied buffer.
-                //
-                pcBuf[ui32Count] = cChar;
+        //
+        // Store the characters before it in the caller supplied buffer as
+        // long as we are not at the end of the buffer.  If the end of the
+        // buffer has been reached then all additional characters are ignored
+        // until a newline is received.
+        //
+        ui32Copy = ui32Len - ui32Count;
+        if(ui32Copy > ui32Run)
+        {
+            ui32Copy = ui32Run;
+        }
+        memcpy(pcBuf + ui32Count, pucData, ui32Copy);
+        ui32Count += ui32Copy;
+        ui32Typed += ui32Run;
 
-                //
-                // Increment the count of characters received.
-                //
-                ui32Count++;
-            }
+        //
+        // Remove them from the receive buffer, along with the character that
+        // stopped the scan if there was one.
+        //
+        if(ui32Run == ui32Avail)
+        {
+            UARTRxConsume(ui32Run);
+            continue;
+        }
+        ucChar = pucData[ui32Run];
+        UARTRxConsume(ui32Run + 1);
+
+        //
+        // A newline or escape ends the line.
+        //
+        if(ucChar != '\b')
+        {
+            break;
+        }
+
+        //
+        // A backspace deletes the last character typed, which is only in the
+        // caller's buffer if it was not one of those ignored.
+        //
+        if(ui32Typed)
+        {
+            ui32Typed--;
+        }
+        if(ui32Count > ui32Typed)
+        {
+            ui32Count = ui32Typed;
         }
     }
 
@@ -785,7 +1513,9 @@ UARTgets(char *pcBuf, uint32_t ui32Len)
 //! In both buffered and unbuffered modes, this function will block until a
 //! character is received.  If non-blocking operation is required in buffered
 //! mode, a call to UARTRxAvail() may be made to determine whether any
-//! characters are currently available for reading.
+//! characters are currently available for reading.  In buffered mode with echo
+//! enabled, a backspace that rubbed out a character on the terminal is
+//! returned as \b '\\b'; see UARTEchoSet().
 //!
 //! \return Returns the character read.
 //
@@ -810,7 +1540,8 @@ UARTgetc(void)
     //
     // Read a character from the buffer.
     //
-    cChar = g_pcUARTRxBuffer[g_ui32UARTRxReadIndex];
+    cChar = RX_BUFFER_CHAR(g_ui32UARTRxReadIndex);
+    MEMORY_BARRIER();
     ADVANCE_RX_BUFFER_INDEX(g_ui32UARTRxReadIndex);
 
     //
@@ -1390,7 +2121,7 @@ UARTPeek(unsigned char ucChar)
     //
     for(iCount = 0; iCount < iAvail; iCount++)
     {
-        if(g_pcUARTRxBuffer[ui32ReadIndex] == ucChar)
+        if(RX_BUFFER_CHAR(ui32ReadIndex) == ucChar)
         {
             //
             // We found it so return the index
@@ -1414,6 +2145,114 @@ UARTPeek(unsigned char ucChar)
 }
 #endif
 
+//*****************************************************************************
+//
+//! Gives direct access to the oldest unread data in the receive buffer.
+//!
+//! \param ppucData is set to point to the first unread byte.
+//!
+//! This function, available only when the module is built to operate in
+//! buffered mode using \b UART_BUFFERED, returns the longest run of unread
+//! bytes that is contiguous in memory, so that a parser can work on them in
+//! place.  When the data wraps around the end of the buffer, the rest is
+//! returned by the next call once these bytes have been released with
+//! UARTRxConsume().  With \b UART_RX_DMA the uDMA keeps writing while the
+//! data is parsed; the bytes returned stay valid as long as the reader keeps
+//! within half of the buffer of the incoming data.
+//!
+//! \return Returns the number of bytes available at *\e ppucData.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) || defined(DOXYGEN)
+uint32_t
+UARTRxSpan(const unsigned char **ppucData)
+{
+    uint32_t ui32Avail;
+    uint32_t ui32Offset;
+
+    //
+    // How many characters are there in the receive buffer, and where does
+    // the first one sit?
+    //
+    ui32Avail = RX_BUFFER_USED;
+    ui32Offset = RX_BUFFER_OFFSET(g_ui32UARTRxReadIndex);
+
+    //
+    // Stop at the end of the buffer.
+    //
+    *ppucData = &g_pcUARTRxBuffer[ui32Offset];
+    if(ui32Avail > (UART_RX_BUFFER_SIZE - ui32Offset))
+    {
+        ui32Avail = UART_RX_BUFFER_SIZE - ui32Offset;
+    }
+
+    return(ui32Avail);
+}
+#endif
+
+//*****************************************************************************
+//
+//! Releases data returned by UARTRxSpan().
+//!
+//! \param ui32Count is the number of bytes to remove from the front of the
+//! receive buffer.  It must not exceed the count returned by UARTRxSpan().
+//!
+//! This function, available only when the module is built to operate in
+//! buffered mode using \b UART_BUFFERED, frees space in the receive buffer
+//! once the caller has finished with data it accessed in place.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) || defined(DOXYGEN)
+void
+UARTRxConsume(uint32_t ui32Count)
+{
+    MEMORY_BARRIER();
+    ADVANCE_RX_BUFFER_INDEX_BY(g_ui32UARTRxReadIndex, ui32Count);
+}
+#endif
+
+//*****************************************************************************
+//
+//! Reports receive data lost since the UART console was configured.
+//!
+//! \param pui32Dropped is set to the number of bytes lost because the receive
+//! buffer was full: discarded on arrival, or with \b UART_RX_DMA overwritten
+//! before they were read.
+//! \param pui32Overruns is set to the number of times the UART receive FIFO
+//! overflowed because it was not serviced in time.
+//!
+//! This function, available only when the module is built to operate in
+//! buffered mode using \b UART_BUFFERED, may be used to check whether the
+//! receive buffer and interrupt latency are adequate for the incoming data.
+//! Either pointer may be NULL.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) || defined(DOXYGEN)
+void
+UARTRxOverrunGet(uint32_t *pui32Dropped, uint32_t *pui32Overruns)
+{
+#ifdef UART_RX_DMA
+    //
+    // Account for data overwritten since the reader last looked.
+    //
+    GetRxDMACount();
+#endif
+
+    if(pui32Dropped)
+    {
+        *pui32Dropped = g_ui32UARTRxDropped;
+    }
+    if(pui32Overruns)
+    {
+        *pui32Overruns = g_ui32UARTRxOverruns;
+    }
+}
+#endif
+
 //*****************************************************************************
 //
 //! Flushes the receive buffer.
@@ -1442,6 +2281,18 @@ UARTFlushRx(void)
     g_ui32UARTRxReadIndex = 0;
     g_ui32UARTRxWriteIndex = 0;
 
+#ifdef UART_RX_DMA
+    //
+    // Restart the uDMA at the beginning of the buffer, primary control
+    // structure first.
+    //
+    MAP_uDMAChannelDisable(g_ui32UARTRxChannel);
+    MAP_uDMAChannelAttributeDisable(g_ui32UARTRxChannel, UDMA_ATTR_ALTSELECT);
+    UARTRxDMAArm(UDMA_PRI_SELECT);
+    UARTRxDMAArm(UDMA_ALT_SELECT);
+    MAP_uDMAChannelEnable(g_ui32UARTRxChannel);
+#endif
+
     //
     // If interrupts were enabled when we turned them off, turn them
     // back on again.
@@ -1489,8 +2340,20 @@ UARTFlushTx(bool bDiscard)
         //
         // Flush the transmit buffer.
         //
+#ifdef UART_DMA
+        //
+        // Drop the block being sent too; the UART FIFO still sends what the
+        // uDMA has already put there.
+        //
+        MAP_uDMAChannelDisable(g_ui32UARTTxChannel);
+        g_bUARTTxBusy = false;
+        g_pui32UARTTxCount[0] = 0;
+        g_pui32UARTTxCount[1] = 0;
+#else
         g_ui32UARTTxReadIndex = 0;
         g_ui32UARTTxWriteIndex = 0;
+        g_ui32UARTTxBlockEnd = 0;
+#endif
 
         //
         // If interrupts were enabled when we turned them off, turn them
@@ -1528,7 +2391,13 @@ UARTFlushTx(bool bDiscard)
 //! where this module is being used to provide a convenient, buffered serial
 //! interface over which application-specific binary protocols are being run,
 //! however, echo may be undesirable and this function can be used to disable
-//! it.
+//! it.  While echo is enabled, a backspace rubs out the last character of
+//! the current line on the terminal and is passed on to the reader, since
+//! that character may already have been read: UARTgets() removes it from the
+//! line, UARTgetc() and the other reading functions return the backspace
+//! itself.  With echo disabled, and always with \b UART_RX_DMA where received
+//! characters are stored by the uDMA without passing through the CPU,
+//! backspace is an ordinary character.
 //!
 //! \return None.
 //
@@ -1548,7 +2417,14 @@ UARTEchoSet(bool bEnable)
 //! This function handles interrupts from the UART.  It will copy data from the
 //! transmit buffer to the UART transmit FIFO if space is available, and it
 //! will copy data from the UART receive FIFO to the receive buffer if data is
-//! available.
+//! available.  With \b UART_DMA and \b UART_RX_DMA the uDMA moves the data,
+//! and this handler only restarts it and updates the buffer indices, as
+//! transfers complete and when the receive line goes idle.
+//!
+//! Otherwise the handler is the only code that takes characters out of the
+//! transmit buffer or puts them into the receive buffer, while the
+//! application only does the reverse, so neither side has to disable the
+//! other.  UARTwrite() pends this interrupt to start transmission.
 //!
 //! \return None.
 //
@@ -1558,9 +2434,11 @@ void
 UARTStdioIntHandler(void)
 {
     uint32_t ui32Ints;
+#ifndef UART_RX_DMA
     int8_t cChar;
     int32_t i32Char;
     static bool bLastWasCR = false;
+#endif
 
     //
     // Get and clear the current interrupt source(s)
@@ -1568,25 +2446,74 @@ UARTStdioIntHandler(void)
     ui32Ints = MAP_UARTIntStatus(g_ui32Base, true);
     MAP_UARTIntClear(g_ui32Base, ui32Ints);
 
+#ifdef UART_DMA
     //
-    // Are we being interrupted because the TX FIFO has space available?
+    // On this device completion of a uDMA transfer for the UART is signalled
+    // on the UART's own interrupt, with no status bit in the UART.  Has the
+    // block being sent finished?
     //
-    if(ui32Ints & UART_INT_TX)
+    if(g_bUARTTxBusy &&
+       (MAP_uDMAChannelModeGet(g_ui32UARTTxChannel | UDMA_PRI_SELECT) ==
+        UDMA_MODE_STOP))
     {
         //
-        // Move as many bytes as we can into the transmit FIFO.
+        // The half is free again; send whatever has been written to the
+        // other one meanwhile.
         //
+        g_pui32UARTTxCount[g_ui32UARTTxFill ^ 1] = 0;
+        g_bUARTTxBusy = false;
         UARTPrimeTransmit(g_ui32Base);
+    }
+#endif
 
-        //
-        // If the output buffer is empty, turn off the transmit interrupt.
-        //
-        if(TX_BUFFER_EMPTY)
+    //
+    // Count receive FIFO overruns.  The UART has already thrown the data
+    // away.
+    //
+    if(ui32Ints & UART_INT_OE)
+    {
+        g_ui32UARTRxOverruns++;
+        MAP_UARTRxErrorClear(g_ui32Base);
+    }
+
+#ifdef UART_RX_DMA
+    //
+    // Re-arm any half of the receive buffer the uDMA has filled; it has
+    // moved on to the other half.
+    //
+    if(MAP_uDMAChannelModeGet(g_ui32UARTRxChannel | UDMA_PRI_SELECT) ==
+       UDMA_MODE_STOP)
+    {
+        UARTRxDMAArm(UDMA_PRI_SELECT);
+    }
+    if(MAP_uDMAChannelModeGet(g_ui32UARTRxChannel | UDMA_ALT_SELECT) ==
+       UDMA_MODE_STOP)
+    {
+        UARTRxDMAArm(UDMA_ALT_SELECT);
+    }
+
+    //
+    // Has the line gone idle with bytes left in the receive FIFO below the
+    // burst request level?  Let the uDMA take them one at a time, then go
+    // back to bursts.  This takes no longer than moving a handful of bytes.
+    //
+    if(ui32Ints & UART_INT_RT)
+    {
+        MAP_uDMAChannelAttributeDisable(g_ui32UARTRxChannel,
+                                        UDMA_ATTR_USEBURST);
+        while(MAP_UARTCharsAvail(g_ui32Base))
         {
-            MAP_UARTIntDisable(g_ui32Base, UART_INT_TX);
         }
+        MAP_uDMAChannelAttributeEnable(g_ui32UARTRxChannel,
+                                       UDMA_ATTR_USEBURST);
     }
 
+    //
+    // Either way, publish what has arrived.  This is all the receive path
+    // does; the data itself is never touched.
+    //
+    UARTRxDMAUpdate();
+#else
     //
     // Are we being interrupted due to a received character?
     //
@@ -1617,28 +2544,27 @@ UARTStdioIntHandler(void)
                 if(cChar == '\b')
                 {
                     //
-                    // If there are any characters already in the buffer, then
-                    // delete the last.
+                    // If there are any characters of the current line on the
+                    // terminal, and room to pass the backspace on to the
+                    // reader, then delete the last.
                     //
-                    if(!RX_BUFFER_EMPTY)
+                    if(g_ui32UARTRxLineCount && !RX_BUFFER_FULL)
                     {
                         //
                         // Rub out the previous character on the users
                         // terminal.
                         //
-                        UARTwrite("\b \b", 3);
+                        UARTEcho("\b \b", 3);
+                        g_ui32UARTRxLineCount--;
 
                         //
-                        // Decrement the number of characters in the buffer.
+                        // The character may already have been read, so
+                        // rather than taking it back, store the backspace for
+                        // UARTgets() to remove it from its line.
                         //
-                        if(g_ui32UARTRxWriteIndex == 0)
-                        {
-                            g_ui32UARTRxWriteIndex = UART_RX_BUFFER_SIZE - 1;
-                        }
-                        else
-                        {
-                            g_ui32UARTRxWriteIndex--;
-                        }
+                        RX_BUFFER_CHAR(g_ui32UARTRxWriteIndex) = '\b';
+                        MEMORY_BARRIER();
+                        ADVANCE_RX_BUFFER_INDEX(g_ui32UARTRxWriteIndex);
                     }
 
                     //
@@ -1682,7 +2608,8 @@ UARTStdioIntHandler(void)
                     // receives both CR and LF.
                     //
                     cChar = '\r';
-                    UARTwrite("\n", 1);
+                    UARTEcho("\n", 1);
+                    g_ui32UARTRxLineCount = 0;
                 }
             }
 
@@ -1693,30 +2620,43 @@ UARTStdioIntHandler(void)
             if(!RX_BUFFER_FULL)
             {
                 //
-                // Store the new character in the receive buffer
+                // Store the new character in the receive buffer, then hand
+                // it to the reader.
                 //
-                g_pcUARTRxBuffer[g_ui32UARTRxWriteIndex] =
+                RX_BUFFER_CHAR(g_ui32UARTRxWriteIndex) =
                     (unsigned char)(i32Char & 0xFF);
+                MEMORY_BARRIER();
                 ADVANCE_RX_BUFFER_INDEX(g_ui32UARTRxWriteIndex);
 
                 //
-                // If echo is enabled, write the character to the transmit
-                // buffer so that the user gets some immediate feedback.
+                // If echo is enabled, send the character back so that the
+                // user gets some immediate feedback.
                 //
                 if(!g_bDisableEcho)
                 {
-                    UARTwrite((const char *)&cChar, 1);
+                    UARTEcho((const char *)&cChar, 1);
+                    if(cChar != '\r')
+                    {
+                        g_ui32UARTRxLineCount++;
+                    }
                 }
             }
+            else
+            {
+                g_ui32UARTRxDropped++;
+            }
         }
-
-        //
-        // If we wrote anything to the transmit buffer, make sure it actually
-        // gets transmitted.
-        //
-        UARTPrimeTransmit(g_ui32Base);
-        MAP_UARTIntEnable(g_ui32Base, UART_INT_TX);
     }
+#endif
+
+#ifndef UART_DMA
+    //
+    // Move as many bytes as we can into the transmit FIFO.  This is the
+    // transmit interrupt's job, and also how UARTwrite() gets a transfer
+    // going, by pending this interrupt, and how echoed characters go out.
+    //
+    UARTPrimeTransmit(g_ui32Base);
+#endif
 }
 #endif
 
@@ -0,0 +1,326 @@
+//*****************************************************************************
+//
+// uarttelemetry.c - Binary telemetry records sent over the UART console.
+//
+// Records are framed with COBS, checked with a CRC-16 and numbered, then
+// queued with UARTTxBlock() in between whatever text UARTprintf() sends, so
+// that one port carries both.  tools/telemetrydecode.c separates them again
+// on the PC.  The frame format is described in uarttelemetry.h.
+//
+// The functions share the transmit buffer with UARTwrite() and so must be
+// called from the same context as the console output: an interrupt handler
+// that samples data should leave it for the main loop to send.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driverlib/debug.h"
+#include "utils/uartstdio.h"
+#include "uarttelemetry.h"
+
+//*****************************************************************************
+//
+// The frame being built.  It is only needed until UARTTxBlock() has copied it
+// into the transmit buffer, and is kept off the stack.
+//
+//*****************************************************************************
+static unsigned char g_pucTelemetryFrame[UART_TELEMETRY_MAX_FRAME];
+
+//*****************************************************************************
+//
+// The COBS encoder state while a frame is built: the next free position, the
+// position of the code byte for the current run of non-zero bytes and that
+// run's code, and the CRC of the record so far.
+//
+//*****************************************************************************
+static uint32_t g_ui32TelemetryPos;
+static uint32_t g_ui32TelemetryCodePos;
+static uint32_t g_ui32TelemetryCode;
+static uint16_t g_ui16TelemetryCRC;
+
+//*****************************************************************************
+//
+// The sequence number of the next record, and counts of the records queued
+// and of those dropped for lack of room in the transmit buffer.  Dropped
+// records still use up a sequence number, so the receiver sees the gap.
+//
+//*****************************************************************************
+static uint16_t g_ui16TelemetrySeq;
+static uint32_t g_ui32TelemetrySent;
+static uint32_t g_ui32TelemetryDropped;
+
+//*****************************************************************************
+//
+// CRC-16/CCITT-FALSE, a byte at a time.
+//
+//*****************************************************************************
+static const uint16_t g_pui16TelemetryCRCTable[256] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+//*****************************************************************************
+//
+// Start a frame: the leading delimiter, and room for the first code byte.
+//
+//*****************************************************************************
+static void
+TelemetryFrameStart(void)
+{
+    g_pucTelemetryFrame[0] = 0;
+    g_ui32TelemetryCodePos = 1;
+    g_ui32TelemetryPos = 2;
+    g_ui32TelemetryCode = 1;
+    g_ui16TelemetryCRC = 0xFFFF;
+}
+
+//*****************************************************************************
+//
+// Add bytes to the frame being built, COBS encoding them.  A zero ends the
+// current run: its code byte is filled in and the zero itself becomes the
+// next run's code byte.  When bCRC is set the bytes are part of the record
+// covered by the CRC.
+//
+//*****************************************************************************
+static void
+TelemetryFrameAdd(const unsigned char *pucData, uint32_t ui32Len, bool bCRC)
+{
+    uint32_t ui32Pos;
+    uint32_t ui32Code;
+    uint16_t ui16CRC;
+    unsigned char ucByte;
+
+    ui32Pos = g_ui32TelemetryPos;
+    ui32Code = g_ui32TelemetryCode;
+    ui16CRC = g_ui16TelemetryCRC;
+
+    while(ui32Len--)
+    {
+        ucByte = *pucData++;
+        if(bCRC)
+        {
+            ui16CRC = (ui16CRC << 8) ^
+                      g_pui16TelemetryCRCTable[(ui16CRC >> 8) ^ ucByte];
+        }
+
+        if(ucByte)
+        {
+            g_pucTelemetryFrame[ui32Pos++] = ucByte;
+            ui32Code++;
+        }
+
+        //
+        // End the run on a zero, or once it reaches the longest a code byte
+        // can describe, which records are too short to do.
+        //
+        if(!ucByte || (ui32Code == 0xFF))
+        {
+            g_pucTelemetryFrame[g_ui32TelemetryCodePos] = ui32Code;
+            g_ui32TelemetryCodePos = ui32Pos++;
+            ui32Code = 1;
+        }
+    }
+
+    g_ui32TelemetryPos = ui32Pos;
+    g_ui32TelemetryCode = ui32Code;
+    g_ui16TelemetryCRC = ui16CRC;
+}
+
+//*****************************************************************************
+//
+// Finish the frame with the CRC and the closing delimiter, and queue it.
+//
+//*****************************************************************************
+static bool
+TelemetryFrameSend(void)
+{
+    unsigned char pucCRC[2];
+
+    pucCRC[0] = g_ui16TelemetryCRC & 0xFF;
+    pucCRC[1] = g_ui16TelemetryCRC >> 8;
+    TelemetryFrameAdd(pucCRC, 2, false);
+
+    g_pucTelemetryFrame[g_ui32TelemetryCodePos] = g_ui32TelemetryCode;
+    g_pucTelemetryFrame[g_ui32TelemetryPos++] = 0;
+
+    if(UARTTxBlock(g_pucTelemetryFrame, g_ui32TelemetryPos))
+    {
+        g_ui32TelemetrySent++;
+        return(true);
+    }
+
+    g_ui32TelemetryDropped++;
+    return(false);
+}
+
+//*****************************************************************************
+//
+// Start a record of the given type with the next sequence number.
+//
+//*****************************************************************************
+static void
+TelemetryRecordStart(uint8_t ui8Type)
+{
+    unsigned char pucHeader[3];
+
+    pucHeader[0] = ui8Type;
+    pucHeader[1] = g_ui16TelemetrySeq & 0xFF;
+    pucHeader[2] = g_ui16TelemetrySeq >> 8;
+    g_ui16TelemetrySeq++;
+
+    TelemetryFrameStart();
+    TelemetryFrameAdd(pucHeader, 3, true);
+}
+
+//*****************************************************************************
+//
+//! Sends a telemetry record.
+//!
+//! \param ui8Type is the record type, one of the \b UART_TELEMETRY_ values or
+//! an application type from \b UART_TELEMETRY_USER on.
+//! \param pvData points to the payload.
+//! \param ui32Len is the length of the payload, at most
+//! \b UART_TELEMETRY_MAX_PAYLOAD bytes.
+//!
+//! The record is framed and queued for transmission whole, between any
+//! console text written before and after it.  If the transmit buffer has no
+//! room for it the record is dropped, leaving a gap in the sequence numbers
+//! seen by the receiver.
+//!
+//! \return Returns \b true if the record was queued or \b false if it was
+//! dropped.
+//
+//*****************************************************************************
+bool
+UARTTelemetrySend(uint8_t ui8Type, const void *pvData, uint32_t ui32Len)
+{
+    ASSERT(ui32Len <= UART_TELEMETRY_MAX_PAYLOAD);
+
+    TelemetryRecordStart(ui8Type);
+    TelemetryFrameAdd(pvData, ui32Len, true);
+    return(TelemetryFrameSend());
+}
+
+//*****************************************************************************
+//
+//! Sends a block of ADC samples.
+//!
+//! \param ui32Time is the time stamp of the first sample, in whatever units
+//! the application uses.
+//! \param pui16Samples points to the samples.
+//! \param ui32Count is the number of samples, at most
+//! \b UART_TELEMETRY_ADC_MAX.
+//!
+//! This function sends a \b UART_TELEMETRY_ADC record.  Sending samples in
+//! blocks spreads the framing over many of them: a record of one sample takes
+//! 14 bytes on the wire, one of \b UART_TELEMETRY_ADC_MAX just over 2 a
+//! sample.
+//!
+//! \return Returns \b true if the record was queued or \b false if it was
+//! dropped.
+//
+//*****************************************************************************
+bool
+UARTTelemetryADC(uint32_t ui32Time, const uint16_t *pui16Samples,
+                 uint32_t ui32Count)
+{
+    ASSERT(ui32Count <= UART_TELEMETRY_ADC_MAX);
+
+    //
+    // The Cortex-M4 is little-endian, as the record is, so the values go in
+    // as they are stored.
+    //
+    TelemetryRecordStart(UART_TELEMETRY_ADC);
+    TelemetryFrameAdd((const unsigned char *)&ui32Time, 4, true);
+    TelemetryFrameAdd((const unsigned char *)pui16Samples, ui32Count * 2,
+                      true);
+    return(TelemetryFrameSend());
+}
+
+//*****************************************************************************
+//
+//! Sends the state of a control loop.
+//!
+//! \param ui32Time is the time stamp, in whatever units the application uses.
+//! \param i32Setpoint is the set point.
+//! \param i32Measured is the measured value.
+//! \param i32Output is the controller output.
+//!
+//! This function sends a \b UART_TELEMETRY_LOOP record.
+//!
+//! \return Returns \b true if the record was queued or \b false if it was
+//! dropped.
+//
+//*****************************************************************************
+bool
+UARTTelemetryLoop(uint32_t ui32Time, int32_t i32Setpoint, int32_t i32Measured,
+                  int32_t i32Output)
+{
+    int32_t pi32Values[4];
+
+    pi32Values[0] = (int32_t)ui32Time;
+    pi32Values[1] = i32Setpoint;
+    pi32Values[2] = i32Measured;
+    pi32Values[3] = i32Output;
+
+    return(UARTTelemetrySend(UART_TELEMETRY_LOOP, pi32Values,
+                             sizeof(pi32Values)));
+}
+
+//*****************************************************************************
+//
+//! Reports how many telemetry records have been sent and dropped.
+//!
+//! \param pui32Sent is set to the number of records queued for transmission.
+//! \param pui32Dropped is set to the number of records dropped because the
+//! transmit buffer was full.
+//!
+//! Either pointer may be NULL.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTTelemetryStatsGet(uint32_t *pui32Sent, uint32_t *pui32Dropped)
+{
+    if(pui32Sent)
+    {
+        *pui32Sent = g_ui32TelemetrySent;
+    }
+    if(pui32Dropped)
+    {
+        *pui32Dropped = g_ui32TelemetryDropped;
+    }
+}
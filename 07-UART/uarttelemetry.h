@@ -0,0 +1,80 @@
+//*****************************************************************************
+//
+// uarttelemetry.h - Binary telemetry records sent over the UART console.
+//
+//*****************************************************************************
+
+#ifndef __UARTTELEMETRY_H__
+#define __UARTTELEMETRY_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Each record is sent as one frame: a zero byte, the COBS encoding of
+//
+//     type (1 byte), sequence number (2), payload, CRC-16 (2)
+//
+// and another zero byte.  Multi-byte values are little-endian.  The CRC is
+// CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) over the type,
+// sequence number and payload.  COBS leaves no zero bytes inside the frame,
+// and console text never contains any, so a receiver can tell the two apart
+// on the same port.
+//
+// The payload is limited so that a record never needs more than one COBS
+// code byte, and a frame is at most UART_TELEMETRY_MAX_FRAME bytes.
+//
+//*****************************************************************************
+#define UART_TELEMETRY_MAX_PAYLOAD 248
+#define UART_TELEMETRY_MAX_FRAME (UART_TELEMETRY_MAX_PAYLOAD + 8)
+
+//*****************************************************************************
+//
+// Record types.  Types from UART_TELEMETRY_USER on are free for the
+// application.
+//
+// UART_TELEMETRY_ADC   uint32_t time stamp of the first sample, then the
+//                      samples as uint16_t, up to UART_TELEMETRY_ADC_MAX.
+// UART_TELEMETRY_LOOP  uint32_t time stamp, then int32_t set point,
+//                      measurement and controller output.
+//
+//*****************************************************************************
+#define UART_TELEMETRY_ADC      0x01
+#define UART_TELEMETRY_LOOP     0x02
+#define UART_TELEMETRY_USER     0x80
+
+#define UART_TELEMETRY_ADC_MAX  ((UART_TELEMETRY_MAX_PAYLOAD - 4) / 2)
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern bool UARTTelemetrySend(uint8_t ui8Type, const void *pvData,
+                              uint32_t ui32Len);
+extern bool UARTTelemetryADC(uint32_t ui32Time, const uint16_t *pui16Samples,
+                             uint32_t ui32Count);
+extern bool UARTTelemetryLoop(uint32_t ui32Time, int32_t i32Setpoint,
+                              int32_t i32Measured, int32_t i32Output);
+extern void UARTTelemetryStatsGet(uint32_t *pui32Sent,
+                                  uint32_t *pui32Dropped);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UARTTELEMETRY_H__
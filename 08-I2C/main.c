@@ -6,11 +6,50 @@
 #include "driverlib/gpio.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/i2c.h"
+#include "driverlib/ssi.h"
 
 #include "ssd1306.h"
 #include "ssd1306_fonts.h"
 
-// init I2C0: PB2 (SCL), PB3 (SDA), 400 kHz Fast Mode
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_SSI
+// SSI0 bit rate; the SSD1306 takes up to 10 MHz on its 4-wire SPI interface
+#define SSI0_BIT_HZ 10000000
+
+// init SSI0: PA2 (D0/SCK), PA3 (CS#), PA5 (D1/SDIN), PA6 (D/C), PA7 (RES#)
+void SSI0_Init()
+{
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_SSI0);
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+
+    // wait for peripherals to be ready
+    while(!SysCtlPeripheralReady(SYSCTL_PERIPH_SSI0));
+    while(!SysCtlPeripheralReady(SYSCTL_PERIPH_GPIOA));
+    while(!SysCtlPeripheralReady(SYSCTL_PERIPH_UDMA));
+
+    GPIOPinConfigure(GPIO_PA2_SSI0CLK);
+    GPIOPinConfigure(GPIO_PA3_SSI0FSS);
+    GPIOPinConfigure(GPIO_PA5_SSI0TX);
+    GPIOPinTypeSSI(GPIO_PORTA_BASE, GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_5);
+
+    // hold the controller in reset for a few microseconds
+    GPIOPinTypeGPIOOutput(GPIO_PORTA_BASE, GPIO_PIN_7);
+    GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_7, 0);
+    SysCtlDelay(SysCtlClockGet() / 3 / 10000);    // ~100 us
+    GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_7, GPIO_PIN_7);
+
+    SSIConfigSetExpClk(SSI0_BASE, SysCtlClockGet(), SSI_FRF_MOTO_MODE_0, SSI_MODE_MASTER,
+                       SSI0_BIT_HZ, 8);
+    SSIEnable(SSI0_BASE);
+}
+#else
+
+// I2C0 SCL rate: 400 kHz Fast-mode, within the SSD1306 spec. Define
+// I2C0_PROBE_MAX_HZ (e.g. 1000000 for Fast-mode Plus, which needs strong
+// pull-ups) to step up to the fastest rate the panel passes at start-up.
+#define I2C0_SCL_HZ 400000
+
+// init I2C0: PB2 (SCL), PB3 (SDA), I2C0_SCL_HZ
 void I2C0_Init()
 {
     SysCtlPeripheralEnable(SYSCTL_PERIPH_I2C0);
@@ -26,15 +65,25 @@ void I2C0_Init()
     GPIOPinTypeI2C(GPIO_PORTB_BASE, GPIO_PIN_3);
 
     I2CMasterInitExpClk(I2C0_BASE, SysCtlClockGet(), true);
+    SSD1306_SetBusSpeed(I2C0_BASE, SysCtlClockGet(), I2C0_SCL_HZ);
     I2CMasterEnable(I2C0_BASE);
 }
+#endif
 
 int main()
 {
     SysCtlClockSet(SYSCTL_XTAL_16MHZ | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN | SYSCTL_SYSDIV_2_5); // 80 MHz
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_SSI
+    SSI0_Init();
+    SSD1306_Init(SSI0_BASE, GPIO_PORTA_BASE, GPIO_PIN_6);
+#else
     I2C0_Init();
-
     SSD1306_Init(I2C0_BASE, SSD1306_I2C_ADDR);
+#ifdef I2C0_PROBE_MAX_HZ
+    // stays at 100 kHz if not even that passes
+    SSD1306_ProbeBusSpeed(SysCtlClockGet(), I2C0_PROBE_MAX_HZ);
+#endif
+#endif
     SSD1306_Clear();
 
     ssd1306_SetFont(&Font8x12_bold);
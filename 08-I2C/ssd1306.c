@@ -1,6 +1,8 @@
 #include "ssd1306.h"
+#include "ssd1306_transport.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -9,7 +11,6 @@
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "driverlib/sysctl.h"
-#include "driverlib/i2c.h"
 #include "driverlib/gpio.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/rom.h"
@@ -17,105 +18,63 @@
 #include "driverlib/pwm.h"
 #include "inc/hw_gpio.h"
 
-#define SSD1306_CMD  0x00
-#define SSD1306_DATA 0x40
-
-static uint32_t g_i2c_base = 0;
-static uint8_t  g_i2c_addr = SSD1306_I2C_ADDR;
-
-#if (SSD1306_WIDTH != 128)
-#error "This driver currently expects 128 pixel width. Adjust code if needed."
+#if (SSD1306_STRIDE > 128)
+#error "The SSD1306 has 128 columns; SSD1306_STRIDE cannot be larger."
+#endif
+#if (SSD1306_WIDTH > SSD1306_STRIDE || SSD1306_HEIGHT > 8 * SSD1306_MAX_PAGES)
+#error "Default display geometry does not fit the framebuffer layout."
+#endif
+#if (SSD1306_MAX_WINDOWS < SSD1306_MAX_PAGES)
+#error "SSD1306_MAX_WINDOWS must allow one window per page."
+#endif
+#if (SSD1306_CMD_QUEUE < 13)
+#error "SSD1306_CMD_QUEUE must hold one command of each kind (13 bytes)."
 #endif
 
-static uint8_t buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
-
-static const FontDef *current_font = &Font6x8;
-static int16_t cursor_x = 0;
-static int16_t cursor_y = 0;
-
-// --- Low level I2C write helpers ---
-static void i2cWrite(uint8_t controlByte, const uint8_t *data, uint32_t len)
-{
-    // controlByte = 0x00 for command, 0x40 for data
-    // Many SSD1306 I2C displays expect the control byte as the first transmitted byte in the payload.
-    // We'll send: [slave addr + WR] -> [controlByte] [payload...]
-    // Tiva I2C supports multi-byte transfers via MasterDataPut and MasterControl.
-    // Build temporary buffer in RAM if necessary:
-    // But to avoid malloc: send controlByte then each byte.
-    // Use single-byte writes (slower) but robust.
-    // Use blocking waits for simplicity.
-    uint32_t i;
-    for (i = 0; i < len; ++i) {
-        // For many modules, you must send control byte only once before a multi-byte stream.
-        // We'll send control byte for the first byte only, then only data bytes.
-        if (i == 0) {
-            // Put first byte as combined control + data by starting transmit and then data
-            // Use I2C Master in burst: first write controlByte, then data...
-            // Simpler approach: send a small local array with controlByte + data chunk <= 16
-            // But driverlib doesn't give a convenient multi-send without filling whole sequence.
-        }
-    }
-    // Simpler and compatible way: create a small stack buffer to hold controlByte + data up to some size.
-    // Many writes will be relatively small: commands or pages of 128 bytes. We will chunk.
-    #define CHUNK 32
-    uint8_t tmp[CHUNK + 1];
-    uint32_t offset = 0;
-    while (offset < len) {
-        uint32_t chunk = len - offset;
-        if (chunk > CHUNK) chunk = CHUNK;
-        tmp[0] = controlByte;
-        memcpy(&tmp[1], &data[offset], chunk);
-        // send tmp[0..chunk] as one I2C transaction
-        // Setup slave address, write mode
-        MAP_I2CMasterSlaveAddrSet(g_i2c_base, g_i2c_addr, false);
-        // Start transmission
-        MAP_I2CMasterDataPut(g_i2c_base, tmp[0]); // first byte (control)
-        MAP_I2CMasterControl(g_i2c_base, I2C_MASTER_CMD_BURST_SEND_START);
-        while (MAP_I2CMasterBusy(g_i2c_base));
-        uint32_t j = 0;
-        for (j = 0; j < chunk; ++j) {
-            MAP_I2CMasterDataPut(g_i2c_base, tmp[1 + j]);
-            if (j == chunk - 1) {
-                MAP_I2CMasterControl(g_i2c_base, I2C_MASTER_CMD_BURST_SEND_FINISH);
-            } else {
-                MAP_I2CMasterControl(g_i2c_base, I2C_MASTER_CMD_BURST_SEND_CONT);
-            }
-            while (MAP_I2CMasterBusy(g_i2c_base));
-        }
-        offset += chunk;
-    }
-    #undef CHUNK
-}
+// Default instance used by SSD1306_Init()
+static SSD1306_Device g_default_dev;
+static uint8_t g_default_fb[2][SSD1306_BUFFER_BYTES(SSD1306_HEIGHT)];
 
-static void i2cWriteCommand(uint8_t cmd)
-{
-    i2cWrite(SSD1306_CMD, &cmd, 1);
-}
+// Instance all drawing and flush calls operate on
+static SSD1306_Device *g_dev = &g_default_dev;
 
-static void i2cWriteCommands(const uint8_t *cmds, uint32_t len)
-{
-    i2cWrite(SSD1306_CMD, cmds, len);
-}
+#ifdef SSD1306_STATS
+// Cortex-M4 DWT cycle counter, used to time frame planning
+#define CORE_DEMCR          0xE000EDFC
+#define CORE_DEMCR_TRCENA   0x01000000
+#define DWT_CTRL            0xE0001000
+#define DWT_CTRL_CYCCNTENA  0x00000001
+#define DWT_CYCCNT          0xE0001004
+#endif
 
-static void i2cWriteData(const uint8_t *data, uint32_t len)
+// --- Command writes ---
+// Blocking, on the selected link; the traffic is charged to dev
+static bool writeCommands(SSD1306_Device *dev, const uint8_t *cmds, uint32_t len)
 {
-    i2cWrite(SSD1306_DATA, data, len);
+    if (len == 0) return true;
+    ssd1306_link_wait(dev);
+#ifdef SSD1306_STATS
+    dev->stats.transactions++;
+    dev->stats.bytes += SSD1306_LINK_BYTES(len);
+    dev->stats.bit_times += SSD1306_LINK_BIT_TIMES(len);
+#endif
+    return ssd1306_link_write(dev, SSD1306_CMD, cmds, len);
 }
 
 // --- SSD1306 commands ---
-static void ssd1306_command_init(void)
+void ssd1306_device_start(SSD1306_Device *dev)
 {
     const uint8_t init_seq[] = {
         0xAE, // display off
         0xD5, 0x80, // set display clock divide ratio/oscillator frequency
-        0xA8, (SSD1306_HEIGHT - 1), // multiplex
+        0xA8, (uint8_t)(dev->rows - 1), // multiplex
         0xD3, 0x00, // display offset
         0x40, // start line = 0
         0x8D, 0x14, // charge pump on
         0x20, 0x00, // memory addressing mode: horizontal addressing
         0xA1, // segment remap
         0xC8, // COM scan direction remapped
-        0xDA, 0x12, // COM pins hardware config (0x02 for 32px?)
+        0xDA, (dev->rows == 64) ? 0x12 : 0x02, // COM pins: alternative for 64 rows, sequential below
         0x81, 0xCF, // contrast
         0xD9, 0xF1, // pre-charge
         0xDB, 0x40, // vcom detect
@@ -124,60 +83,789 @@ static void ssd1306_command_init(void)
         0x2E, // deactivate scroll
         0xAF // display ON
     };
-    i2cWriteCommands(init_seq, sizeof(init_seq));
+    writeCommands(dev, init_seq, sizeof(init_seq));
 }
 
 // --- buffer helpers ---
-static inline void buffer_clear(void) {
-    memset(buffer, 0x00, sizeof(buffer));
+static inline void buffer_clear(SSD1306_Device *dev) {
+    memset(dev->buffer, 0x00, SSD1306_BUFFER_BYTES(dev->height));
+}
+
+static inline void dirty_clear(SSD1306_Device *dev) {
+    memset(dev->dirty_x0, 0xFF, sizeof(dev->dirty_x0));
+    memset(dev->dirty_x1, 0x00, sizeof(dev->dirty_x1));
+}
+
+// Grow the dirty span of pages covering rows y0..y1 to include columns x0..x1.
+// Coordinates must already be clipped to the screen.
+static void dirty_mark(SSD1306_Device *dev, int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    uint8_t p;
+    for (p = y0 / 8; p <= y1 / 8; ++p) {
+        if (x0 < dev->dirty_x0[p]) dev->dirty_x0[p] = x0;
+        if (x1 > dev->dirty_x1[p]) dev->dirty_x1[p] = x1;
+    }
+}
+
+void ssd1306_dirty_all(SSD1306_Device *dev)
+{
+    dirty_mark(dev, 0, 0, dev->width - 1, dev->height - 1);
+}
+
+void SSD1306_Invalidate(void)
+{
+    ssd1306_dirty_all(g_dev);
+    g_dev->shadow_valid = false;
 }
 
 void SSD1306_Clear(void)
 {
-    buffer_clear();
+    buffer_clear(g_dev);
+    ssd1306_dirty_all(g_dev);
     SSD1306_Display();
 }
 
+void SSD1306_SetDeltaFlush(bool on, uint8_t *shadow)
+{
+    ssd1306_link_wait(g_dev);
+    g_dev->delta = on;
+    g_dev->shadow = shadow;
+    // a new shadow is filled by the next flush
+    g_dev->shadow_valid = false;
+}
+
+// --- Flush planning ---
+static void desc_set(SSD1306_TxDesc *d, uint8_t control,
+                     const uint8_t *data, uint16_t len, uint16_t stride, uint8_t rows)
+{
+    d->control = control;
+    d->data = data;
+    d->len = len;
+    d->stride = stride;
+    d->rows = rows;
+}
+
+#ifdef SSD1306_STATS
+static void stats_flush(SSD1306_Device *dev, uint8_t n)
+{
+    const SSD1306_TxDesc *d = dev->desc;
+    uint32_t bytes = 0, bit_times = 0;
+    uint8_t i;
+    for (i = 0; i < n; ++i) {
+        uint32_t len = (uint32_t)d[i].len * d[i].rows;
+        bytes += SSD1306_LINK_BYTES(len);
+        bit_times += SSD1306_LINK_BIT_TIMES(len);
+    }
+    dev->stats.flushes++;
+    dev->stats.bytes += bytes;
+    dev->stats.transactions += n;
+    dev->stats.bit_times += bit_times;
+    dev->stats.last_bytes = bytes;
+    dev->stats.last_transactions = n;
+    dev->stats.last_bit_times = bit_times;
+}
+#endif
+
+// Window command plus data burst for columns x0..x1 of pages p0..p1 of fb.
+// Returns the new descriptor count.
+static uint8_t plan_window(SSD1306_Device *dev, uint8_t n, const uint8_t *fb,
+                           uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1)
+{
+    uint8_t *w = dev->window[n / 2];
+    w[0] = 0x21; w[1] = x0; w[2] = x1;      // column address
+    w[3] = 0x22; w[4] = p0; w[5] = p1;      // page address
+    desc_set(&dev->desc[n++], SSD1306_CMD, w, 6, 6, 1);
+    desc_set(&dev->desc[n++], SSD1306_DATA, &fb[p0 * SSD1306_STRIDE + x0],
+             x1 - x0 + 1, SSD1306_STRIDE, p1 - p0 + 1);
+    return n;
+}
+
+// Bus bit times of one window: its command and len bytes on each of rows pages
+static uint32_t window_cost(uint16_t len, uint8_t rows)
+{
+    return SSD1306_LINK_BIT_TIMES(6) + SSD1306_LINK_BIT_TIMES((uint32_t)len * rows);
+}
+
+// Windows for the dirty span of each page (each page = 8 rows) of fb.
+// Consecutive pages with the same span share one address window (0x21/0x22)
+// and one data burst.
+static uint8_t plan_spans(SSD1306_Device *dev, const uint8_t *fb, uint32_t *cost)
+{
+    uint8_t n = 0, p, last;
+    *cost = 0;
+    for (p = 0; p < dev->pages; p = last + 1) {
+        uint8_t x0 = dev->dirty_x0[p];
+        uint8_t x1 = dev->dirty_x1[p];
+        last = p;
+        if (x0 > x1) continue;
+        while (last + 1 < dev->pages && dev->dirty_x0[last + 1] == x0 && dev->dirty_x1[last + 1] == x1) {
+            ++last;
+        }
+        n = plan_window(dev, n, fb, x0, x1, p, last);
+        *cost += window_cost(x1 - x0 + 1, last - p + 1);
+    }
+    return n;
+}
+
+// Two runs of changed columns are worth sending as one window when the
+// unchanged bytes between them cost less than another window: a window
+// command and a data transaction. The link cost is linear in the byte count,
+// so this only depends on the gap (10 bytes on I2C, 6 on SPI).
+#define DELTA_MAX_GAP ((SSD1306_LINK_BIT_TIMES(6) + 2 * SSD1306_LINK_BIT_TIMES(1) - \
+                        SSD1306_LINK_BIT_TIMES(2)) /                                \
+                       (SSD1306_LINK_BIT_TIMES(3) - SSD1306_LINK_BIT_TIMES(2)))
+
+typedef struct {
+    uint8_t x0, x1, p0, p1;
+} DeltaRun;
+
+// Columns of fb that differ from ref within the dirty spans, as runs with
+// short gaps bridged. A page whose runs line up with the ones of the page
+// above grows those windows instead of adding its own. Returns the number of
+// runs, or SSD1306_MAX_WINDOWS + 1 if there are too many.
+static uint8_t delta_runs(SSD1306_Device *dev, const uint8_t *fb, const uint8_t *ref, DeltaRun *run)
+{
+    uint8_t nr = 0, above = 0, p, i;
+    for (p = 0; p < dev->pages; ++p) {
+        const uint8_t *a = &fb[p * SSD1306_STRIDE];
+        const uint8_t *b = &ref[p * SSD1306_STRIDE];
+        uint8_t start = nr;
+        uint16_t x;
+        for (x = dev->dirty_x0[p]; x <= dev->dirty_x1[p]; ++x) {
+            if (a[x] == b[x]) continue;
+            // x lies past the previous run, so the gap is never negative
+            if (nr > start && (uint32_t)(x - run[nr - 1].x1 - 1) <= DELTA_MAX_GAP) {
+                run[nr - 1].x1 = x;
+            } else if (nr == SSD1306_MAX_WINDOWS) {
+                return SSD1306_MAX_WINDOWS + 1;
+            } else {
+                run[nr].x0 = run[nr].x1 = x;
+                run[nr].p0 = run[nr].p1 = p;
+                ++nr;
+            }
+        }
+        if (nr > start && nr - start == start - above) {
+            for (i = 0; i < nr - start; ++i) {
+                if (run[above + i].x0 != run[start + i].x0 || run[above + i].x1 != run[start + i].x1) break;
+            }
+            if (i == nr - start) {
+                for (i = 0; i < nr - start; ++i) run[above + i].p1 = p;
+                nr = start;
+                continue;
+            }
+        }
+        above = start;
+    }
+    return nr;
+}
+
+// Replace the dirty-span windows with the cheapest delta plan, if there is
+// one: a window per run, or a single window around all of them
+static uint8_t plan_delta(SSD1306_Device *dev, const uint8_t *fb, const uint8_t *ref,
+                          uint8_t n, uint32_t span_cost)
+{
+    DeltaRun run[SSD1306_MAX_WINDOWS];
+    uint8_t nr = delta_runs(dev, fb, ref, run);
+    uint8_t x0 = 0xFF, x1 = 0, p1 = 0, i;
+    uint32_t runs_cost = 0, box_cost = 0;
+
+    if (nr > SSD1306_MAX_WINDOWS) return n;
+    for (i = 0; i < nr; ++i) {
+        if (run[i].x0 < x0) x0 = run[i].x0;
+        if (run[i].x1 > x1) x1 = run[i].x1;
+        if (run[i].p1 > p1) p1 = run[i].p1;
+        runs_cost += window_cost(run[i].x1 - run[i].x0 + 1, run[i].p1 - run[i].p0 + 1);
+    }
+    // runs are in page order, so run[0] is on the top page
+    if (nr) box_cost = window_cost(x1 - x0 + 1, p1 - run[0].p0 + 1);
+    if (runs_cost >= span_cost && box_cost >= span_cost) return n;
+
+    if (box_cost < runs_cost) return plan_window(dev, 0, fb, x0, x1, run[0].p0, p1);
+    n = 0;
+    for (i = 0; i < nr; ++i) n = plan_window(dev, n, fb, run[i].x0, run[i].x1, run[i].p0, run[i].p1);
+    return n;
+}
+
+#ifdef SSD1306_STATS
+static uint32_t plan_bytes(const SSD1306_TxDesc *d, uint8_t n)
+{
+    uint32_t bytes = 0;
+    uint8_t i;
+    for (i = 0; i < n; ++i) bytes += SSD1306_LINK_BYTES((uint32_t)d[i].len * d[i].rows);
+    return bytes;
+}
+#endif
+
+static uint8_t cmd_take(SSD1306_Device *dev, uint8_t *tail);
+
+// Build the transactions that bring the panel up to date with fb and mark
+// the screen clean. With ref (a copy of display RAM) only changed bytes are
+// planned.
+static uint8_t flush_plan(SSD1306_Device *dev, const uint8_t *fb, const uint8_t *ref)
+{
+    uint32_t span_cost;
+    uint8_t n = plan_spans(dev, fb, &span_cost);
+    uint8_t lead, tail;
+#ifdef SSD1306_STATS
+    uint32_t span_bytes = plan_bytes(dev->desc, n);
+#endif
+    if (ref) n = plan_delta(dev, fb, ref, n, span_cost);
+#ifdef SSD1306_STATS
+    dev->stats.last_saved = span_bytes - plan_bytes(dev->desc, n);
+    dev->stats.saved += dev->stats.last_saved;
+#endif
+    // A scroll start follows the data, which must not be written while the
+    // controller scrolls, and so does a start line moved by ScrollUp(): the
+    // newly exposed rows are in display RAM before they scroll into view.
+    lead = cmd_take(dev, &tail);
+    dev->start_sent = dev->start_pending;
+    if (dev->start_pending) {
+        dev->tail_tx[tail++] = 0x40 | dev->start_line;
+        dev->start_pending = false;
+    }
+    if (tail) desc_set(&dev->desc[n++], SSD1306_CMD, dev->tail_tx, tail, tail, 1);
+    // The other queued commands lead the frame, sharing the transaction of
+    // its first command (a window or the tail). The copies leave the queue
+    // free while an async frame is on the bus.
+    if (lead) {
+        if (n) {
+            memcpy(&dev->cmd_tx[lead], dev->desc[0].data, dev->desc[0].len);
+            lead += dev->desc[0].len;
+        } else {
+            n = 1;
+        }
+        desc_set(&dev->desc[0], SSD1306_CMD, dev->cmd_tx, lead, lead, 1);
+    }
+    dirty_clear(dev);
+#ifdef SSD1306_STATS
+    stats_flush(dev, n);
+#endif
+    return n;
+}
+
+// Buffer that mirrors display RAM: in double-buffered mode the idle half
+// (the previous frame), else the delta shadow if there is one
+static uint8_t *flush_mirror(SSD1306_Device *dev)
+{
+    if (dev->double_buffered) {
+        return (dev->buffer == dev->framebuf[0]) ? dev->framebuf[1] : dev->framebuf[0];
+    }
+    return dev->delta ? dev->shadow : NULL;
+}
+
+static void requeue_commands(SSD1306_Device *dev);
+
+// The last frame did not reach the panel, or only part of it: send the whole
+// screen next time, together with the commands and start line it carried
+static void flush_failed(SSD1306_Device *dev)
+{
+    ssd1306_dirty_all(dev);
+    dev->shadow_valid = false;
+    if (dev->start_sent) dev->start_pending = true;
+    dev->start_sent = false;
+    requeue_commands(dev);
+}
+
+// An async frame that failed is recovered here rather than in the interrupt,
+// which must not touch the dirty spans or the queue while they are in use
+static void flush_recover(SSD1306_Device *dev)
+{
+    if (!dev->tx.error) return;
+    dev->tx.error = false;
+    flush_failed(dev);
+}
+
+// Plan the flush of the drawing buffer and copy what it sends into the
+// mirror, which then matches display RAM again. Outside the dirty spans the
+// two already agree, except for a shadow nobody has filled yet. In
+// double-buffered mode the halves swap: the drawn frame goes out and drawing
+// continues on the mirror, now a copy of it.
+static uint8_t flush_frame(SSD1306_Device *dev)
+{
+    uint8_t *fb = dev->buffer;
+    uint8_t *mirror = flush_mirror(dev);
+    uint8_t n, i, r;
+
+    flush_recover(dev);
+    n = flush_plan(dev, fb, (dev->delta && dev->shadow_valid) ? mirror : NULL);
+    if (!mirror) return n;
+    if (!dev->shadow_valid && !dev->double_buffered) {
+        memcpy(mirror, fb, SSD1306_BUFFER_BYTES(dev->height));
+    } else {
+        for (i = 0; i < n; ++i) {
+            const SSD1306_TxDesc *d = &dev->desc[i];
+            if (d->control != SSD1306_DATA) continue;
+            for (r = 0; r < d->rows; ++r) {
+                memcpy(&mirror[d->data - fb + r * d->stride], &d->data[r * d->stride], d->len);
+            }
+        }
+    }
+    dev->shadow_valid = true;
+    if (dev->double_buffered) dev->buffer = mirror;
+    return n;
+}
+
+// Send the dirty spans of the single buffer with blocking writes. A failed
+// transaction ends the frame and leaves the screen dirty for the next one.
+bool ssd1306_display_blocking(SSD1306_Device *dev)
+{
+    uint8_t n;
+    ssd1306_link_wait(dev);
+#ifdef SSD1306_STATS
+    uint32_t t0 = HWREG(DWT_CYCCNT);
+#endif
+    n = flush_frame(dev);
+#ifdef SSD1306_STATS
+    dev->stats.last_cpu_cycles = HWREG(DWT_CYCCNT) - t0;
+#endif
+    if (!ssd1306_link_send(dev, dev->desc, n)) {
+        flush_failed(dev);
+        return false;
+    }
+    return true;
+}
+
 void SSD1306_Display(void)
 {
-    // Write buffer to display as pages (each page = 8 rows)
-    const uint8_t set_col_cmds[] = {0x21, 0, SSD1306_WIDTH - 1}; // set column address
-    const uint8_t set_page_cmds[] = {0x22, 0, (SSD1306_HEIGHT/8) - 1}; // set page address
-    i2cWriteCommand(set_col_cmds[0]); // we'll send these commands separately to be safe
-    i2cWriteCommand(set_col_cmds[1]);
-    i2cWriteCommand(set_col_cmds[2]);
-    i2cWriteCommand(set_page_cmds[0]);
-    i2cWriteCommand(set_page_cmds[1]);
-    i2cWriteCommand(set_page_cmds[2]);
+    if (g_dev->double_buffered) {
+        SSD1306_DisplayFlush();
+        SSD1306_WaitFrame();
+        return;
+    }
+    ssd1306_display_blocking(g_dev);
+}
+
+// --- Interrupt-driven transmit ---
+void ssd1306_frame_done(SSD1306_Device *dev)
+{
+    // the panel may hold part of the frame: stop trusting the mirror. The
+    // rest waits for the next flush (flush_recover), tx.error stays set.
+    if (dev->tx.error) dev->shadow_valid = false;
+    dev->tx.busy = false;
+    if (dev->tx.done) dev->tx.done(!dev->tx.error);
+}
+
+bool SSD1306_DisplayAsync(SSD1306_DoneCallback done)
+{
+    SSD1306_Device *dev = g_dev;
+    uint8_t n;
+
+    if (dev->tx.busy) return false;
+#ifdef SSD1306_STATS
+    uint32_t t0 = HWREG(DWT_CYCCNT);
+#endif
+    n = flush_frame(dev);
+#ifdef SSD1306_STATS
+    dev->stats.last_cpu_cycles = HWREG(DWT_CYCCNT) - t0;
+#endif
+    dev->tx.done = done;
+    dev->tx.error = false;
+    if (n == 0) {
+        if (done) done(true);
+        return true;
+    }
+    dev->tx.desc = dev->desc;
+    dev->tx.count = n;
+    dev->tx.busy = true;
+    ssd1306_link_start(dev);
+    return true;
+}
+
+bool SSD1306_IsBusy(void)
+{
+    return g_dev->tx.busy;
+}
+
+bool SSD1306_FrameDone(void)
+{
+    return !g_dev->tx.busy;
+}
+
+void SSD1306_WaitFrame(void)
+{
+    while (g_dev->tx.busy) {
+#ifdef SSD1306_STATS
+        g_dev->stats.wait_polls++;
+#endif
+    }
+}
+
+#ifdef SSD1306_STATS
+void SSD1306_GetStats(SSD1306_Stats *stats)
+{
+    *stats = g_dev->stats;
+}
+
+void SSD1306_ResetStats(void)
+{
+    memset(&g_dev->stats, 0, sizeof(g_dev->stats));
+}
+
+uint32_t SSD1306_StatsFrameMicros(const SSD1306_Stats *stats, uint32_t bit_hz)
+{
+    return (uint32_t)(((uint64_t)stats->last_bit_times * 1000000 + bit_hz - 1) / bit_hz);
+}
+
+uint32_t SSD1306_StatsMaxFps(const SSD1306_Stats *stats, uint32_t bit_hz)
+{
+    return stats->last_bit_times ? bit_hz / stats->last_bit_times : 0;
+}
+#endif
+
+// --- Display command queue ---
+// Only state-setting commands are queued, at most one of each kind: a newer
+// command replaces the queued one setting the same state. Scrolling is one
+// such state (stopped, horizontal or diagonal), queued as its setup command
+// alone; the deactivate and activate around it are added when it is sent.
+static uint8_t cmd_kind(uint8_t cmd)
+{
+    switch (cmd) {
+    case 0x26: case 0x27: case 0x29: case 0x2A: case 0x2E:
+        return 0x2E;        // scrolling
+    case 0xC0: case 0xC8:
+        return 0xC0;        // COM scan direction
+    default:
+        return cmd & ~1;    // A0/A1, A6/A7, AE/AF differ in bit 0; 0x81 contrast
+    }
+}
 
-    // Many displays prefer the "control byte 0x40 then 128*pages bytes"
-    // Send entire buffer as data
-    i2cWriteData(buffer, sizeof(buffer));
+static uint8_t cmd_size(uint8_t cmd)
+{
+    switch (cmd) {
+    case 0x81: return 2;                // contrast
+    case 0x26: case 0x27: return 7;     // horizontal scroll setup
+    case 0x29: case 0x2A: return 6;     // diagonal scroll setup
+    default: return 1;
+    }
+}
+
+// Offset of the queued command setting the same state as cmd, or cmd_len
+static uint8_t cmd_find(const SSD1306_Device *dev, uint8_t cmd)
+{
+    uint8_t i;
+    for (i = 0; i < dev->cmd_len; i += cmd_size(dev->cmd_queue[i])) {
+        if (cmd_kind(dev->cmd_queue[i]) == cmd_kind(cmd)) break;
+    }
+    return i;
+}
+
+static void queue_command(SSD1306_Device *dev, const uint8_t *cmd)
+{
+    uint8_t i = cmd_find(dev, cmd[0]);
+    uint8_t len = cmd_size(cmd[0]);
+    // the queued one may differ in size (scroll setups), so it is removed and
+    // the new one appended
+    if (i < dev->cmd_len) {
+        uint8_t old = cmd_size(dev->cmd_queue[i]);
+        memmove(&dev->cmd_queue[i], &dev->cmd_queue[i + old], dev->cmd_len - i - old);
+        dev->cmd_len -= old;
+    }
+    memcpy(&dev->cmd_queue[dev->cmd_len], cmd, len);
+    dev->cmd_len += len;
+}
+
+// Empty the queue into cmd_tx, keeping a copy in cmd_sent, except for a
+// scroll start: it goes to tail_tx between deactivate (0x2E) and activate
+// (0x2F), to be sent after any data. Returns the bytes in cmd_tx and sets
+// *tail to those in tail_tx.
+static uint8_t cmd_take(SSD1306_Device *dev, uint8_t *tail)
+{
+    uint8_t lead = 0, t = 0, i, len;
+    for (i = 0; i < dev->cmd_len; i += len) {
+        const uint8_t *c = &dev->cmd_queue[i];
+        len = cmd_size(c[0]);
+        if (cmd_kind(c[0]) != 0x2E || c[0] == 0x2E) {
+            memcpy(&dev->cmd_tx[lead], c, len);
+            lead += len;
+            continue;
+        }
+        dev->tail_tx[t++] = 0x2E;
+        if (c[0] == 0x29 || c[0] == 0x2A) {
+            // vertical scroll area: no fixed rows, whole panel
+            dev->tail_tx[t++] = 0xA3;
+            dev->tail_tx[t++] = 0x00;
+            dev->tail_tx[t++] = dev->rows;
+        }
+        memcpy(&dev->tail_tx[t], c, len);
+        t += len;
+        dev->tail_tx[t++] = 0x2F;
+    }
+    memcpy(dev->cmd_sent, dev->cmd_queue, dev->cmd_len);
+    dev->cmd_sent_len = dev->cmd_len;
+    dev->cmd_len = 0;
+    *tail = t;
+    return lead;
+}
+
+// Commands of a failed flush go back in the queue, unless a newer one of the
+// same kind has been queued since
+static void requeue_commands(SSD1306_Device *dev)
+{
+    uint8_t i, len;
+    for (i = 0; i < dev->cmd_sent_len; i += len) {
+        len = cmd_size(dev->cmd_sent[i]);
+        if (cmd_find(dev, dev->cmd_sent[i]) == dev->cmd_len) {
+            memcpy(&dev->cmd_queue[dev->cmd_len], &dev->cmd_sent[i], len);
+            dev->cmd_len += len;
+        }
+    }
+    dev->cmd_sent_len = 0;
+}
+
+bool SSD1306_CommitCommands(void)
+{
+    SSD1306_Device *dev = g_dev;
+    uint8_t lead, tail;
+    ssd1306_link_wait(dev);
+    // a failed async frame may still have commands to give back
+    flush_recover(dev);
+    if (!dev->cmd_len) return true;
+    lead = cmd_take(dev, &tail);
+    if (!writeCommands(dev, dev->cmd_tx, lead) || !writeCommands(dev, dev->tail_tx, tail)) {
+        requeue_commands(dev);
+        return false;
+    }
+    return true;
 }
 
 void SSD1306_Invert(bool invert)
 {
-    if (invert) i2cWriteCommand(0xA7);
-    else i2cWriteCommand(0xA6);
+    uint8_t cmd = invert ? 0xA7 : 0xA6;
+    queue_command(g_dev, &cmd);
 }
 
 void SSD1306_SetContrast(uint8_t contrast)
 {
     const uint8_t cmd[] = {0x81, contrast};
-    i2cWriteCommands(cmd, 2);
+    queue_command(g_dev, cmd);
+}
+
+void SSD1306_SetDisplayOn(bool on)
+{
+    uint8_t cmd = on ? 0xAF : 0xAE;
+    queue_command(g_dev, &cmd);
+}
+
+// --- Hardware scrolling ---
+void SSD1306_SetStartLine(uint8_t line)
+{
+    g_dev->start_line = line & 63;
+    g_dev->start_pending = true;
+}
+
+static void fill_span(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool color);
+
+int16_t SSD1306_ScrollUp(uint8_t lines)
+{
+    SSD1306_Device *dev = g_dev;
+    // display RAM is 64 rows; the window of dev->rows visible rows wraps around it
+    uint8_t y = (dev->start_line + dev->rows) & 63;
+    uint8_t end = y + lines - 1;
+
+    if (dev->height != 64 || dev->rotation != SSD1306_ROTATE_0 || lines == 0 || lines > 64) return -1;
+
+    // the rows about to be exposed are cleared for the caller to draw into
+    if (end < 64) {
+        fill_span(0, y, dev->width - 1, end, false);
+    } else {
+        fill_span(0, y, dev->width - 1, 63, false);
+        fill_span(0, 0, dev->width - 1, end - 64, false);
+    }
+    dev->start_line = (dev->start_line + lines) & 63;
+    dev->start_pending = true;
+    return y;
+}
+
+void SSD1306_ScrollHorizontal(bool left, uint8_t start_page, uint8_t end_page, uint8_t interval)
+{
+    const uint8_t cmd[] = {
+        left ? 0x27 : 0x26, 0x00, start_page, interval, end_page, 0x00, 0xFF
+    };
+    queue_command(g_dev, cmd);
+    g_dev->scrolling = true;
+}
+
+void SSD1306_ScrollDiagonal(bool left, uint8_t start_page, uint8_t end_page, uint8_t interval, uint8_t vertical_step)
+{
+    const uint8_t cmd[] = {
+        left ? 0x2A : 0x29, 0x00, start_page, interval, end_page, vertical_step
+    };
+    queue_command(g_dev, cmd);
+    g_dev->scrolling = true;
+}
+
+void SSD1306_StopScroll(void)
+{
+    uint8_t cmd = 0x2E;
+    queue_command(g_dev, &cmd);
+    g_dev->scrolling = false;
+    // horizontal scrolling shifts display RAM itself; the deactivate leads
+    // the next flush, which rewrites it
+    SSD1306_Invalidate();
+}
+
+bool SSD1306_IsScrolling(void)
+{
+    return g_dev->scrolling;
+}
+
+// --- Rotation ---
+// Drawing coordinates are logical; the kernels below (pixel, span fill and
+// blit) map them to the framebuffer. A half turn is done by the panel itself
+// (segment and COM remap), so only quarter turns move pixels:
+//   90:  framebuffer (y, height - 1 - x)
+//   270: framebuffer (width - 1 - y, x)
+bool SSD1306_SetRotation(uint8_t rotation)
+{
+    SSD1306_Device *dev = g_dev;
+    bool half = rotation == SSD1306_ROTATE_180;
+    bool quarter = rotation == SSD1306_ROTATE_90 || rotation == SSD1306_ROTATE_270;
+    uint8_t cmds[2];
+
+    // quarter turns need the whole framebuffer on the panel, not a ring
+    if (rotation > SSD1306_ROTATE_270 || (quarter && dev->height != dev->rows)) return false;
+    cmds[0] = half ? 0xA0 : 0xA1;   // segment remap
+    cmds[1] = half ? 0xC0 : 0xC8;   // COM scan direction
+    queue_command(dev, &cmds[0]);
+    queue_command(dev, &cmds[1]);
+    dev->rotation = rotation;
+    dev->view_width = quarter ? dev->height : dev->width;
+    dev->view_height = quarter ? dev->width : dev->height;
+    // terminal mode scrolls with ScrollUp(), which needs the panel unrotated
+    if (rotation != SSD1306_ROTATE_0) dev->term_pitch = 0;
+    // the segment remap only applies to data written after it: the queued
+    // commands lead the next flush, which rewrites the whole screen
+    SSD1306_Invalidate();
+    return true;
+}
+
+uint8_t SSD1306_GetRotation(void) { return g_dev->rotation; }
+int16_t SSD1306_Width(void) { return g_dev->view_width; }
+int16_t SSD1306_Height(void) { return g_dev->view_height; }
+
+// 8x8 bit-matrix transpose: out[j] bit i = in[i] bit j. The block is one
+// 64-bit word, byte i = in[i], and three rounds of delta swaps exchange the
+// 4x4, 2x2 and 1x1 sub-blocks across the diagonal.
+static void transpose8(const uint8_t in[8], uint8_t out[8])
+{
+    uint64_t x = 0, t;
+    uint8_t i;
+    for (i = 0; i < 8; ++i) x |= (uint64_t)in[i] << (8 * i);
+    t = (x ^ (x << 28)) & 0x0F0F0F0F00000000ULL; x ^= t ^ (t >> 28);
+    t = (x ^ (x << 14)) & 0x3333000033330000ULL; x ^= t ^ (t >> 14);
+    t = (x ^ (x << 7)) & 0x5500550055005500ULL; x ^= t ^ (t >> 7);
+    for (i = 0; i < 8; ++i) out[i] = (uint8_t)(x >> (8 * i));
 }
 
 // --- Pixel & primitives ---
 void SSD1306_DrawPixel(int16_t x, int16_t y, bool color)
 {
-    if (x < 0 || x >= SSD1306_WIDTH || y < 0 || y >= SSD1306_HEIGHT) return;
-    uint16_t index = x + (y / 8) * SSD1306_WIDTH;
-    if (color) buffer[index] |= (1 << (y & 7));
-    else buffer[index] &= ~(1 << (y & 7));
+    SSD1306_Device *dev = g_dev;
+    int16_t t = x;
+    if (x < 0 || x >= dev->view_width || y < 0 || y >= dev->view_height) return;
+    if (dev->rotation == SSD1306_ROTATE_90) {
+        x = y;
+        y = dev->height - 1 - t;
+    } else if (dev->rotation == SSD1306_ROTATE_270) {
+        x = dev->width - 1 - y;
+        y = t;
+    }
+    uint8_t page = y / 8;
+    uint16_t index = x + page * SSD1306_STRIDE;
+    if (color) dev->buffer[index] |= (1 << (y & 7));
+    else dev->buffer[index] &= ~(1 << (y & 7));
+    if (x < dev->dirty_x0[page]) dev->dirty_x0[page] = x;
+    if (x > dev->dirty_x1[page]) dev->dirty_x1[page] = x;
+}
+
+// --- Span kernels ---
+// Apply a page-byte mask to w consecutive columns
+static inline void span_mask(uint8_t *dst, uint16_t w, uint8_t mask, bool color)
+{
+    if (mask == 0xFF) {
+        memset(dst, color ? 0xFF : 0x00, w);
+    } else if (color) {
+        while (w--) *dst++ |= mask;
+    } else {
+        mask = ~mask;
+        while (w--) *dst++ &= mask;
+    }
+}
+
+// Fill the clipped rectangle x0..x1, y0..y1 (inclusive) a page at a time:
+// masked top and bottom pages, whole bytes in between. A quarter turn maps
+// the rectangle to another one, so rotated fills cost the same.
+static void fill_span(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool color)
+{
+    int16_t t;
+    if (g_dev->rotation == SSD1306_ROTATE_90) {
+        t = x0;
+        x0 = y0;
+        y0 = g_dev->height - 1 - x1;
+        x1 = y1;
+        y1 = g_dev->height - 1 - t;
+    } else if (g_dev->rotation == SSD1306_ROTATE_270) {
+        t = y0;
+        y0 = x0;
+        x0 = g_dev->width - 1 - y1;
+        y1 = x1;
+        x1 = g_dev->width - 1 - t;
+    }
+    uint8_t p0 = y0 / 8, p1 = y1 / 8, p;
+    uint8_t top = 0xFF << (y0 & 7);
+    uint8_t bottom = 0xFF >> (7 - (y1 & 7));
+    uint16_t w = x1 - x0 + 1;
+    uint8_t *dst = &g_dev->buffer[p0 * SSD1306_STRIDE + x0];
+
+    dirty_mark(g_dev, x0, y0, x1, y1);
+    if (p0 == p1) {
+        span_mask(dst, w, top & bottom, color);
+        return;
+    }
+    span_mask(dst, w, top, color);
+    for (p = p0 + 1; p < p1; ++p) {
+        dst += SSD1306_STRIDE;
+        memset(dst, color ? 0xFF : 0x00, w);
+    }
+    span_mask(dst + SSD1306_STRIDE, w, bottom, color);
+}
+
+// Clip x, y, w, h to the screen; false if nothing is left
+static bool clip_rect(int16_t *x, int16_t *y, int16_t *w, int16_t *h)
+{
+    if (*x < 0) { *w += *x; *x = 0; }
+    if (*y < 0) { *h += *y; *y = 0; }
+    if (*x + *w > g_dev->view_width) *w = g_dev->view_width - *x;
+    if (*y + *h > g_dev->view_height) *h = g_dev->view_height - *y;
+    return *w > 0 && *h > 0;
+}
+
+void SSD1306_DrawHLine(int16_t x, int16_t y, int16_t w, bool color)
+{
+    int16_t h = 1;
+    if (!clip_rect(&x, &y, &w, &h)) return;
+    fill_span(x, y, x + w - 1, y, color);
+}
+
+void SSD1306_DrawVLine(int16_t x, int16_t y, int16_t h, bool color)
+{
+    int16_t w = 1;
+    if (!clip_rect(&x, &y, &w, &h)) return;
+    fill_span(x, y, x, y + h - 1, color);
 }
 
 void SSD1306_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool color)
 {
+    if (y0 == y1) {
+        if (x0 > x1) { int16_t t = x0; x0 = x1; x1 = t; }
+        SSD1306_DrawHLine(x0, y0, x1 - x0 + 1, color);
+        return;
+    }
+    if (x0 == x1) {
+        if (y0 > y1) { int16_t t = y0; y0 = y1; y1 = t; }
+        SSD1306_DrawVLine(x0, y0, y1 - y0 + 1, color);
+        return;
+    }
     // Bresenham
     int16_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
     int16_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
@@ -193,20 +881,17 @@ void SSD1306_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool color
 
 void SSD1306_DrawRect(int16_t x, int16_t y, int16_t w, int16_t h, bool color)
 {
-    SSD1306_DrawLine(x, y, x + w - 1, y, color);
-    SSD1306_DrawLine(x, y + h - 1, x + w - 1, y + h - 1, color);
-    SSD1306_DrawLine(x, y, x, y + h - 1, color);
-    SSD1306_DrawLine(x + w - 1, y, x + w - 1, y + h -1, color);
+    if (w <= 0 || h <= 0) return;
+    SSD1306_DrawHLine(x, y, w, color);
+    SSD1306_DrawHLine(x, y + h - 1, w, color);
+    SSD1306_DrawVLine(x, y, h, color);
+    SSD1306_DrawVLine(x + w - 1, y, h, color);
 }
 
 void SSD1306_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, bool color)
 {
-    int16_t i = 0, j = 0;
-    for (i = x; i < x + w; ++i) {
-        for (j = y; j < y + h; ++j) {
-            SSD1306_DrawPixel(i, j, color);
-        }
-    }
+    if (!clip_rect(&x, &y, &w, &h)) return;
+    fill_span(x, y, x + w - 1, y + h - 1, color);
 }
 
 void SSD1306_DrawCircle(int16_t x0, int16_t y0, int16_t r, bool color)
@@ -243,120 +928,652 @@ void SSD1306_DrawCircle(int16_t x0, int16_t y0, int16_t r, bool color)
     }
 }
 
-// Bitmaps: expects bitmap stored as bytes row-major or column-major depending on how you export.
-// We'll assume a simple row-major with each byte representing 8 vertical pixels (like many SSD1306 exporters).
-void SSD1306_DrawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, bool color)
+// --- Filled shapes ---
+// A page byte holds 8 rows of one column, so fills are emitted as vertical
+// spans: one column costs at most one byte per page it touches.
+
+// Quarter-circle outlines for rounded corners: bit 0 top-left, 1 top-right,
+// 2 bottom-right, 3 bottom-left
+static void circle_corners(int16_t x0, int16_t y0, int16_t r, uint8_t corners, bool color)
+{
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+    while (x < y) {
+        if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+        x++; ddF_x += 2; f += ddF_x;
+        if (corners & 1) { SSD1306_DrawPixel(x0 - y, y0 - x, color); SSD1306_DrawPixel(x0 - x, y0 - y, color); }
+        if (corners & 2) { SSD1306_DrawPixel(x0 + x, y0 - y, color); SSD1306_DrawPixel(x0 + y, y0 - x, color); }
+        if (corners & 4) { SSD1306_DrawPixel(x0 + x, y0 + y, color); SSD1306_DrawPixel(x0 + y, y0 + x, color); }
+        if (corners & 8) { SSD1306_DrawPixel(x0 - y, y0 + x, color); SSD1306_DrawPixel(x0 - x, y0 + y, color); }
+    }
+}
+
+// Columns of a circle's right (bit 0) and/or left (bit 1) half, excluding the
+// centre column, each stretched down by delta rows (for rounded rectangles).
+// Same midpoint steps as DrawCircle, so fill and outline line up.
+static void fill_halves(int16_t x0, int16_t y0, int16_t r, uint8_t sides, int16_t delta, bool color)
+{
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+    int16_t px = x, py = y;
+    while (x < y) {
+        if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+        x++; ddF_x += 2; f += ddF_x;
+        // the column at x is complete once y has settled for it
+        if (x < y + 1) {
+            if (sides & 1) SSD1306_DrawVLine(x0 + x, y0 - y, 2 * y + 1 + delta, color);
+            if (sides & 2) SSD1306_DrawVLine(x0 - x, y0 - y, 2 * y + 1 + delta, color);
+        }
+        if (y != py) {
+            if (sides & 1) SSD1306_DrawVLine(x0 + py, y0 - px, 2 * px + 1 + delta, color);
+            if (sides & 2) SSD1306_DrawVLine(x0 - py, y0 - px, 2 * px + 1 + delta, color);
+            py = y;
+        }
+        px = x;
+    }
+}
+
+void SSD1306_FillCircle(int16_t x0, int16_t y0, int16_t r, bool color)
+{
+    if (r < 0) return;
+    SSD1306_DrawVLine(x0, y0 - r, 2 * r + 1, color);
+    fill_halves(x0, y0, r, 3, 0, color);
+}
+
+void SSD1306_DrawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool color)
+{
+    SSD1306_DrawLine(x0, y0, x1, y1, color);
+    SSD1306_DrawLine(x1, y1, x2, y2, color);
+    SSD1306_DrawLine(x2, y2, x0, y0, color);
+}
+
+// Column by column between the long edge (0-2) and the two short ones
+// (0-1, then 1-2), with the edge positions kept as exact fractions
+void SSD1306_FillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool color)
+{
+    int16_t t, x, last;
+    int32_t sa = 0, sb = 0, dx01, dy01, dx02, dy02, dx12, dy12;
+
+    // sort by x: x0 <= x1 <= x2
+    if (x0 > x1) { t = x0; x0 = x1; x1 = t; t = y0; y0 = y1; y1 = t; }
+    if (x1 > x2) { t = x1; x1 = x2; x2 = t; t = y1; y1 = y2; y2 = t; }
+    if (x0 > x1) { t = x0; x0 = x1; x1 = t; t = y0; y0 = y1; y1 = t; }
+
+    if (x0 == x2) {
+        // degenerate: one column
+        int16_t a = y0, b = y0;
+        if (y1 < a) a = y1; else if (y1 > b) b = y1;
+        if (y2 < a) a = y2; else if (y2 > b) b = y2;
+        SSD1306_DrawVLine(x0, a, b - a + 1, color);
+        return;
+    }
+
+    dx01 = x1 - x0; dy01 = y1 - y0;
+    dx02 = x2 - x0; dy02 = y2 - y0;
+    dx12 = x2 - x1; dy12 = y2 - y1;
+
+    // first part includes column x1 only if the 1-2 edge is vertical
+    last = (x1 == x2) ? x1 : x1 - 1;
+    for (x = x0; x <= last; ++x) {
+        int16_t a = y0 + sa / dx01;
+        int16_t b = y0 + sb / dx02;
+        sa += dy01;
+        sb += dy02;
+        if (a > b) { t = a; a = b; b = t; }
+        SSD1306_DrawVLine(x, a, b - a + 1, color);
+    }
+
+    sa = dy12 * (x - x1);
+    sb = dy02 * (x - x0);
+    for (; x <= x2; ++x) {
+        int16_t a = y1 + sa / dx12;
+        int16_t b = y0 + sb / dx02;
+        sa += dy12;
+        sb += dy02;
+        if (a > b) { t = a; a = b; b = t; }
+        SSD1306_DrawVLine(x, a, b - a + 1, color);
+    }
+}
+
+void SSD1306_DrawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, bool color)
+{
+    int16_t max_r = (w < h ? w : h) / 2;
+    if (w <= 0 || h <= 0) return;
+    if (r > max_r) r = max_r;
+    if (r < 0) r = 0;
+    SSD1306_DrawHLine(x + r, y, w - 2 * r, color);
+    SSD1306_DrawHLine(x + r, y + h - 1, w - 2 * r, color);
+    SSD1306_DrawVLine(x, y + r, h - 2 * r, color);
+    SSD1306_DrawVLine(x + w - 1, y + r, h - 2 * r, color);
+    circle_corners(x + r, y + r, r, 1, color);
+    circle_corners(x + w - r - 1, y + r, r, 2, color);
+    circle_corners(x + w - r - 1, y + h - r - 1, r, 4, color);
+    circle_corners(x + r, y + h - r - 1, r, 8, color);
+}
+
+void SSD1306_FillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, bool color)
+{
+    int16_t max_r = (w < h ? w : h) / 2;
+    if (w <= 0 || h <= 0) return;
+    if (r > max_r) r = max_r;
+    if (r < 0) r = 0;
+    SSD1306_FillRect(x + r, y, w - 2 * r, h, color);
+    fill_halves(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+    fill_halves(x + r, y + r, r, 2, h - 2 * r - 1, color);
+}
+
+// sin(deg) for 0..90 degrees, scaled by 2^14
+static const uint16_t g_sin_q14[91] = {
+        0,   286,   572,   857,  1143,  1428,  1713,  1997,  2280,  2563,
+     2845,  3126,  3406,  3686,  3964,  4240,  4516,  4790,  5063,  5334,
+     5604,  5872,  6138,  6402,  6664,  6924,  7182,  7438,  7692,  7943,
+     8192,  8438,  8682,  8923,  9162,  9397,  9630,  9860, 10087, 10311,
+    10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+    12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+    14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+    15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+    16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+    16384
+};
+
+// Unit vector of deg (0 = 3 o'clock, clockwise on screen) scaled by 2^14
+static void angle_vector(int16_t deg, int32_t *cx, int32_t *sy)
+{
+    int16_t q;
+    deg %= 360;
+    if (deg < 0) deg += 360;
+    q = deg % 90;
+    switch (deg / 90) {
+    case 0:  *cx =  g_sin_q14[90 - q]; *sy =  g_sin_q14[q];      break;
+    case 1:  *cx = -g_sin_q14[q];      *sy =  g_sin_q14[90 - q]; break;
+    case 2:  *cx = -g_sin_q14[90 - q]; *sy = -g_sin_q14[q];      break;
+    default: *cx =  g_sin_q14[q];      *sy = -g_sin_q14[90 - q]; break;
+    }
+}
+
+// Ring sector: pixels whose distance from the centre is between r_inner and
+// r_outer (inclusive, rounded like the midpoint circle) and whose angle runs
+// clockwise from start_deg to end_deg. Each column is scanned once and its
+// runs of covered pixels are written as vertical spans.
+void SSD1306_FillArc(int16_t x0, int16_t y0, int16_t r_outer, int16_t r_inner,
+                     int16_t start_deg, int16_t end_deg, bool color)
+{
+    int32_t scx, ssy, ecx, esy;
+    int32_t out2 = (int32_t)r_outer * r_outer + r_outer;
+    int32_t in2 = (int32_t)r_inner * r_inner - r_inner;
+    int16_t sweep = (end_deg - start_deg) % 360;
+    bool full = end_deg != start_deg && sweep == 0;
+    int16_t dx, dy, ytop, ybot;
+
+    if (r_outer < 0 || (sweep == 0 && !full)) return;
+    if (r_inner < 1) in2 = -1;
+    if (sweep < 0) sweep += 360;
+    angle_vector(start_deg, &scx, &ssy);
+    angle_vector(end_deg, &ecx, &esy);
+
+    // only rows on screen are scanned
+    ytop = -r_outer;
+    ybot = r_outer;
+    if (y0 + ytop < 0) ytop = -y0;
+    if (y0 + ybot >= g_dev->view_height) ybot = g_dev->view_height - 1 - y0;
+
+    for (dx = -r_outer; dx <= r_outer; ++dx) {
+        int16_t run = 0;
+        if (x0 + dx < 0 || x0 + dx >= g_dev->view_width) continue;
+        for (dy = ytop; dy <= ybot + 1; ++dy) {
+            bool in = false;
+            if (dy <= ybot) {
+                int32_t d2 = (int32_t)dx * dx + (int32_t)dy * dy;
+                in = d2 <= out2 && d2 > in2;
+                if (in && !full) {
+                    // clockwise from start and counter-clockwise from end;
+                    // sweeps over 180 degrees are the complement of the gap
+                    int32_t from_start = scx * dy - ssy * dx;
+                    int32_t to_end = dx * esy - dy * ecx;
+                    if (sweep <= 180) in = from_start >= 0 && to_end >= 0;
+                    else in = !(from_start < 0 && to_end < 0);
+                }
+            }
+            if (in) {
+                ++run;
+            } else if (run) {
+                SSD1306_DrawVLine(x0 + dx, y0 + dy - run, run, color);
+                run = 0;
+            }
+        }
+    }
+}
+
+void SSD1306_DrawArc(int16_t x0, int16_t y0, int16_t r, int16_t start_deg, int16_t end_deg, bool color)
+{
+    SSD1306_FillArc(x0, y0, r, r, start_deg, end_deg, color);
+}
+
+// --- Column-byte blitter ---
+// Combine a w x h source in page format (LSB = top pixel) into the screen at
+// (x, y) with raster op rop, clipped once per call. Byte k of source column c
+// is src[c * col_stride + k * page_stride], so column-major fonts and
+// page-major bitmaps share the kernel. Each source byte is shifted across at
+// most two page bytes; page-aligned copies are a straight memcpy.
+// invert complements the source first (off pixels become set). x and y are
+// framebuffer coordinates.
+static void blit_fb(int16_t x, int16_t y, const uint8_t *src, int16_t w, int16_t h,
+                    uint16_t col_stride, uint16_t page_stride, SSD1306_RasterOp rop, bool invert)
 {
-    // For each column of the bitmap:
-    int16_t i = 0, j = 0;
-    for (j = 0; j < h; ++j) {
-        for (i = 0; i < w; ++i) {
-            // compute source bit
-            int16_t byteIndex = (i + (j / 8) * w);
-            uint8_t byte = bitmap[byteIndex];
-            uint8_t bit = 1 << (j & 7);
-            bool pixelOn = (byte & bit);
-            if (pixelOn) SSD1306_DrawPixel(x + i, y + j, color);
-            else SSD1306_DrawPixel(x + i, y + j, !color);
+    SSD1306_Device *dev = g_dev;
+    int16_t c0 = 0, c1 = w, c, p0, k;
+    uint8_t shift, pages = (h + 7) / 8;
+    uint8_t last_mask = 0xFF >> ((8 - (h & 7)) & 7);
+    uint8_t flip = invert ? 0xFF : 0x00;
+
+    if (x < 0) c0 = -x;
+    if (x + w > dev->width) c1 = dev->width - x;
+    if (c0 >= c1 || h <= 0 || y >= dev->height || y + h <= 0) return;
+
+    // floor division so sources partly above the top edge keep their shift
+    p0 = (y >= 0) ? y / 8 : -((7 - y) / 8);
+    shift = y - p0 * 8;
+    dirty_mark(dev, x + c0, (y < 0) ? 0 : y, x + c1 - 1,
+               (y + h > dev->height) ? dev->height - 1 : y + h - 1);
+
+    for (k = 0; k < pages; ++k) {
+        int16_t p = p0 + k;
+        uint8_t m = (k == pages - 1) ? last_mask : 0xFF;
+        uint16_t mask = (uint16_t)m << shift;
+        uint8_t *lo = (p >= 0 && p < dev->pages) ? &dev->buffer[p * SSD1306_STRIDE + x] : NULL;
+        uint8_t *hi = (shift && p + 1 >= 0 && p + 1 < dev->pages) ? &dev->buffer[(p + 1) * SSD1306_STRIDE + x] : NULL;
+        const uint8_t *s = &src[k * page_stride];
+
+        if (rop == SSD1306_ROP_COPY && !invert && shift == 0 && m == 0xFF && lo && col_stride == 1) {
+            memcpy(&lo[c0], &s[c0], c1 - c0);
+            continue;
+        }
+        for (c = c0; c < c1; ++c) {
+            uint16_t bits = (uint16_t)((s[c * col_stride] ^ flip) & m) << shift;
+            switch (rop) {
+            case SSD1306_ROP_COPY:
+                if (lo) lo[c] = (lo[c] & ~mask) | bits;
+                if (hi) hi[c] = (hi[c] & ~(mask >> 8)) | (bits >> 8);
+                break;
+            case SSD1306_ROP_OR:
+                if (lo) lo[c] |= bits;
+                if (hi) hi[c] |= bits >> 8;
+                break;
+            case SSD1306_ROP_ANDNOT:
+                if (lo) lo[c] &= ~bits;
+                if (hi) hi[c] &= ~(bits >> 8);
+                break;
+            case SSD1306_ROP_XOR:
+                if (lo) lo[c] ^= bits;
+                if (hi) hi[c] ^= bits >> 8;
+                break;
+            }
         }
     }
 }
 
+// Same with logical coordinates. Under a quarter turn source columns become
+// framebuffer rows, so the source is cut into 8x8 blocks (8 columns of one
+// page byte), each block is transposed into framebuffer page format and
+// blitted there. Blocks off screen are clipped by blit_fb().
+static void blit(int16_t x, int16_t y, const uint8_t *src, int16_t w, int16_t h,
+                 uint16_t col_stride, uint16_t page_stride, SSD1306_RasterOp rop, bool invert)
+{
+    SSD1306_Device *dev = g_dev;
+    uint8_t in[8], out[8], blk[8];
+    int16_t c, k, i;
+
+    if (dev->rotation != SSD1306_ROTATE_90 && dev->rotation != SSD1306_ROTATE_270) {
+        blit_fb(x, y, src, w, h, col_stride, page_stride, rop, invert);
+        return;
+    }
+    for (k = 0; k * 8 < h; ++k) {
+        uint8_t bh = (h - k * 8 < 8) ? h - k * 8 : 8;     // logical rows
+        for (c = 0; c < w; c += 8) {
+            uint8_t bw = (w - c < 8) ? w - c : 8;         // logical columns
+            int16_t lx = x + c, ly = y + k * 8;
+            memset(in, 0, sizeof(in));
+            if (dev->rotation == SSD1306_ROTATE_90) {
+                // logical column i lands on framebuffer row bw - 1 - i of the
+                // block, left to right becomes bottom to top
+                for (i = 0; i < bw; ++i) in[bw - 1 - i] = src[(c + i) * col_stride + k * page_stride];
+                transpose8(in, blk);
+                blit_fb(ly, dev->height - lx - bw, blk, bh, bw, 1, 8, rop, invert);
+            } else {
+                // logical row j lands on framebuffer column bh - 1 - j
+                for (i = 0; i < bw; ++i) in[i] = src[(c + i) * col_stride + k * page_stride];
+                transpose8(in, out);
+                for (i = 0; i < bh; ++i) blk[bh - 1 - i] = out[i];
+                blit_fb(dev->width - ly - bh, lx, blk, bh, bw, 1, 8, rop, invert);
+            }
+        }
+    }
+}
+
+// Bitmaps: each byte holds 8 vertical pixels (LSB on top), rows of w bytes
+// per 8-pixel band, as produced by most SSD1306 exporters.
+// Set bits are drawn in color, clear bits in !color.
+void SSD1306_DrawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, bool color)
+{
+    blit(x, y, bitmap, w, h, 1, w, SSD1306_ROP_COPY, !color);
+}
+
+void SSD1306_BlitBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, SSD1306_RasterOp rop)
+{
+    blit(x, y, bitmap, w, h, 1, w, rop, false);
+}
+
 // --- Text ---
 void SSD1306_SetCursor(int16_t x, int16_t y)
 {
     // x in pixels, y in lines (rows of text), but we provide y as pixel lines for flexibility
-    cursor_x = x;
-    cursor_y = y;
+    g_dev->cursor_x = x;
+    g_dev->cursor_y = y;
 }
 
 void SSD1306_WriteString(const char *str)
 {
     while (*str) {
         if (*str == '\n') {
-            cursor_x = 0;
-            cursor_y += 8;
+            g_dev->cursor_x = 0;
+            g_dev->cursor_y += 8;
             ++str;
             continue;
         }
         SSD1306_WriteChar(*str++);
     }
 }
-static void float_to_string(float num, char *buffer, int precision);
+// --- Number formatting ---
+// Integer only: two digits per divide through a pair table, so counters and
+// readings never touch soft float or the per-digit divide loop.
+static const char g_digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+static const uint32_t g_pow10[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// Writes v backwards ending just before end, at least min_digits long
+// (zero-padded); returns the first character
+static char *utoa_rev(uint32_t v, char *end, uint8_t min_digits)
+{
+    char *p = end;
+    while (v >= 100) {
+        const char *pair = &g_digit_pairs[(v % 100) * 2];
+        v /= 100;
+        *--p = pair[1];
+        *--p = pair[0];
+    }
+    if (v >= 10) {
+        *--p = g_digit_pairs[v * 2 + 1];
+        *--p = g_digit_pairs[v * 2];
+    } else {
+        *--p = '0' + v;
+    }
+    while (end - p < min_digits) *--p = '0';
+    return p;
+}
+
+// value / 10^decimals as text; INT32_MIN is handled by negating in unsigned
+static char *fixed_to_string(int32_t value, uint8_t decimals, char *end)
+{
+    uint32_t mag = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    char *p = end;
+    *--p = '\0';
+    if (decimals) {
+        p = utoa_rev(mag % g_pow10[decimals], p, decimals);
+        *--p = '.';
+        mag /= g_pow10[decimals];
+    }
+    p = utoa_rev(mag, p, 1);
+    if (value < 0) *--p = '-';
+    return p;
+}
+
 void SSD1306_WriteInt(int32_t val)
 {
-    char buf[16] = {0};
-    float_to_string(val, buf, 0);
-    SSD1306_WriteString(buf);
+    char buf[12];
+    SSD1306_WriteString(fixed_to_string(val, 0, buf + sizeof(buf)));
+}
+
+void SSD1306_WriteFixed(int32_t value, uint8_t decimals)
+{
+    char buf[13];
+    if (decimals > 9) decimals = 9;
+    SSD1306_WriteString(fixed_to_string(value, decimals, buf + sizeof(buf)));
 }
 
+uint8_t SSD1306_FormatFixed(char *buf, int32_t value, uint8_t decimals)
+{
+    char tmp[13];
+    char *p;
+    uint8_t len;
+    if (decimals > 9) decimals = 9;
+    p = fixed_to_string(value, decimals, tmp + sizeof(tmp));
+    len = tmp + sizeof(tmp) - 1 - p;
+    memcpy(buf, p, len + 1);
+    return len;
+}
+
+static void float_to_string(float num, char *buffer, int precision);
 void SSD1306_WriteFloat(float val, uint8_t decimals)
 {
     char buf[32] = {0};
+    if (decimals > 9) decimals = 9;
+    // Scale once and print as fixed point when it fits in an int32
+    float scaled = val * (float)g_pow10[decimals];
+    if (scaled > -2147483520.0f && scaled < 2147483520.0f) {
+        int32_t fixed = (int32_t)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+        SSD1306_WriteString(fixed_to_string(fixed, decimals, buf + sizeof(buf)));
+        return;
+    }
     float_to_string(val, buf, decimals);
     SSD1306_WriteString(buf);
 }
 
 // --- Initialization ---
-void SSD1306_Init(uint32_t i2c_base, uint8_t i2c_addr)
+// The transport sets up the link and calls ssd1306_device_start() afterwards
+void ssd1306_device_init(SSD1306_Device *dev, uint8_t width, uint8_t rows, uint8_t height,
+                         uint8_t *framebuf, uint8_t *backbuf)
 {
-    g_i2c_base = i2c_base;
-    g_i2c_addr = i2c_addr;
+    memset(dev, 0, sizeof(*dev));
+    dev->width = width;
+    dev->height = height;
+    dev->view_width = width;
+    dev->view_height = height;
+    dev->rows = rows;
+    dev->pages = height / 8;
+    dev->framebuf[0] = framebuf;
+    dev->framebuf[1] = backbuf;
+    dev->buffer = framebuf;
+    dev->font = &Font6x8;
+    SSD1306_Select(dev);
 
-    // Clear buffer
-    buffer_clear();
-
-    // Init sequence
-    ssd1306_command_init();
+#ifdef SSD1306_STATS
+    HWREG(CORE_DEMCR) |= CORE_DEMCR_TRCENA;
+    HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+#endif
 
-    // default cursor
-    cursor_x = 0;
-    cursor_y = 0;
+    // Clear buffer; display RAM content is unknown after power-up
+    buffer_clear(dev);
+    dirty_clear(dev);
+    SSD1306_Invalidate();
 }
 
+SSD1306_Device *ssd1306_default_device(uint8_t **framebuf, uint8_t **backbuf)
+{
+    *framebuf = g_default_fb[0];
+    *backbuf = g_default_fb[1];
+    return &g_default_dev;
+}
 
+void SSD1306_Select(SSD1306_Device *dev)
+{
+    g_dev = dev;
+}
 
+SSD1306_Device *SSD1306_Selected(void)
+{
+    return g_dev;
+}
 
 // Text rendering (simple)
-void ssd1306_SetFont(const FontDef *font) { current_font = font; }
+void ssd1306_SetFont(const FontDef *font) { g_dev->font = font; }
+
+// Glyph data for c, or NULL if the font (or its subset) has no such glyph
+static const uint8_t *font_glyph(const FontDef *font, char c)
+{
+    uint8_t code = (uint8_t)c;
+    if (code < font->first || code > font->last) return NULL;
+    uint16_t slot = code - font->first;
+    if (font->map) {
+        slot = font->map[slot];
+        if (slot == SSD1306_GLYPH_NONE) return NULL;
+    }
+    return &font->data[slot * font->bytes_per_char];
+}
+
+// Glyph of c at the cursor; the cursor is not moved
+static void draw_glyph(SSD1306_Device *dev, char c)
+{
+    const FontDef *font = dev->font;
+    const uint8_t *chdata = font_glyph(font, c);
+    if (!chdata) chdata = font_glyph(font, '?');
+    // glyphs are column-major, one or two page bytes per column; a glyph
+    // missing from a subset still advances the cursor
+    if (chdata)
+        blit(dev->cursor_x, dev->cursor_y, chdata, font->width, font->height,
+             (font->height + 7) / 8, 1, SSD1306_ROP_COPY, false);
+}
 
 void SSD1306_WriteChar(char c) {
-    if (c < 32 || c > 126) c = '?';
-    uint16_t first = 32;
-    uint16_t index = (c - first) * current_font->bytes_per_char + 0;
-    const uint8_t *chdata = &current_font->data[index];
-    uint8_t w = current_font->width;
-    uint8_t h = current_font->height;
-    uint8_t bytesPerCol = (h + 7) / 8;
-    uint8_t col = 0, row = 0;
-    for (col = 0; col < w; col++) {
-        for ( row = 0; row < h; row++) {
-            uint8_t byte = chdata[col * bytesPerCol + (row / 8)];
-            bool pix = (byte >> (row & 7)) & 1;
-            SSD1306_DrawPixel(cursor_x + col, cursor_y + row, pix);
-        }
+    SSD1306_Device *dev = g_dev;
+    uint8_t w = dev->font->width;
+    uint8_t h = dev->font->height;
+    draw_glyph(dev, c);
+    dev->cursor_x += w + 1;
+    if (dev->cursor_x + w >= dev->view_width) { dev->cursor_x = 0; dev->cursor_y += h + 1; }
+}
+
+// --- Terminal ---
+// Text lines are whole pages of the 64-row display RAM ring. Until the
+// panel is full a new line just moves down; after that it is the line that
+// ScrollUp() exposes, so each line costs its own page bytes plus one start
+// line command however tall the panel is. A '\n' only takes effect with the
+// next character, so a trailing newline does not leave an empty bottom line.
+bool SSD1306_TermInit(void)
+{
+    SSD1306_Device *dev = g_dev;
+    uint8_t pitch = (dev->font->height + 7) & ~7;
+
+    if (dev->height != 64 || dev->rotation != SSD1306_ROTATE_0 || pitch > dev->rows) return false;
+
+    buffer_clear(dev);
+    ssd1306_dirty_all(dev);
+    dev->start_line = 0;
+    dev->start_pending = true;
+    dev->cursor_x = 0;
+    dev->cursor_y = 0;
+    dev->term_pitch = pitch;
+    dev->term_lines = 1;
+    dev->term_newline = false;
+    return true;
+}
+
+static void term_newline(SSD1306_Device *dev)
+{
+    dev->cursor_x = 0;
+    dev->term_newline = false;
+    if (dev->term_lines < dev->rows / dev->term_pitch) {
+        dev->term_lines++;
+        dev->cursor_y = (dev->cursor_y + dev->term_pitch) & 63;
+    } else {
+        dev->cursor_y = SSD1306_ScrollUp(dev->term_pitch);
     }
-    cursor_x += w + 1;
-    if (cursor_x + w >= SSD1306_WIDTH) { cursor_x = 0; cursor_y += h + 1; }
+}
+
+void SSD1306_TermPutc(char c)
+{
+    SSD1306_Device *dev = g_dev;
+
+    if (!dev->term_pitch) return;
+    if (c == '\n') {
+        if (dev->term_newline) term_newline(dev);
+        dev->term_newline = true;
+        return;
+    }
+    if (c == '\r') {
+        dev->cursor_x = 0;
+        return;
+    }
+    if (dev->term_newline || dev->cursor_x + dev->font->width > dev->width) term_newline(dev);
+    draw_glyph(dev, c);
+    dev->cursor_x += dev->font->width + 1;
+}
+
+void SSD1306_TermWrite(const char *s, uint32_t len)
+{
+    while (len--) SSD1306_TermPutc(*s++);
+}
+
+void SSD1306_TermPrintf(const char *fmt, ...)
+{
+    char buf[SSD1306_TERM_PRINTF_MAX];
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    // longer output is cut to what fits in buf
+    SSD1306_TermWrite(buf, (uint32_t)n < sizeof(buf) ? (uint32_t)n : sizeof(buf) - 1);
 }
 
 // --- Buffer / flush helpers ---
 void SSD1306_DisplayOnBuffer(void) {
-    // alias - nothing extra needed
+    SSD1306_Device *dev = g_dev;
+    if (dev->double_buffered || !dev->framebuf[1]) return;
+    // both halves start out holding the same frame
+    ssd1306_link_wait(dev);
+    memcpy(dev->framebuf[1], dev->framebuf[0], SSD1306_BUFFER_BYTES(dev->height));
+    dev->buffer = dev->framebuf[0];
+    dev->double_buffered = true;
+    // ... which the panel shows only outside the dirty spans
+    dev->shadow_valid = false;
 }
 
 void SSD1306_DisplayFlush(void) {
-    SSD1306_Display();
+    if (!g_dev->double_buffered) {
+        SSD1306_Display();
+        return;
+    }
+    // Only waits if the previous frame is still on the bus
+    SSD1306_WaitFrame();
+    SSD1306_DisplayAsync(NULL);
 }
 
 void float_to_string(float num, char *buffer, int precision)
 {
+    // NaN has no digits to print
+    if (num != num) {
+        strcpy(buffer, "nan");
+        return;
+    }
+
     // Handle negative numbers
     if (num < 0) {
         *buffer++ = '-';
         num = -num;
     }
 
+    // Past 2^64 (infinity included) the integer part does not fit a uint64_t
+    if (num >= 18446744073709551616.0f) {
+        strcpy(buffer, "inf");
+        return;
+    }
+
     // Apply rounding:
     // Example: for precision=3 → add 0.0005 before truncation
     float rounding = 0.5f;
@@ -366,14 +1583,16 @@ void float_to_string(float num, char *buffer, int precision)
 
     num += rounding;
 
-    // Extract integer part
-    int int_part = (int)num;
+    // Extract integer part: WriteFloat() only gets here once the value
+    // scaled by 10^precision is past the int32 range, so it can take all 20
+    // digits of a uint64_t
+    uint64_t int_part = (uint64_t)num;
 
     // Extract fractional part
     float frac = num - (float)int_part;
 
     // Convert integer part
-    char temp[16];
+    char temp[20];
     i = 0;
     if (int_part == 0) {
         temp[i++] = '0';
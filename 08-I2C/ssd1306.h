@@ -4,45 +4,380 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-// Configure display size here:
+// Configure the size of the default display (SSD1306_Init) here:
 #define SSD1306_WIDTH 128
 #define SSD1306_HEIGHT 32   // set to 32 for 128x32 modules
 
+// Framebuffer row stride shared by every instance. It is a compile-time
+// constant so the drawing loops index with constant-folded arithmetic;
+// narrower panels keep the same stride and clip to their own width.
+#define SSD1306_STRIDE 128
+#define SSD1306_MAX_PAGES 8  // 64 rows
+#define SSD1306_BUFFER_BYTES(height) (SSD1306_STRIDE * (height) / 8)
+
+// Link to the controller, chosen at build time: I2C (ssd1306_i2c.c) or 4-wire
+// SPI on an SSI module with uDMA (ssd1306_ssi.c). Define SSD1306_TRANSPORT in
+// the project settings to override.
+#define SSD1306_TRANSPORT_I2C 0
+#define SSD1306_TRANSPORT_SSI 1
+#ifndef SSD1306_TRANSPORT
+#define SSD1306_TRANSPORT SSD1306_TRANSPORT_I2C
+#endif
+
 // I2C default address for many OLED modules:
 #define SSD1306_I2C_ADDR 0x3C
 
+// Address windows one flush may use; each takes two descriptors (window
+// command and data) in every device. Delta flushes with more scattered
+// changes than this fall back to the dirty spans.
+#ifndef SSD1306_MAX_WINDOWS
+#define SSD1306_MAX_WINDOWS 16
+#endif
+
+// Bytes of display commands (Invert, SetContrast, SetRotation, scrolling)
+// held for the next flush; at least 13, one command of each kind
+#ifndef SSD1306_CMD_QUEUE
+#define SSD1306_CMD_QUEUE 16
+#endif
+
+// Uncomment to count bus traffic per flush (see SSD1306_GetStats)
+// #define SSD1306_STATS
+
+// SCL periods of one transaction carrying n bytes (control byte included):
+// START + address/ACK + n * (8 bits + ACK) + STOP
+#define SSD1306_I2C_BIT_TIMES(n) (1 + 9 + 9 * (uint32_t)(n) + 1)
+
+// Bytes and clock periods on the wire for a transaction carrying n payload
+// bytes: I2C adds the control byte, SPI signals it on the D/C pin instead
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+#define SSD1306_LINK_BYTES(n)     ((uint32_t)(n) + 1)
+#define SSD1306_LINK_BIT_TIMES(n) SSD1306_I2C_BIT_TIMES((uint32_t)(n) + 1)
+#else
+#define SSD1306_LINK_BYTES(n)     ((uint32_t)(n))
+#define SSD1306_LINK_BIT_TIMES(n) (8 * (uint32_t)(n))
+#endif
+
+#ifdef SSD1306_STATS
+// Bus traffic counters. On I2C bytes include the control byte of each
+// transaction and every transaction is one START and one STOP on the bus.
+// Divide bit_times by the bit clock (SCL or SSI clock) to get the time spent
+// on the bus.
+typedef struct {
+    uint32_t flushes;
+    uint32_t bytes;
+    uint32_t transactions;
+    uint32_t bit_times;
+    uint32_t busy_polls;          // polls of blocking writes waiting for the link
+    uint32_t wait_polls;          // polls waiting for an async frame to finish
+    uint32_t interrupts;          // I2C master interrupts of async frames
+    uint32_t errors;              // I2C transactions aborted by NACK or lost arbitration
+    uint32_t last_bytes;          // bytes sent by the most recent Display()
+    uint32_t last_transactions;   // transactions of the most recent Display()
+    uint32_t last_bit_times;      // bus bit-times of the most recent Display()
+    uint32_t last_cpu_cycles;     // core cycles spent planning the most recent frame
+    uint32_t saved;               // bytes delta flushes avoided against the dirty spans
+    uint32_t last_saved;          // ... in the most recent Display()
+} SSD1306_Stats;
+
+void SSD1306_GetStats(SSD1306_Stats *stats);
+void SSD1306_ResetStats(void);
+// Bus time of the most recent frame at the given bit clock, in microseconds
+uint32_t SSD1306_StatsFrameMicros(const SSD1306_Stats *stats, uint32_t bit_hz);
+// Frame rate the bus sustains at that bit clock if every frame were like the
+// most recent one (0 if nothing has been sent yet)
+uint32_t SSD1306_StatsMaxFps(const SSD1306_Stats *stats, uint32_t bit_hz);
+#endif
+
+#include "ssd1306_fonts.h"
+
+typedef void (*SSD1306_DoneCallback)(bool ok);
+
+// One transfer of rows x len bytes, stride apart. control says command or
+// data: the I2C control byte, or the D/C level on SPI.
+typedef struct {
+    uint8_t control;
+    const uint8_t *data;
+    uint16_t len;       // bytes per row
+    uint16_t stride;    // distance between rows in data
+    uint8_t rows;
+} SSD1306_TxDesc;
+
+// Driver state of one panel. Treat the fields as private; allocate the
+// struct and its framebuffers statically and pass them to SSD1306_InitDevice.
+typedef struct SSD1306_Device {
+    uint32_t base;              // I2C or SSI module
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+    uint8_t  i2c_addr;
+#else
+    uint32_t dc_port;           // GPIO driving D/C: low = command, high = data
+    uint8_t  dc_pin;
+    uint32_t dma_channel;
+#endif
+    uint8_t  width;
+    uint8_t  height;            // rows held in the framebuffer
+    uint8_t  view_width;        // drawing area: width x height turned by rotation
+    uint8_t  view_height;
+    uint8_t  rotation;          // SSD1306_ROTATE_*
+    uint8_t  rows;              // rows shown by the panel (multiplex ratio)
+    uint8_t  pages;
+    uint8_t *buffer;            // drawing target (back buffer)
+    uint8_t *framebuf[2];       // framebuf[1] == NULL: no double buffering
+    bool     double_buffered;
+    bool     delta;             // diff flushes against a copy of display RAM
+    bool     shadow_valid;      // ... which is known to hold what the panel shows
+    uint8_t *shadow;            // that copy when single-buffered
+    uint8_t  dirty_x0[SSD1306_MAX_PAGES];   // dirty columns per page, clean when x0 > x1
+    uint8_t  dirty_x1[SSD1306_MAX_PAGES];
+    const FontDef *font;
+    int16_t  cursor_x;
+    int16_t  cursor_y;
+    uint8_t  start_line;        // display RAM row shown at the top
+    bool     start_pending;     // start line changed, sent after the next flush's data
+    uint8_t  term_pitch;        // terminal line height in rows, 0 when not in terminal mode
+    uint8_t  term_lines;        // terminal lines on screen so far
+    bool     term_newline;      // '\n' received, applied by the next character
+    bool     scrolling;
+    // a flush is a window command and a data burst per window, plus a start
+    // line command
+    SSD1306_TxDesc desc[2 * SSD1306_MAX_WINDOWS + 1];
+    uint8_t  window[SSD1306_MAX_WINDOWS][6];
+    uint8_t  cmd_queue[SSD1306_CMD_QUEUE];  // queued display commands
+    uint8_t  cmd_len;
+    uint8_t  cmd_sent[SSD1306_CMD_QUEUE];   // ... taken by the last flush, requeued if it fails
+    uint8_t  cmd_sent_len;
+    bool     start_sent;        // the last flush carried the start line
+    uint8_t  cmd_tx[SSD1306_CMD_QUEUE + 12];    // ... leading a flush, its first command included
+    uint8_t  tail_tx[12];       // scroll start and start line, sent after the data
+    struct {
+        const SSD1306_TxDesc *desc;
+        uint8_t count;          // descriptors left, current one included
+        uint8_t row;
+        uint16_t col;
+        uint8_t state;
+        volatile bool busy;
+        bool error;
+        SSD1306_DoneCallback done;
+    } tx;
+    struct SSD1306_Device *next;    // next device waiting for the same bus
+#ifdef SSD1306_STATS
+    SSD1306_Stats stats;
+#endif
+} SSD1306_Device;
+
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
 // User provides which I2C base (e.g. I2C0_BASE) and a small delay function if needed
 // Init call requires the Tiva I2C base address and the I2C address of the display.
+// It sets up a built-in SSD1306_WIDTH x SSD1306_HEIGHT instance and selects it.
 void SSD1306_Init(uint32_t i2c_base, uint8_t i2c_addr);
 
-// Low-level I2C control (exposed in case you need)
+// Several panels: give each its own device, geometry, bus and framebuffers of
+// SSD1306_BUFFER_BYTES(height) (backbuf may be NULL if double buffering is not
+// needed). All other calls act on the selected device; InitDevice selects the
+// new one. A panel can be drawn while another one flushes asynchronously.
+void SSD1306_InitDevice(SSD1306_Device *dev, uint32_t i2c_base, uint8_t i2c_addr,
+                        uint8_t width, uint8_t height, uint8_t *framebuf, uint8_t *backbuf);
+// Panel whose framebuffer covers all 64 rows of display RAM while showing
+// only `rows` of them (e.g. 32), so SSD1306_ScrollUp() can use the whole RAM
+// as a ring. framebuf/backbuf are SSD1306_BUFFER_BYTES(64).
+void SSD1306_InitDeviceRing(SSD1306_Device *dev, uint32_t i2c_base, uint8_t i2c_addr,
+                            uint8_t width, uint8_t rows, uint8_t *framebuf, uint8_t *backbuf);
+// Registered per I2C module by SSD1306_InitDevice(); call it from your own
+// handler instead if the vector table is static
+void SSD1306_I2CIntHandler(uint32_t i2c_base);
+#else
+// 4-wire SPI: the SSI module (clock, pins, Freescale SPI mode 0, up to 10 MHz)
+// and the uDMA clock are set up by the application, which also pulses RES#.
+// dc_port/dc_pin is the GPIO driving D/C (its port must be clocked). Frames
+// are streamed by uDMA; the driver installs a uDMA control table unless one
+// is already set.
+void SSD1306_Init(uint32_t ssi_base, uint32_t dc_port, uint8_t dc_pin);
+void SSD1306_InitDevice(SSD1306_Device *dev, uint32_t ssi_base, uint32_t dc_port, uint8_t dc_pin,
+                        uint8_t width, uint8_t height, uint8_t *framebuf, uint8_t *backbuf);
+void SSD1306_InitDeviceRing(SSD1306_Device *dev, uint32_t ssi_base, uint32_t dc_port, uint8_t dc_pin,
+                            uint8_t width, uint8_t rows, uint8_t *framebuf, uint8_t *backbuf);
+// Registered per SSI module; runs on uDMA completion
+void SSD1306_SSIIntHandler(uint32_t ssi_base);
+#endif
+void SSD1306_Select(SSD1306_Device *dev);
+SSD1306_Device *SSD1306_Selected(void);
+
+// Rotation of the drawing coordinates, for panels mounted turned clockwise
+// by that much. 180 is done by the controller (segment/COM remap) at no cost;
+// 90 and 270 swap SSD1306_Width() and SSD1306_Height() and are mapped by the
+// drawing kernels (glyphs and bitmaps through 8x8 transposes). Quarter turns
+// need a framebuffer as tall as the panel (not InitDeviceRing), and
+// ScrollUp() only works unrotated. The framebuffer is not redrawn: clear it
+// and draw again after changing. The remap is queued like the display state
+// commands below and takes effect with the next flush. Returns false if not
+// possible.
+#define SSD1306_ROTATE_0   0
+#define SSD1306_ROTATE_90  1
+#define SSD1306_ROTATE_180 2
+#define SSD1306_ROTATE_270 3
+bool SSD1306_SetRotation(uint8_t rotation);
+uint8_t SSD1306_GetRotation(void);
+int16_t SSD1306_Width(void);
+int16_t SSD1306_Height(void);
+
+// Low-level control (exposed in case you need)
 void SSD1306_Reset(void);
+// Display() only sends the page/column spans touched since the last flush
 void SSD1306_Display(void);
+// Mark the whole screen dirty so the next Display() resends everything
+void SSD1306_Invalidate(void);
+// Delta flush: diff the dirty spans against a copy of display RAM and send
+// only what changed, as one window around all changes, one window per run of
+// changed columns or the plain dirty spans, whichever costs fewest bus bit
+// times. Single-buffered panels need a shadow buffer of
+// SSD1306_BUFFER_BYTES(height) for the copy; double-buffered ones use their
+// idle half, so shadow may be NULL. on = false goes back to dirty spans.
+void SSD1306_SetDeltaFlush(bool on, uint8_t *shadow);
+
+// Non-blocking flush: queues the dirty spans and returns immediately. The
+// I2C master interrupt (or uDMA on SPI) streams them out; done (may be NULL)
+// is called from the interrupt with ok = false on a bus error. Returns false
+// if a flush is still running. Needs IntMasterEnable(). Unless double
+// buffering is on, don't draw until it has finished.
+bool SSD1306_DisplayAsync(SSD1306_DoneCallback done);
+bool SSD1306_IsBusy(void);
 void SSD1306_Clear(void);
+
+// Display state commands are queued and go out with the next flush, in the
+// same transaction as its first command, so they add no bus turnarounds. A
+// later call replaces a queued one of the same kind (the last contrast wins).
+// Rotation, the start line and scrolling are queued the same way.
+// CommitCommands() sends the queue now (waiting out a running flush) and
+// returns false on a bus error, leaving it queued.
 void SSD1306_Invert(bool invert);
 void SSD1306_SetContrast(uint8_t contrast);
+void SSD1306_SetDisplayOn(bool on);     // sleep mode off/on; RAM is kept
+bool SSD1306_CommitCommands(void);
+
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+// Bus speed: sets the I2C timer period of i2c_base for scl_hz (any rate up to
+// Fast-mode Plus, 1 MHz, and beyond if the panel and pull-ups allow it) from
+// the actual system clock, e.g. SysCtlClockGet(). Returns the rate achieved,
+// which is never above scl_hz (0 gives the slowest). Call after
+// I2CMasterInitExpClk().
+uint32_t SSD1306_SetBusSpeed(uint32_t i2c_base, uint32_t sysclk, uint32_t scl_hz);
+// Steps the selected panel's bus up from 100 kHz to at most max_hz, sending
+// a full frame at each rate and reading back the controller status. Leaves
+// the bus at the fastest rate that passed and returns the rate achieved
+// there (0: none did). Stops early once the system clock allows no faster
+// rate.
+uint32_t SSD1306_ProbeBusSpeed(uint32_t sysclk, uint32_t max_hz);
+#endif
+
+// Hardware scrolling
+// Show display RAM row `line` (0..63) at the top of the panel; RAM wraps at 64.
+// Sent after the data of the next flush.
+void SSD1306_SetStartLine(uint8_t line);
+// Scroll up by `lines` through the 64-row display RAM ring (needs a 64-row
+// framebuffer: a 128x64 panel or SSD1306_InitDeviceRing). Clears the rows
+// that come into view and returns the framebuffer y of the first one, -1 if
+// not possible. Draw the new text there; the next Display() sends only those
+// rows followed by the new start line.
+int16_t SSD1306_ScrollUp(uint8_t lines);
+
+// Terminal mode: a scrolling text console on top of ScrollUp(). Lines are
+// the current font's height rounded up to whole pages (8 rows for Font6x8:
+// 21 x 8 characters on 128x64, 21 x 4 on a 32-row ring). Text wraps at the
+// right edge; '\n' starts a new line, '\r' returns to its start. Once the
+// screen is full each new line scrolls by one start line command, so a
+// Display() after a line sends that line's page(s) and one command whatever
+// the panel height. TermInit() clears the screen and needs a 64-row
+// framebuffer, unrotated; returns false otherwise. Nothing is sent until the
+// next Display()/DisplayAsync().
+#ifndef SSD1306_TERM_PRINTF_MAX
+#define SSD1306_TERM_PRINTF_MAX 96  // longest SSD1306_TermPrintf() output, with the NUL
+#endif
+bool SSD1306_TermInit(void);
+void SSD1306_TermPutc(char c);
+// Stream input: chunks may split lines anywhere
+void SSD1306_TermWrite(const char *s, uint32_t len);
+// printf() formatting through the C library's vsnprintf()
+void SSD1306_TermPrintf(const char *fmt, ...);
+
+// Continuous scrolling done by the controller; the bus and CPU stay idle.
+// interval is one of the SSD1306_SCROLL_* frame counts below. Start and stop
+// are queued: a start goes out after the data of the next flush (or with
+// CommitCommands()), a stop ahead of it. Don't send frames while scrolling
+// other than the one stopping it: horizontal scrolling moves display RAM, so
+// StopScroll() marks the screen for a full rewrite.
+#define SSD1306_SCROLL_2_FRAMES   7
+#define SSD1306_SCROLL_3_FRAMES   4
+#define SSD1306_SCROLL_4_FRAMES   5
+#define SSD1306_SCROLL_5_FRAMES   0
+#define SSD1306_SCROLL_25_FRAMES  6
+#define SSD1306_SCROLL_64_FRAMES  1
+#define SSD1306_SCROLL_128_FRAMES 2
+#define SSD1306_SCROLL_256_FRAMES 3
+void SSD1306_ScrollHorizontal(bool left, uint8_t start_page, uint8_t end_page, uint8_t interval);
+// Horizontal plus vertical_step rows per step (1..63)
+void SSD1306_ScrollDiagonal(bool left, uint8_t start_page, uint8_t end_page, uint8_t interval, uint8_t vertical_step);
+void SSD1306_StopScroll(void);
+bool SSD1306_IsScrolling(void);
 
 // Drawing primitives
 void SSD1306_DrawPixel(int16_t x, int16_t y, bool color);
 void SSD1306_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool color);
+// Horizontal/vertical lines and fills are written a page byte at a time
+void SSD1306_DrawHLine(int16_t x, int16_t y, int16_t w, bool color);
+void SSD1306_DrawVLine(int16_t x, int16_t y, int16_t h, bool color);
 void SSD1306_DrawRect(int16_t x, int16_t y, int16_t w, int16_t h, bool color);
 void SSD1306_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, bool color);
 void SSD1306_DrawCircle(int16_t x0, int16_t y0, int16_t r, bool color);
+// Fills are drawn as vertical spans straight into page bytes
+void SSD1306_FillCircle(int16_t x0, int16_t y0, int16_t r, bool color);
+void SSD1306_DrawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool color);
+void SSD1306_FillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool color);
+// Corner radius r is clamped to half the shorter side
+void SSD1306_DrawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, bool color);
+void SSD1306_FillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, bool color);
+// Arcs run clockwise from start_deg to end_deg, 0 degrees at 3 o'clock;
+// start == end draws nothing, end = start + 360 a full ring. FillArc covers
+// the ring between r_inner and r_outer (a gauge segment; r_inner 0 = pie
+// slice), DrawArc is one pixel wide.
+void SSD1306_FillArc(int16_t x0, int16_t y0, int16_t r_outer, int16_t r_inner,
+                     int16_t start_deg, int16_t end_deg, bool color);
+void SSD1306_DrawArc(int16_t x0, int16_t y0, int16_t r, int16_t start_deg, int16_t end_deg, bool color);
 
-// Bitmap (monochrome): width in pixels, height in pixels, bitmap array in bytes (column-major or row-major as produced by typical tools)
+// Bitmap (monochrome): width in pixels, height in pixels, bitmap array in bytes
+// (8 vertical pixels per byte, LSB on top, one row of w bytes per 8-pixel band)
+// DrawBitmap is opaque: set bits in color, clear bits in !color.
 void SSD1306_DrawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, bool color);
 
+// Raster ops for BlitBitmap, applied to the set bits of the source
+typedef enum {
+    SSD1306_ROP_COPY,     // replace: set bits on, clear bits off
+    SSD1306_ROP_OR,       // transparent: set bits on, background kept
+    SSD1306_ROP_ANDNOT,   // erase: set bits off
+    SSD1306_ROP_XOR       // toggle: drawing twice restores the background
+} SSD1306_RasterOp;
+void SSD1306_BlitBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, SSD1306_RasterOp rop);
+
 // Text
-#include "ssd1306_fonts.h"
 void ssd1306_SetFont(const FontDef *font);
 void SSD1306_SetCursor(int16_t x, int16_t y);
 void SSD1306_WriteChar(char c);
 void SSD1306_WriteString(const char *s);
 void SSD1306_WriteInt(int32_t val);
-void SSD1306_WriteFloat(float val, uint8_t decimals);;
+// Rounded to decimals (<= 9); magnitudes of 2^64 and more print as "inf"
+void SSD1306_WriteFloat(float val, uint8_t decimals);
+// Fixed-point: prints value / 10^decimals (decimals <= 9) without float,
+// e.g. SSD1306_WriteFixed(-2345, 2) -> "-23.45"
+void SSD1306_WriteFixed(int32_t value, uint8_t decimals);
+// Same text into buf (room for 13 chars); returns its length
+uint8_t SSD1306_FormatFixed(char *buf, int32_t value, uint8_t decimals);
 
-// Advanced: set to true to buffer writes and call Display() to flush
+// Double buffering: after DisplayOnBuffer() drawing goes to a back buffer and
+// DisplayFlush() swaps it to the front and streams it out in the background
+// (interrupt-driven, see DisplayAsync). Drawing the next frame can start
+// right away; Flush only waits if the previous frame is still being sent.
+// FrameDone()/WaitFrame() poll or wait for the frame on the bus to complete.
 void SSD1306_DisplayOnBuffer(void);
 void SSD1306_DisplayFlush(void);
+bool SSD1306_FrameDone(void);
+void SSD1306_WaitFrame(void);
 
 #endif // SSD1306_H
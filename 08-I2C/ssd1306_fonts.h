@@ -4,315 +4,24 @@
 #include <stdint.h>
 
 // FontDef structure
+// Glyphs cover character codes first..last. With map == NULL the glyphs are
+// stored densely (code - first); otherwise map[code - first] is the glyph slot
+// in data, or SSD1306_GLYPH_NONE if the subset left that character out.
 typedef struct {
     const uint8_t width; // pixels
     const uint8_t height; // pixels
     const uint16_t bytes_per_char;
     const uint8_t *data;
+    const uint8_t first;
+    const uint8_t last;
+    const uint8_t *map;
 } FontDef;
 
-// ----------------- Font6x8 (complete ASCII 32..126) -----------------
-// Each character is 6 bytes (columns), height 8. Stored column-major, LSB is top pixel.
-// Total bytes = 95 chars * 6 = 570 bytes
-static const uint8_t Font6x8_data[] = {
-0x00,0x00,0x00,0x00,0x00,0x00, /* 32 ' ' */
-0x00,0x00,0x5F,0x00,0x00,0x00, /* 33 '!' */
-0x00,0x07,0x00,0x07,0x00,0x00, /* 34 '"' */
-0x14,0x7F,0x14,0x7F,0x14,0x00, /* 35 '#' */
-0x24,0x2A,0x7F,0x2A,0x12,0x00, /* 36 '$' */
-0x23,0x13,0x08,0x64,0x62,0x00, /* 37 '%' */
-0x36,0x49,0x55,0x22,0x50,0x00, /* 38 '&' */
-0x00,0x05,0x03,0x00,0x00,0x00, /* 39 ''' */
-0x00,0x1C,0x22,0x41,0x00,0x00, /* 40 '(' */
-0x00,0x41,0x22,0x1C,0x00,0x00, /* 41 ')' */
-0x14,0x08,0x3E,0x08,0x14,0x00, /* 42 '*' */
-0x08,0x08,0x3E,0x08,0x08,0x00, /* 43 '+' */
-0x00,0x50,0x30,0x00,0x00,0x00, /* 44 ',' */
-0x08,0x08,0x08,0x08,0x08,0x00, /* 45 '-' */
-0x00,0x60,0x60,0x00,0x00,0x00, /* 46 '.' */
-0x20,0x10,0x08,0x04,0x02,0x00, /* 47 '/' */
-0x3E,0x51,0x49,0x45,0x3E,0x00, /* 48 '0' */
-0x00,0x42,0x7F,0x40,0x00,0x00, /* 49 '1' */
-0x62,0x51,0x49,0x49,0x46,0x00, /* 50 '2' */
-0x22,0x49,0x49,0x49,0x36,0x00, /* 51 '3' */
-0x18,0x14,0x12,0x7F,0x10,0x00, /* 52 '4' */
-0x2F,0x49,0x49,0x49,0x31,0x00, /* 53 '5' */
-0x3C,0x4A,0x49,0x49,0x30,0x00, /* 54 '6' */
-0x03,0x71,0x09,0x05,0x03,0x00, /* 55 '7' */
-0x36,0x49,0x49,0x49,0x36,0x00, /* 56 '8' */
-0x06,0x49,0x49,0x29,0x1E,0x00, /* 57 '9' */
-0x00,0x36,0x36,0x00,0x00,0x00, /* 58 ':' */
-0x00,0x56,0x36,0x00,0x00,0x00, /* 59 ';' */
-0x08,0x14,0x22,0x41,0x00,0x00, /* 60 '<' */
-0x14,0x14,0x14,0x14,0x14,0x00, /* 61 '=' */
-0x00,0x41,0x22,0x14,0x08,0x00, /* 62 '>' */
-0x02,0x01,0x51,0x09,0x06,0x00, /* 63 '?' */
-0x32,0x49,0x79,0x41,0x3E,0x00, /* 64 '@' */
-0x7E,0x11,0x11,0x11,0x7E,0x00, /* 65 'A' */
-0x7F,0x49,0x49,0x49,0x36,0x00, /* 66 'B' */
-0x3E,0x41,0x41,0x41,0x22,0x00, /* 67 'C' */
-0x7F,0x41,0x41,0x22,0x1C,0x00, /* 68 'D' */
-0x7F,0x49,0x49,0x49,0x41,0x00, /* 69 'E' */
-0x7F,0x09,0x09,0x09,0x01,0x00, /* 70 'F' */
-0x3E,0x41,0x49,0x49,0x7A,0x00, /* 71 'G' */
-0x7F,0x08,0x08,0x08,0x7F,0x00, /* 72 'H' */
-0x00,0x41,0x7F,0x41,0x00,0x00, /* 73 'I' */
-0x20,0x40,0x41,0x3F,0x01,0x00, /* 74 'J' */
-0x7F,0x08,0x14,0x22,0x41,0x00, /* 75 'K' */
-0x7F,0x40,0x40,0x40,0x40,0x00, /* 76 'L' */
-0x7F,0x02,0x0C,0x02,0x7F,0x00, /* 77 'M' */
-0x7F,0x04,0x08,0x10,0x7F,0x00, /* 78 'N' */
-0x3E,0x41,0x41,0x41,0x3E,0x00, /* 79 'O' */
-0x7F,0x09,0x09,0x09,0x06,0x00, /* 80 'P' */
-0x3E,0x41,0x51,0x21,0x5E,0x00, /* 81 'Q' */
-0x7F,0x09,0x19,0x29,0x46,0x00, /* 82 'R' */
-0x46,0x49,0x49,0x49,0x31,0x00, /* 83 'S' */
-0x01,0x01,0x7F,0x01,0x01,0x00, /* 84 'T' */
-0x3F,0x40,0x40,0x40,0x3F,0x00, /* 85 'U' */
-0x1F,0x20,0x40,0x20,0x1F,0x00, /* 86 'V' */
-0x3F,0x40,0x38,0x40,0x3F,0x00, /* 87 'W' */
-0x63,0x14,0x08,0x14,0x63,0x00, /* 88 'X' */
-0x07,0x08,0x70,0x08,0x07,0x00, /* 89 'Y' */
-0x61,0x51,0x49,0x45,0x43,0x00, /* 90 'Z' */
-0x00,0x7F,0x41,0x41,0x00,0x00, /* 91 '[' */
-0x02,0x04,0x08,0x10,0x20,0x00, /* 92 '\' */
-0x00,0x41,0x41,0x7F,0x00,0x00, /* 93 ']' */
-0x04,0x02,0x01,0x02,0x04,0x00, /* 94 '^' */
-0x40,0x40,0x40,0x40,0x40,0x00, /* 95 '_' */
-0x00,0x01,0x02,0x04,0x00,0x00, /* 96 '`' */
-0x20,0x54,0x54,0x54,0x78,0x00, /* 97 'a' */
-0x7F,0x48,0x44,0x44,0x38,0x00, /* 98 'b' */
-0x38,0x44,0x44,0x44,0x20,0x00, /* 99 'c' */
-0x38,0x44,0x44,0x48,0x7F,0x00, /*100 'd' */
-0x38,0x54,0x54,0x54,0x18,0x00, /*101 'e' */
-0x08,0x7E,0x09,0x01,0x02,0x00, /*102 'f' */
-0x0C,0x52,0x52,0x52,0x3E,0x00, /*103 'g' */
-0x7F,0x08,0x04,0x04,0x78,0x00, /*104 'h' */
-0x00,0x44,0x7D,0x40,0x00,0x00, /*105 'i' */
-0x20,0x40,0x44,0x3D,0x00,0x00, /*106 'j' */
-0x7F,0x10,0x28,0x44,0x00,0x00, /*107 'k' */
-0x00,0x41,0x7F,0x40,0x00,0x00, /*108 'l' */
-0x7C,0x04,0x18,0x04,0x78,0x00, /*109 'm' */
-0x7C,0x08,0x04,0x04,0x78,0x00, /*110 'n' */
-0x38,0x44,0x44,0x44,0x38,0x00, /*111 'o' */
-0x7C,0x14,0x14,0x14,0x08,0x00, /*112 'p' */
-0x08,0x14,0x14,0x18,0x7C,0x00, /*113 'q' */
-0x7C,0x08,0x04,0x04,0x08,0x00, /*114 'r' */
-0x48,0x54,0x54,0x54,0x20,0x00, /*115 's' */
-0x04,0x3F,0x44,0x40,0x20,0x00, /*116 't' */
-0x3C,0x40,0x40,0x20,0x7C,0x00, /*117 'u' */
-0x1C,0x20,0x40,0x20,0x1C,0x00, /*118 'v' */
-0x3C,0x40,0x30,0x40,0x3C,0x00, /*119 'w' */
-0x44,0x28,0x10,0x28,0x44,0x00, /*120 'x' */
-0x0C,0x50,0x50,0x50,0x3C,0x00, /*121 'y' */
-0x44,0x64,0x54,0x4C,0x44,0x00, /*122 'z' */
-0x00,0x08,0x36,0x41,0x00,0x00, /*123 '{' */
-0x00,0x00,0x7F,0x00,0x00,0x00, /*124 '|' */
-0x00,0x41,0x36,0x08,0x00,0x00, /*125 '}' */
-0x02,0x01,0x02,0x04,0x02,0x00, /*126 '~' */
-};
+#define SSD1306_GLYPH_NONE 0xFF
 
-// FontDef for 6x8
-static const FontDef Font6x8 = {6, 8, 6, Font6x8_data};
-
-
-static const uint8_t Font8x12_bold_data[] = {
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 32 ' ' */
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0x02, 0x08, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 33 '!' */
-  0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 34 '"' */
-  0x00, 0x00, 0xa0, 0x00, 0xf8, 0x03, 0xa0, 0x00, 0xf8, 0x03, 0xa8, 0x00, 0x00, 0x00, 0x00, 0x00, /* 35 '#' */
-  0x00, 0x00, 0xb0, 0x01, 0x30, 0x01, 0x4c, 0x07, 0x50, 0x01, 0xd0, 0x01, 0x00, 0x00, 0x00, 0x00, /* 36 '$' */
-  0x00, 0x00, 0x98, 0x00, 0x64, 0x00, 0xfc, 0x03, 0xc0, 0x02, 0xa0, 0x03, 0x00, 0x00, 0x00, 0x00, /* 37 '%' */
-  0x00, 0x00, 0x80, 0x03, 0xf0, 0x02, 0x90, 0x03, 0x90, 0x03, 0x80, 0x02, 0x00, 0x00, 0x00, 0x00, /* 38 '&' */
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 39 ''' */
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0x01, 0xf8, 0x07, 0x0c, 0x0c, 0x00, 0x00, 0x00, 0x00, /* 40 '(' */
-  0x00, 0x00, 0x00, 0x08, 0x18, 0x0e, 0xf0, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 41 ')' */
-  0x00, 0x00, 0x10, 0x00, 0x50, 0x00, 0x38, 0x00, 0x70, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, /* 42 '*' */
-  0x40, 0x00, 0x40, 0x00, 0x40, 0x00, 0xf0, 0x03, 0x40, 0x00, 0x40, 0x00, 0x40, 0x00, 0x00, 0x00, /* 43 '+' */
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 44 ',' */
-  0x40, 0x00, 0x40, 0x00, 0x40, 0x00, 0x40, 0x00, 0x40, 0x00, 0x40, 0x00, 0x40, 0x00, 0x00, 0x00, /* 45 '-' */
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 46 '.' */
-  0x00, 0x00, 0x00, 0x04, 0x80, 0x03, 0xe0, 0x00, 0x38, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, /* 47 '/' */
-  0x00, 0x00, 0xf0, 0x01, 0x18, 0x03, 0x08, 0x02, 0x08, 0x02, 0xf0, 0x01, 0x00, 0x00, 0x00, 0x00, /* 48 '0' */
-  0x00, 0x00, 0x10, 0x02, 0x18, 0x02, 0xf8, 0x03, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, /* 49 '1' */
-  0x00, 0x00, 0x10, 0x02, 0x08, 0x03, 0x88, 0x02, 0x48, 0x02, 0x30, 0x02, 0x00, 0x00, 0x00, 0x00, /* 50 '2' */
-  0x00, 0x00, 0x08, 0x02, 0x08, 0x02, 0x48, 0x02, 0x48, 0x02, 0xb0, 0x03, 0x00, 0x00, 0x00, 0x00, /* 51 '3' */
-  0x00, 0x00, 0xc0, 0x00, 0xe0, 0x00, 0x98, 0x02, 0xf8, 0x03, 0x80, 0x02, 0x00, 0x00, 0x00, 0x00, /* 52 '4' */
-  0x00, 0x00, 0x78, 0x02, 0x78, 0x02, 0x28, 0x02, 0x28, 0x02, 0xc8, 0x01, 0x00, 0x00, 0x00, 0x00, /* 53 '5' */
-  0x00, 0x00, 0xe0, 0x00, 0xf0, 0x03, 0x28, 0x02, 0x28, 0x02, 0xe8, 0x03, 0x00, 0x00, 0x00, 0x00, /* 54 '6' */
-  0x00, 0x00, 0x08, 0x00, 0x08, 0x00, 0x08, 0x03, 0xe8, 0x01, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, /* 55 '7' */
-  0x00, 0x00, 0xb0, 0x01, 0x48, 0x02, 0x48, 0x02, 0x48, 0x02, 0xb0, 0x01, 0x00, 0x00, 0x00, 0x00, /* 56 '8' */
-  0x00, 0x00, 0x30, 0x02, 0x78, 0x02, 0x48, 0x02, 0x48, 0x01, 0xf0, 0x01, 0x00, 0x00, 0x00, 0x00, /* 57 '9' */
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 58 ':' */
-  0x00, 0x00, 0x00, 0x00, 0x20, 0x0e, 0x20, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 59 ';' */
-  0x00, 0x00, 0x40, 0x00, 0xc0, 0x00, 0xa0, 0x00, 0xa0, 0x01, 0x10, 0x01, 0x10, 0x00, 0x00, 0x00, /* 60 '<' */
-  0xa0, 0x00, 0xa0, 0x00, 0xa0, 0x00, 0xa0, 0x00, 0xa0, 0x00, 0xa0, 0x00, 0xa0, 0x00, 0x00, 0x00, /* 61 '=' */
-  0x00, 0x00, 0x10, 0x01, 0x20, 0x01, 0xa0, 0x00, 0xc0, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, /* 62 '>' */
-  0x00, 0x00, 0x18, 0x00, 0x08, 0x00, 0xc8, 0x02, 0x48, 0x02, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, /* 63 '?' */
-  0x00, 0x00, 0xf0, 0x07, 0x18, 0x0c, 0xe8, 0x09, 0x28, 0x09, 0xf0, 0x05, 0x00, 0x00, 0x00, 0x00, /* 64 '@' */
-  0x00, 0x02, 0xc8, 0x03, 0xf8, 0x02, 0x98, 0x00, 0xf0, 0x02, 0xc0, 0x03, 0x00, 0x02, 0x00, 0x00, /* 65 'A' */
-  0x08, 0x02, 0xf8, 0x03, 0x48, 0x02, 0x48, 0x02, 0x48, 0x02, 0xf8, 0x02, 0x80, 0x01, 0x00, 0x00, /* 66 'B' */
-  0xe0, 0x00, 0xf0, 0x01, 0x08, 0x02, 0x08, 0x02, 0x08, 0x02, 0x38, 0x03, 0x38, 0x01, 0x00, 0x00, /* 67 'C' */
-  0x08, 0x02, 0xf8, 0x03, 0x08, 0x02, 0x08, 0x02, 0x08, 0x02, 0xf0, 0x01, 0xe0, 0x00, 0x00, 0x00, /* 68 'D' */
-  0x08, 0x02, 0xf8, 0x03, 0x48, 0x02, 0xe8, 0x02, 0xe8, 0x02, 0xb8, 0x03, 0x80, 0x03, 0x00, 0x00, /* 69 'E' */
-  0x08, 0x02, 0xf8, 0x03, 0x48, 0x02, 0xe8, 0x02, 0xe8, 0x00, 0x38, 0x00, 0x38, 0x00, 0x00, 0x00, /* 70 'F' */
-  0xe0, 0x00, 0xf0, 0x01, 0x08, 0x02, 0x88, 0x02, 0x88, 0x02, 0xb8, 0x03, 0xb8, 0x01, 0x00, 0x00, /* 71 'G' */
-  0x00, 0x02, 0xf8, 0x03, 0x48, 0x02, 0x40, 0x00, 0x48, 0x02, 0xf8, 0x03, 0x08, 0x02, 0x00, 0x00, /* 72 'H' */
-  0x00, 0x00, 0x08, 0x02, 0x08, 0x02, 0xf8, 0x03, 0x08, 0x02, 0x08, 0x02, 0x00, 0x00, 0x00, 0x00, /* 73 'I' */
-  0x80, 0x01, 0x80, 0x03, 0x08, 0x02, 0x08, 0x02, 0xf8, 0x03, 0xf8, 0x01, 0x08, 0x00, 0x00, 0x00, /* 74 'J' */
-  0x08, 0x02, 0xf8, 0x03, 0x48, 0x02, 0x68, 0x02, 0xf8, 0x01, 0x18, 0x03, 0x08, 0x02, 0x00, 0x00, /* 75 'K' */
-  0x08, 0x02, 0x08, 0x02, 0xf8, 0x03, 0x08, 0x02, 0x08, 0x02, 0x00, 0x02, 0x80, 0x03, 0x00, 0x00, /* 76 'L' */
-  0xf8, 0x03, 0xf8, 0x03, 0x70, 0x02, 0xc0, 0x01, 0xe0, 0x02, 0x38, 0x02, 0xf8, 0x03, 0x00, 0x00, /* 77 'M' */
-  0x08, 0x02, 0xf8, 0x03, 0x30, 0x02, 0x60, 0x00, 0x88, 0x01, 0xf8, 0x03, 0x08, 0x00, 0x00, 0x00, /* 78 'N' */
-  0xe0, 0x00, 0xb0, 0x01, 0x08, 0x02, 0x08, 0x02, 0x08, 0x02, 0x10, 0x01, 0xe0, 0x00, 0x00, 0x00, /* 79 'O' */
-  0x08, 0x02, 0xf8, 0x03, 0x48, 0x02, 0x48, 0x02, 0x48, 0x00, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, /* 80 'P' */
-  0xe0, 0x00, 0xb0, 0x09, 0x08, 0x0e, 0x08, 0x0a, 0x08, 0x0a, 0x10, 0x09, 0xe0, 0x0c, 0x00, 0x00, /* 81 'Q' */
-  0x08, 0x02, 0xf8, 0x03, 0x48, 0x02, 0x48, 0x00, 0xc8, 0x00, 0x30, 0x03, 0x00, 0x02, 0x00, 0x00, /* 82 'R' */
-  0x00, 0x00, 0x30, 0x03, 0x48, 0x02, 0x48, 0x02, 0x48, 0x02, 0x98, 0x03, 0x00, 0x00, 0x00, 0x00, /* 83 'S' */
-  0x18, 0x00, 0x38, 0x02, 0x08, 0x02, 0xf8, 0x03, 0x08, 0x02, 0x18, 0x02, 0x38, 0x00, 0x00, 0x00, /* 84 'T' */
-  0x08, 0x00, 0xf8, 0x01, 0x08, 0x02, 0x00, 0x02, 0x08, 0x02, 0xf8, 0x01, 0x08, 0x00, 0x00, 0x00, /* 85 'U' */
-  0x08, 0x00, 0x38, 0x00, 0xe8, 0x01, 0x00, 0x03, 0xc8, 0x01, 0x78, 0x00, 0x08, 0x00, 0x00, 0x00, /* 86 'V' */
-  0x18, 0x00, 0xf8, 0x03, 0xc8, 0x03, 0x60, 0x00, 0xc8, 0x01, 0xe8, 0x03, 0x38, 0x00, 0x00, 0x00, /* 87 'W' */
-  0x08, 0x02, 0x18, 0x03, 0xb8, 0x03, 0xe0, 0x00, 0xb8, 0x03, 0x18, 0x03, 0x08, 0x02, 0x00, 0x00, /* 88 'X' */
-  0x08, 0x00, 0x18, 0x02, 0x38, 0x02, 0xc0, 0x03, 0x78, 0x02, 0x18, 0x02, 0x08, 0x00, 0x00, 0x00, /* 89 'Y' */
-  0x00, 0x00, 0x38, 0x03, 0x88, 0x03, 0x68, 0x02, 0x38, 0x02, 0x98, 0x03, 0x00, 0x00, 0x00, 0x00, /* 90 'Z' */
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0x0f, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, /* 91 '[' */
-  0x00, 0x00, 0x04, 0x00, 0x38, 0x00, 0xe0, 0x00, 0x80, 0x03, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, /* 92 '\' */
-  0x00, 0x00, 0x08, 0x00, 0x08, 0x08, 0xf8, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 93 ']' */
-  0x00, 0x00, 0x20, 0x00, 0x18, 0x00, 0x0c, 0x00, 0x18, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, /* 94 '^' */
-  0x00, 0x08, 0x00, 0x08, 0x00, 0x08, 0x00, 0x08, 0x00, 0x08, 0x00, 0x08, 0x00, 0x08, 0x00, 0x00, /* 95 '_' */
-  0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 96 '`' */
-  0x00, 0x00, 0xa0, 0x03, 0xa0, 0x02, 0xa0, 0x02, 0xa0, 0x02, 0xc0, 0x03, 0x00, 0x02, 0x00, 0x00, /* 97 'a' */
-  0x08, 0x02, 0xf8, 0x03, 0x60, 0x02, 0x20, 0x02, 0x20, 0x02, 0x60, 0x03, 0xc0, 0x01, 0x00, 0x00, /* 98 'b' */
-  0x00, 0x00, 0xc0, 0x03, 0x20, 0x02, 0x20, 0x02, 0x20, 0x02, 0xe0, 0x02, 0x00, 0x00, 0x00, 0x00, /* 99 'c' */
-  0x80, 0x01, 0xe0, 0x03, 0x20, 0x02, 0x20, 0x02, 0x28, 0x02, 0xf8, 0x03, 0x00, 0x02, 0x00, 0x00, /* 100 'd' */
-  0x80, 0x00, 0xc0, 0x01, 0xa0, 0x02, 0xa0, 0x02, 0xa0, 0x02, 0xc0, 0x02, 0x80, 0x00, 0x00, 0x00, /* 101 'e' */
-  0x00, 0x00, 0x20, 0x02, 0xf0, 0x03, 0xf8, 0x03, 0x28, 0x02, 0x28, 0x02, 0x08, 0x00, 0x00, 0x00, /* 102 'f' */
-  0x80, 0x00, 0xe0, 0x01, 0x20, 0x0a, 0x20, 0x0a, 0x20, 0x0b, 0xe0, 0x07, 0x20, 0x00, 0x00, 0x00, /* 103 'g' */
-  0x08, 0x02, 0xf8, 0x03, 0x60, 0x02, 0x20, 0x00, 0x20, 0x02, 0xc0, 0x03, 0x00, 0x02, 0x00, 0x00, /* 104 'h' */
-  0x00, 0x00, 0x20, 0x02, 0x20, 0x02, 0xe8, 0x03, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, /* 105 'i' */
-  0x00, 0x00, 0x20, 0x08, 0x20, 0x08, 0x28, 0x08, 0xe8, 0x0f, 0xe0, 0x03, 0x00, 0x00, 0x00, 0x00, /* 106 'j' */
-  0x08, 0x02, 0xf8, 0x03, 0xf8, 0x03, 0xe0, 0x01, 0x60, 0x03, 0x20, 0x02, 0x00, 0x02, 0x00, 0x00, /* 107 'k' */
-  0x00, 0x00, 0x08, 0x02, 0x08, 0x02, 0xf8, 0x03, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, /* 108 'l' */
-  0xe0, 0x03, 0xe0, 0x03, 0x20, 0x00, 0xe0, 0x03, 0x20, 0x02, 0xe0, 0x03, 0xc0, 0x03, 0x00, 0x00, /* 109 'm' */
-  0x20, 0x02, 0xe0, 0x03, 0x60, 0x02, 0x20, 0x00, 0x20, 0x02, 0xe0, 0x03, 0x00, 0x02, 0x00, 0x00, /* 110 'n' */
-  0x80, 0x00, 0xc0, 0x01, 0x20, 0x02, 0x20, 0x02, 0x20, 0x02, 0xc0, 0x01, 0x80, 0x00, 0x00, 0x00, /* 111 'o' */
-  0x20, 0x08, 0xe0, 0x0f, 0x60, 0x0b, 0x20, 0x0a, 0x20, 0x02, 0x60, 0x03, 0xc0, 0x01, 0x00, 0x00, /* 112 'p' */
-  0xc0, 0x01, 0x60, 0x03, 0x20, 0x02, 0x20, 0x02, 0x20, 0x0a, 0xe0, 0x0f, 0x20, 0x08, 0x00, 0x00, /* 113 'q' */
-  0x00, 0x00, 0x20, 0x02, 0xe0, 0x03, 0x40, 0x02, 0x20, 0x02, 0x20, 0x02, 0x20, 0x00, 0x00, 0x00, /* 114 'r' */
-  0x00, 0x00, 0xc0, 0x02, 0xa0, 0x03, 0xa0, 0x03, 0xa0, 0x03, 0x60, 0x03, 0x00, 0x00, 0x00, 0x00, /* 115 's' */
-  0x20, 0x00, 0xf8, 0x01, 0xf8, 0x03, 0x20, 0x02, 0x20, 0x02, 0x20, 0x02, 0x00, 0x00, 0x00, 0x00, /* 116 't' */
-  0x20, 0x00, 0xe0, 0x01, 0x00, 0x02, 0x00, 0x02, 0x20, 0x02, 0xe0, 0x03, 0x00, 0x02, 0x00, 0x00, /* 117 'u' */
-  0x20, 0x00, 0x60, 0x00, 0xe0, 0x01, 0x00, 0x03, 0xa0, 0x01, 0x60, 0x00, 0x20, 0x00, 0x00, 0x00, /* 118 'v' */
-  0x20, 0x00, 0xe0, 0x01, 0x20, 0x03, 0xc0, 0x00, 0xa0, 0x03, 0xe0, 0x03, 0x20, 0x00, 0x00, 0x00, /* 119 'w' */
-  0x20, 0x02, 0x20, 0x03, 0x60, 0x03, 0x80, 0x00, 0xe0, 0x03, 0x60, 0x03, 0x20, 0x02, 0x00, 0x00, /* 120 'x' */
-  0x20, 0x08, 0x60, 0x08, 0xa0, 0x09, 0x00, 0x0f, 0xa0, 0x01, 0x60, 0x00, 0x20, 0x00, 0x00, 0x00, /* 121 'y' */
-  0x00, 0x00, 0x60, 0x02, 0x20, 0x03, 0xa0, 0x02, 0x60, 0x02, 0x20, 0x02, 0x00, 0x00, 0x00, 0x00, /* 122 'z' */
-  0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x78, 0x0f, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 123 '{' */
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* 124 '|' */
-  0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x78, 0x0f, 0x80, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, /* 125 '}' */
-  0x00, 0x00, 0xc0, 0x00, 0x40, 0x00, 0xc0, 0x00, 0x80, 0x00, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, /* 126 '~' */
-};
-static const FontDef Font8x12_bold = { 8, 12, 16, Font8x12_bold_data };
-
-static const uint8_t Font12x16_data[] = {
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 32 ' ' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xf8,0x11,0x00,0x10,0x00,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 33 '!' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x08,0x00,0xf8,0x00,0x00,0x00,0x18,0x00,0x18,0x00,0xf8,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 34 '"' */
-0x00,0x00,0x00,0x00,0x00,0x02,0x40,0x02,0xf8,0x1f,0x40,0x02,0xf0,0x1f,0xf0,0x1f,0x48,0x02,0x40,0x02,0x00,0x00,0x00,0x00, /* 35 '#' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x60,0x04,0x90,0x08,0x98,0x18,0x90,0x08,0x90,0x08,0x30,0x09,0x00,0x07,0x00,0x00,0x00,0x00, /* 36 '$' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x30,0x02,0x48,0x01,0x48,0x0d,0x30,0x13,0x30,0x13,0x80,0x12,0x80,0x0c,0x00,0x00,0x00,0x00, /* 37 '%' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x40,0x0e,0xb0,0x11,0x10,0x16,0x10,0x08,0x10,0x08,0x00,0x16,0x00,0x12,0x00,0x00,0x00,0x00, /* 38 '&' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xf8,0x00,0x38,0x00,0x38,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 39 ''' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xe0,0x1f,0xe0,0x1f,0x10,0x60,0x00,0x00,0x00,0x00,0x00,0x00, /* 40 '(' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x08,0x40,0x70,0x30,0x80,0x0f,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 41 ')' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x00,0xa0,0x01,0x78,0x00,0xc0,0x00,0xc0,0x00,0x20,0x01,0x20,0x00,0x00,0x00,0x00,0x00, /* 42 '*' */
-0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x01,0x00,0x01,0xe0,0x0f,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x00,0x00,0x00, /* 43 '+' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x60,0x00,0x3c,0x00,0x0c,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 44 ',' */
-0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x00,0x00,0x00, /* 45 '-' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x18,0x00,0x18,0x00,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 46 '.' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x30,0x00,0x0c,0x00,0x03,0xe0,0x00,0xe0,0x00,0x18,0x00,0x04,0x00,0x00,0x00,0x00,0x00, /* 47 '/' */
-0x00,0x00,0x00,0x00,0x00,0x00,0xf0,0x0f,0x08,0x18,0x08,0x10,0x08,0x10,0x08,0x10,0x10,0x08,0xe0,0x07,0x00,0x00,0x00,0x00, /* 48 '0' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x10,0x10,0x10,0xf8,0x1f,0x00,0x10,0x00,0x10,0x00,0x10,0x00,0x10,0x00,0x00,0x00,0x00, /* 49 '1' */
-0x00,0x00,0x00,0x00,0x20,0x10,0x10,0x18,0x08,0x14,0x08,0x12,0x08,0x11,0x08,0x11,0x90,0x10,0x60,0x10,0x00,0x00,0x00,0x00, /* 50 '2' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x08,0x08,0x08,0x10,0x88,0x10,0x88,0x10,0x88,0x10,0x58,0x09,0x20,0x0e,0x00,0x00,0x00,0x00, /* 51 '3' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x07,0xc0,0x04,0x30,0x14,0x08,0x14,0x08,0x14,0xf8,0x1f,0x00,0x14,0x00,0x00,0x00,0x00, /* 52 '4' */
-0x00,0x00,0x00,0x00,0x00,0x00,0xf8,0x08,0x48,0x10,0x48,0x10,0x48,0x10,0x48,0x10,0x48,0x08,0x80,0x07,0x00,0x00,0x00,0x00, /* 53 '5' */
-0x00,0x00,0x00,0x00,0x00,0x00,0xc0,0x07,0x20,0x09,0x90,0x10,0x88,0x10,0x88,0x10,0x88,0x10,0x08,0x0f,0x00,0x00,0x00,0x00, /* 54 '6' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x08,0x00,0x08,0x00,0x08,0x18,0x08,0x07,0x08,0x07,0xf8,0x00,0x08,0x00,0x00,0x00,0x00,0x00, /* 55 '7' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x70,0x0f,0x88,0x11,0x88,0x10,0x88,0x10,0x88,0x10,0x50,0x09,0x20,0x06,0x00,0x00,0x00,0x00, /* 56 '8' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x60,0x10,0x98,0x11,0x08,0x11,0x08,0x19,0x08,0x19,0x98,0x0c,0xe0,0x03,0x00,0x00,0x00,0x00, /* 57 '9' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xc0,0x18,0xc0,0x18,0xc0,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 58 ':' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x40,0xc0,0x38,0xc0,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 59 ';' */
-0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x03,0x80,0x02,0x80,0x04,0x40,0x04,0x40,0x04,0x40,0x08,0x20,0x08,0x00,0x00,0x00,0x00, /* 60 '<' */
-0x00,0x00,0x00,0x00,0x80,0x02,0x80,0x02,0x80,0x02,0x80,0x02,0x80,0x02,0x80,0x02,0x80,0x02,0x80,0x02,0x80,0x02,0x00,0x00, /* 61 '=' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x08,0x40,0x08,0x40,0x04,0x80,0x02,0x80,0x02,0x80,0x02,0x00,0x01,0x00,0x00,0x00,0x00, /* 62 '>' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x00,0x10,0x00,0x10,0x12,0x10,0x11,0x10,0x11,0x90,0x00,0x60,0x00,0x00,0x00,0x00,0x00, /* 63 '?' */
-0x00,0x00,0x00,0x00,0x00,0x00,0xf0,0x1f,0x08,0x20,0x88,0x23,0x48,0x24,0x48,0x24,0xf0,0x27,0x00,0x04,0x00,0x00,0x00,0x00, /* 64 '@' */
-0x00,0x10,0x00,0x10,0x00,0x1c,0x90,0x13,0x70,0x02,0x10,0x02,0x60,0x02,0x60,0x02,0x80,0x13,0x00,0x1c,0x00,0x10,0x00,0x00, /* 65 'A' */
-0x00,0x00,0x00,0x00,0x10,0x10,0xf0,0x1f,0x10,0x11,0x10,0x11,0x10,0x11,0x10,0x11,0x10,0x11,0xe0,0x1a,0x00,0x04,0x00,0x00, /* 66 'B' */
-0x00,0x00,0x00,0x00,0xc0,0x07,0x20,0x08,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x30,0x08,0x00,0x00,0x00,0x00, /* 67 'C' */
-0x00,0x00,0x00,0x00,0xf0,0x1f,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x20,0x08,0xe0,0x0f,0x00,0x00,0x00,0x00, /* 68 'D' */
-0x00,0x00,0x00,0x00,0x10,0x10,0xf0,0x1f,0x10,0x11,0x10,0x11,0x90,0x13,0x90,0x13,0x10,0x10,0x30,0x18,0x00,0x00,0x00,0x00, /* 69 'E' */
-0x00,0x00,0x00,0x00,0x10,0x10,0xf0,0x1f,0x10,0x11,0x10,0x11,0x90,0x03,0x90,0x03,0x10,0x00,0x30,0x00,0x00,0x00,0x00,0x00, /* 70 'F' */
-0x00,0x00,0x00,0x00,0xc0,0x07,0x20,0x08,0x10,0x10,0x10,0x10,0x10,0x12,0x10,0x12,0x10,0x12,0x30,0x0e,0x00,0x02,0x00,0x00, /* 71 'G' */
-0x00,0x00,0x00,0x00,0x10,0x10,0xf0,0x1f,0x10,0x11,0x00,0x01,0x00,0x01,0x00,0x01,0x10,0x11,0xf0,0x1f,0x00,0x10,0x00,0x00, /* 72 'H' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x10,0x10,0x10,0x10,0xf0,0x1f,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x00,0x00,0x00,0x00, /* 73 'I' */
-0x00,0x00,0x00,0x00,0x00,0x0e,0x00,0x08,0x00,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0xf0,0x0f,0x10,0x00,0x10,0x00,0x00,0x00, /* 74 'J' */
-0x00,0x00,0x00,0x00,0x10,0x10,0xf0,0x1f,0x10,0x11,0x80,0x01,0x40,0x01,0x40,0x01,0x30,0x06,0x10,0x18,0x10,0x10,0x00,0x00, /* 75 'K' */
-0x00,0x00,0x00,0x00,0x10,0x10,0x10,0x10,0xf0,0x1f,0x10,0x10,0x10,0x10,0x10,0x10,0x00,0x10,0x00,0x10,0x00,0x1c,0x00,0x00, /* 76 'L' */
-0x10,0x10,0x10,0x10,0xf0,0x1f,0x70,0x10,0x80,0x01,0x00,0x02,0x00,0x03,0x00,0x03,0xe0,0x10,0x10,0x10,0xf0,0x1f,0x00,0x00, /* 77 'M' */
-0x10,0x00,0x10,0x00,0xd0,0x1f,0x30,0x10,0x40,0x10,0x80,0x01,0x00,0x02,0x00,0x02,0x10,0x0c,0xf0,0x1f,0x10,0x00,0x00,0x00, /* 78 'N' */
-0x00,0x00,0x00,0x00,0xc0,0x07,0x20,0x08,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x60,0x0c,0x80,0x03,0x00,0x00, /* 79 'O' */
-0x00,0x00,0x00,0x00,0x10,0x10,0xf0,0x1f,0x10,0x12,0x10,0x12,0x10,0x02,0x10,0x02,0x10,0x01,0xe0,0x01,0x00,0x00,0x00,0x00, /* 80 'P' */
-0x00,0x00,0x00,0x00,0xc0,0x07,0x20,0x48,0x10,0x70,0x10,0x30,0x10,0x30,0x10,0x30,0x10,0x50,0x60,0x4c,0x80,0x23,0x00,0x00, /* 81 'Q' */
-0x00,0x00,0x00,0x00,0x10,0x10,0xf0,0x1f,0x10,0x11,0x10,0x01,0x10,0x01,0x10,0x01,0x10,0x03,0xe0,0x0c,0x00,0x10,0x00,0x00, /* 82 'R' */
-0x00,0x00,0x00,0x00,0x00,0x1c,0xe0,0x08,0x10,0x11,0x10,0x11,0x10,0x11,0x10,0x11,0x20,0x11,0x70,0x0e,0x00,0x00,0x00,0x00, /* 83 'S' */
-0x00,0x00,0x00,0x00,0x30,0x00,0x10,0x10,0x10,0x10,0xf0,0x1f,0x10,0x10,0x10,0x10,0x10,0x10,0x30,0x00,0x00,0x00,0x00,0x00, /* 84 'T' */
-0x00,0x00,0x00,0x00,0xf0,0x07,0x10,0x08,0x10,0x10,0x00,0x10,0x00,0x10,0x00,0x10,0x10,0x18,0xf0,0x0f,0x10,0x00,0x00,0x00, /* 85 'U' */
-0x10,0x00,0x10,0x00,0x70,0x00,0x90,0x01,0x00,0x0e,0x00,0x10,0x00,0x0c,0x00,0x0c,0x90,0x03,0x70,0x00,0x10,0x00,0x00,0x00, /* 86 'V' */
-0x10,0x00,0x10,0x00,0xf0,0x07,0x10,0x18,0x10,0x07,0xc0,0x00,0x80,0x03,0x80,0x03,0x10,0x1c,0xd0,0x1f,0x30,0x00,0x00,0x00, /* 87 'W' */
-0x00,0x00,0x00,0x00,0x10,0x10,0x30,0x1c,0xc0,0x12,0x00,0x01,0x80,0x02,0x80,0x02,0x50,0x14,0x30,0x18,0x10,0x10,0x00,0x00, /* 88 'X' */
-0x00,0x00,0x00,0x00,0x10,0x00,0x30,0x10,0xc0,0x10,0x00,0x1f,0x80,0x10,0x80,0x10,0x50,0x10,0x30,0x00,0x10,0x00,0x00,0x00, /* 89 'Y' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x30,0x1c,0x10,0x12,0x10,0x11,0x90,0x10,0x90,0x10,0x70,0x10,0x10,0x1c,0x00,0x00,0x00,0x00, /* 90 'Z' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xf8,0x7f,0x08,0x40,0x08,0x40,0x08,0x40,0x00,0x00,0x00,0x00,0x00,0x00, /* 91 '[' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x18,0x00,0x60,0x00,0x80,0x01,0x00,0x06,0x00,0x06,0x00,0x18,0x00,0x20,0x00,0x00,0x00,0x00, /* 92 '\' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x08,0x40,0x08,0x40,0xf8,0x7f,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 93 ']' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x40,0x00,0x30,0x00,0x08,0x00,0x10,0x00,0x10,0x00,0x20,0x00,0x40,0x00,0x00,0x00,0x00,0x00, /* 94 '^' */
-0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x40, /* 95 '_' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x08,0x00,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 96 '`' */
-0x00,0x00,0x00,0x00,0x00,0x0e,0x40,0x13,0x40,0x11,0x40,0x11,0x40,0x11,0x40,0x11,0xc0,0x0f,0x00,0x10,0x00,0x10,0x00,0x00, /* 97 'a' */
-0x08,0x10,0x08,0x10,0xf8,0x16,0x80,0x09,0x80,0x10,0x40,0x10,0x40,0x10,0x40,0x10,0x40,0x10,0x80,0x08,0x00,0x07,0x00,0x00, /* 98 'b' */
-0x00,0x00,0x00,0x00,0x00,0x07,0x80,0x08,0x40,0x10,0x40,0x10,0x40,0x10,0x40,0x10,0x40,0x10,0xc0,0x10,0x00,0x00,0x00,0x00, /* 99 'c' */
-0x00,0x00,0x00,0x00,0x00,0x07,0x80,0x08,0x40,0x10,0x40,0x10,0x40,0x10,0x40,0x10,0x88,0x08,0xf8,0x1f,0x00,0x10,0x00,0x00, /* 100 'd' */
-0x00,0x00,0x00,0x00,0x00,0x07,0x80,0x0a,0x40,0x12,0x40,0x12,0x40,0x12,0x40,0x12,0x40,0x12,0x80,0x0b,0x00,0x00,0x00,0x00, /* 101 'e' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x40,0x10,0xe0,0x1f,0x58,0x10,0x48,0x10,0x48,0x10,0x48,0x10,0x48,0x10,0x08,0x00,0x00,0x00, /* 102 'f' */
-0x00,0x00,0x00,0x00,0x00,0x07,0x80,0x08,0x40,0x90,0x40,0x90,0x40,0x90,0x40,0x90,0x80,0xc8,0xc0,0x3f,0x40,0x00,0x00,0x00, /* 103 'g' */
-0x00,0x00,0x00,0x00,0x08,0x10,0xf8,0x1f,0x80,0x10,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x10,0x80,0x1f,0x00,0x10,0x00,0x00, /* 104 'h' */
-0x00,0x00,0x00,0x00,0x00,0x10,0x40,0x10,0x40,0x10,0xd0,0x1f,0x00,0x10,0x00,0x10,0x00,0x10,0x00,0x10,0x00,0x00,0x00,0x00, /* 105 'i' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x40,0x80,0x40,0x80,0x40,0x80,0x50,0x80,0x50,0x80,0xc0,0x7f,0x00,0x00,0x00,0x00,0x00,0x00, /* 106 'j' */
-0x00,0x00,0x00,0x00,0x08,0x10,0xf8,0x1f,0x00,0x02,0x00,0x03,0xc0,0x04,0xc0,0x04,0x40,0x18,0x40,0x10,0x00,0x10,0x00,0x00, /* 107 'k' */
-0x00,0x00,0x00,0x00,0x00,0x10,0x08,0x10,0x08,0x10,0xf8,0x1f,0x00,0x10,0x00,0x10,0x00,0x10,0x00,0x10,0x00,0x00,0x00,0x00, /* 108 'l' */
-0x40,0x10,0x40,0x10,0xc0,0x1f,0x40,0x10,0x40,0x00,0xc0,0x0f,0x80,0x10,0x80,0x10,0x40,0x00,0x40,0x00,0x80,0x1f,0x00,0x00, /* 109 'm' */
-0x00,0x00,0x00,0x00,0x40,0x10,0xc0,0x1f,0x80,0x10,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x10,0x80,0x1f,0x00,0x10,0x00,0x00, /* 110 'n' */
-0x00,0x00,0x00,0x00,0x00,0x07,0x80,0x08,0x40,0x10,0x40,0x10,0x40,0x10,0x40,0x10,0x40,0x10,0x80,0x0f,0x00,0x00,0x00,0x00, /* 111 'o' */
-0x40,0x80,0x40,0x80,0x40,0xfb,0x80,0x8c,0x40,0x90,0x40,0x10,0x40,0x10,0x40,0x10,0x40,0x10,0x80,0x0c,0x00,0x03,0x00,0x00, /* 112 'p' */
-0x00,0x00,0x00,0x00,0x00,0x07,0x80,0x08,0x40,0x10,0x40,0x10,0x40,0x90,0x40,0x90,0x80,0x88,0xc0,0xff,0x40,0x80,0x00,0x00, /* 113 'q' */
-0x00,0x00,0x00,0x00,0x00,0x10,0x40,0x10,0xc0,0x1f,0x80,0x10,0x80,0x10,0x80,0x10,0x40,0x10,0x40,0x00,0x00,0x00,0x00,0x00, /* 114 'r' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x19,0x40,0x12,0x40,0x12,0x40,0x12,0x40,0x12,0x80,0x12,0xc0,0x0c,0x00,0x00,0x00,0x00, /* 115 's' */
-0x00,0x00,0x00,0x00,0x40,0x00,0xf0,0x0f,0x40,0x10,0x40,0x10,0x40,0x10,0x40,0x10,0x40,0x10,0x00,0x08,0x00,0x00,0x00,0x00, /* 116 't' */
-0x00,0x00,0x00,0x00,0x40,0x00,0xc0,0x0f,0x00,0x10,0x00,0x10,0x40,0x10,0x40,0x10,0x40,0x08,0xc0,0x1f,0x00,0x10,0x00,0x00, /* 117 'u' */
-0x40,0x00,0x40,0x00,0x40,0x00,0xc0,0x03,0x40,0x0c,0x00,0x10,0x00,0x1c,0x00,0x1c,0x40,0x03,0xc0,0x00,0x40,0x00,0x00,0x00, /* 118 'v' */
-0x40,0x00,0x40,0x00,0xc0,0x03,0x40,0x1c,0x00,0x1c,0x00,0x03,0x00,0x0e,0x00,0x0e,0x40,0x18,0xc0,0x07,0x40,0x00,0x00,0x00, /* 119 'w' */
-0x00,0x00,0x00,0x00,0x40,0x10,0xc0,0x18,0x40,0x15,0x00,0x02,0x00,0x05,0x00,0x05,0xc0,0x14,0x40,0x18,0x00,0x10,0x00,0x00, /* 120 'x' */
-0x00,0x00,0x00,0x00,0x40,0x80,0xc0,0x81,0x40,0xc6,0x00,0xb8,0x00,0x0c,0x00,0x0c,0x40,0x03,0xc0,0x00,0x40,0x00,0x00,0x00, /* 121 'y' */
-0x00,0x00,0x00,0x00,0x00,0x00,0xc0,0x18,0x40,0x14,0x40,0x12,0x40,0x11,0x40,0x11,0xc0,0x10,0x40,0x10,0x00,0x00,0x00,0x00, /* 122 'z' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0xf0,0x3e,0x08,0x40,0x08,0x40,0x08,0x40,0x00,0x00,0x00,0x00,0x00,0x00, /* 123 '{' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xf0,0x7f,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* 124 '|' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x08,0x40,0xf8,0x7e,0x00,0x03,0x00,0x03,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x00, /* 125 '}' */
-0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x01,0x80,0x00,0x00,0x01,0x00,0x02,0x00,0x02,0x00,0x02,0x00,0x01,0x00,0x00,0x00,0x00, /* 126 '~' */
-};
-
-static const FontDef Font12x16 = { 12, 16, 24, Font12x16_data };  
+// Defined once in ssd1306_fonts.c (or the generated ssd1306_fonts_subset.c)
+extern const FontDef Font6x8;
+extern const FontDef Font8x12_bold;
+extern const FontDef Font12x16;
 
 #endif // SSD1306_FONTS_H
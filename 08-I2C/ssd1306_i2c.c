@@ -0,0 +1,337 @@
+// SSD1306 over I2C: blocking and interrupt-driven writes on a Tiva I2C master.
+// Built when SSD1306_TRANSPORT is SSD1306_TRANSPORT_I2C (the default).
+#include "ssd1306.h"
+
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+
+#include "ssd1306_transport.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Tiva headers */
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_i2c.h"
+#include "driverlib/i2c.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+
+// Per I2C module (I2C0..I2C3): device whose async flush is on the bus, and
+// devices waiting for it, linked through next. Panels on different modules
+// flush in parallel; panels sharing a module take turns. Blocking writes spin
+// on active, so both are volatile.
+static struct {
+    SSD1306_Device * volatile active;
+    SSD1306_Device * volatile pending;
+} g_bus[4];
+
+#define I2C_BUS(base) (((base) >> 12) & 3)
+
+enum { TX_IDLE, TX_DATA, TX_STOP };
+
+// --- Low level I2C write helpers ---
+// Returns false (after releasing the bus) if the byte was not acknowledged or
+// arbitration was lost.
+static bool i2cWait(SSD1306_Device *dev, bool burst)
+{
+    uint32_t base = dev->base;
+    while (MAP_I2CMasterBusy(base)) {
+#ifdef SSD1306_STATS
+        dev->stats.busy_polls++;
+#endif
+    }
+    if (MAP_I2CMasterErr(base) == I2C_MASTER_ERR_NONE) return true;
+    if (burst) {
+        MAP_I2CMasterControl(base, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+        while (MAP_I2CMasterBusy(base));
+    }
+#ifdef SSD1306_STATS
+    dev->stats.errors++;
+#endif
+    return false;
+}
+
+// A logical write is one I2C transaction: i2cBegin() sends START, the address
+// and the control byte once, i2cPut() streams payload bytes and the last call
+// with finish = true ends the transaction with a STOP.
+// controlByte = 0x00 for command, 0x40 for data.
+// Both return false if the transaction was aborted.
+static bool i2cBegin(SSD1306_Device *dev, uint8_t controlByte)
+{
+    MAP_I2CMasterSlaveAddrSet(dev->base, dev->i2c_addr, false);
+    MAP_I2CMasterDataPut(dev->base, controlByte);
+    MAP_I2CMasterControl(dev->base, I2C_MASTER_CMD_BURST_SEND_START);
+    return i2cWait(dev, true);
+}
+
+static bool i2cPut(SSD1306_Device *dev, const uint8_t *data, uint32_t len, bool finish)
+{
+    uint32_t i;
+    for (i = 0; i < len; ++i) {
+        bool last = finish && i == len - 1;
+        MAP_I2CMasterDataPut(dev->base, data[i]);
+        if (last) {
+            MAP_I2CMasterControl(dev->base, I2C_MASTER_CMD_BURST_SEND_FINISH);
+        } else {
+            MAP_I2CMasterControl(dev->base, I2C_MASTER_CMD_BURST_SEND_CONT);
+        }
+        if (!i2cWait(dev, !last)) return false;
+    }
+    return true;
+}
+
+// Blocking writes must not interleave with an interrupt-driven transfer,
+// neither this device's own nor another one on the same I2C module
+void ssd1306_link_wait(SSD1306_Device *dev)
+{
+    while (dev->tx.busy || g_bus[I2C_BUS(dev->base)].active) {
+#ifdef SSD1306_STATS
+        dev->stats.wait_polls++;
+#endif
+    }
+}
+
+bool ssd1306_link_write(SSD1306_Device *dev, uint8_t control, const uint8_t *data, uint32_t len)
+{
+    return i2cBegin(dev, control) && i2cPut(dev, data, len, true);
+}
+
+// One transaction per descriptor: the rows go out back to back behind a
+// single control byte
+bool ssd1306_link_send(SSD1306_Device *dev, const SSD1306_TxDesc *d, uint8_t n)
+{
+    uint8_t i, r;
+    for (i = 0; i < n; ++i, ++d) {
+        bool ok = i2cBegin(dev, d->control);
+        for (r = 0; ok && r < d->rows; ++r) {
+            ok = i2cPut(dev, &d->data[r * d->stride], d->len, r == d->rows - 1);
+        }
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// --- Interrupt-driven transmit ---
+static void tx_start(SSD1306_Device *dev, const SSD1306_TxDesc *d)
+{
+    dev->tx.row = 0;
+    dev->tx.col = 0;
+    dev->tx.state = TX_DATA;
+    MAP_I2CMasterSlaveAddrSet(dev->base, dev->i2c_addr, false);
+    MAP_I2CMasterDataPut(dev->base, d->control);
+    MAP_I2CMasterControl(dev->base, I2C_MASTER_CMD_BURST_SEND_START);
+}
+
+// The active device is done: hand the bus to the next waiting device
+static void tx_finish(SSD1306_Device *dev)
+{
+    uint8_t bus = I2C_BUS(dev->base);
+    SSD1306_Device *next = g_bus[bus].pending;
+
+    dev->tx.state = TX_IDLE;
+    if (next) {
+        g_bus[bus].pending = next->next;
+        g_bus[bus].active = next;
+        tx_start(next, next->tx.desc);
+    } else {
+        g_bus[bus].active = NULL;
+        MAP_I2CMasterIntDisable(dev->base);
+    }
+    ssd1306_frame_done(dev);
+}
+
+// I2C master interrupt: fires once per byte (or START/STOP) on the bus.
+// Only enabled while an async flush runs on that module.
+void SSD1306_I2CIntHandler(uint32_t i2c_base)
+{
+    SSD1306_Device *dev = g_bus[I2C_BUS(i2c_base)].active;
+    const SSD1306_TxDesc *d;
+
+    MAP_I2CMasterIntClear(i2c_base);
+    if (!dev || dev->tx.state == TX_IDLE) return;
+    d = dev->tx.desc;
+#ifdef SSD1306_STATS
+    dev->stats.interrupts++;
+#endif
+
+    if (MAP_I2CMasterErr(i2c_base) != I2C_MASTER_ERR_NONE) {
+        if (dev->tx.state == TX_DATA) {
+            // the STOP takes about one bit time; the next device's START
+            // must not be issued while it is still on the bus
+            MAP_I2CMasterControl(i2c_base, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+            while (MAP_I2CMasterBusy(i2c_base));
+            // the STOP raised an interrupt of its own, which would otherwise
+            // be taken for the next device's START
+            MAP_I2CMasterIntClear(i2c_base);
+        }
+        dev->tx.error = true;
+#ifdef SSD1306_STATS
+        dev->stats.errors++;
+#endif
+        tx_finish(dev);
+        return;
+    }
+
+    if (dev->tx.state == TX_DATA) {
+        MAP_I2CMasterDataPut(i2c_base, d->data[dev->tx.row * d->stride + dev->tx.col]);
+        if (++dev->tx.col == d->len) {
+            dev->tx.col = 0;
+            ++dev->tx.row;
+        }
+        if (dev->tx.row == d->rows) {
+            MAP_I2CMasterControl(i2c_base, I2C_MASTER_CMD_BURST_SEND_FINISH);
+            dev->tx.state = TX_STOP;
+        } else {
+            MAP_I2CMasterControl(i2c_base, I2C_MASTER_CMD_BURST_SEND_CONT);
+        }
+    } else if (--dev->tx.count) {
+        dev->tx.desc = ++d;
+        tx_start(dev, d);
+    } else {
+        tx_finish(dev);
+    }
+}
+
+// Handlers registered with I2CIntRegister(), one per I2C module
+static void i2c0IntHandler(void) { SSD1306_I2CIntHandler(I2C0_BASE); }
+static void i2c1IntHandler(void) { SSD1306_I2CIntHandler(I2C1_BASE); }
+static void i2c2IntHandler(void) { SSD1306_I2CIntHandler(I2C2_BASE); }
+static void i2c3IntHandler(void) { SSD1306_I2CIntHandler(I2C3_BASE); }
+
+static void (* const g_bus_handler[4])(void) = {
+    i2c0IntHandler, i2c1IntHandler, i2c2IntHandler, i2c3IntHandler
+};
+
+void ssd1306_link_start(SSD1306_Device *dev)
+{
+    uint8_t bus = I2C_BUS(dev->base);
+    bool masked;
+
+    dev->next = NULL;
+    // the bus queue is shared with the interrupt handler
+    masked = MAP_IntMasterDisable();
+    if (g_bus[bus].active) {
+        SSD1306_Device *tail = g_bus[bus].pending;
+        if (!tail) {
+            g_bus[bus].pending = dev;
+        } else {
+            while (tail->next) tail = tail->next;
+            tail->next = dev;
+        }
+    } else {
+        g_bus[bus].active = dev;
+        MAP_I2CMasterIntClear(dev->base);
+        MAP_I2CMasterIntEnable(dev->base);
+        tx_start(dev, dev->tx.desc);
+    }
+    if (!masked) MAP_IntMasterEnable();
+}
+
+// --- Bus speed ---
+// SCL period = 2 * (1 + TPR) * (SCL_LP + SCL_HP) system clocks, with the fixed
+// SCL_LP = 6 and SCL_HP = 4, i.e. 20 * (1 + TPR). TPR is rounded up so the
+// bus never runs faster than asked; 0 Hz asks for the slowest rate.
+uint32_t SSD1306_SetBusSpeed(uint32_t i2c_base, uint32_t sysclk, uint32_t scl_hz)
+{
+    uint32_t tpr = scl_hz ? (sysclk + 20 * scl_hz - 1) / (20 * scl_hz) : 128;
+    if (tpr < 2) tpr = 2;               // TPR = 0 is not allowed
+    if (tpr > 128) tpr = 128;           // 7-bit field
+    --tpr;
+
+    // never retime a transfer in flight
+    while (g_bus[I2C_BUS(i2c_base)].active);
+    while (MAP_I2CMasterBusy(i2c_base));
+    HWREG(i2c_base + I2C_O_MTPR) = tpr;
+    return sysclk / (20 * (tpr + 1));
+}
+
+// Status byte (single-byte read): bit 6 is set while the display is off
+static bool read_status(SSD1306_Device *dev, uint8_t *status)
+{
+    MAP_I2CMasterSlaveAddrSet(dev->base, dev->i2c_addr, true);
+    MAP_I2CMasterControl(dev->base, I2C_MASTER_CMD_SINGLE_RECEIVE);
+    if (!i2cWait(dev, false)) return false;
+    *status = MAP_I2CMasterDataGet(dev->base);
+    return true;
+}
+
+static bool writeCommand(SSD1306_Device *dev, uint8_t cmd)
+{
+    return ssd1306_link_write(dev, SSD1306_CMD, &cmd, 1);
+}
+
+// One probe frame: every byte of a full-screen refresh must be acknowledged,
+// and the controller must report the display-off and display-on commands
+// around it, proving it still parses what is sent at this rate
+static bool probe_frame(SSD1306_Device *dev)
+{
+    uint8_t status;
+    if (!writeCommand(dev, 0xAE) || !read_status(dev, &status) || !(status & 0x40))
+        return false;
+    ssd1306_dirty_all(dev);
+    if (!ssd1306_display_blocking(dev)) return false;
+    return writeCommand(dev, 0xAF) && read_status(dev, &status) && !(status & 0x40);
+}
+
+uint32_t SSD1306_ProbeBusSpeed(uint32_t sysclk, uint32_t max_hz)
+{
+    static const uint32_t rates[] = { 100000, 400000, 1000000, 1500000, 2000000, 3000000 };
+    SSD1306_Device *dev = SSD1306_Selected();
+    uint32_t hz, best = 0, best_hz = 0;
+    uint8_t i;
+
+    ssd1306_link_wait(dev);
+    for (i = 0; i < sizeof(rates) / sizeof(rates[0]) && rates[i] <= max_hz; ++i) {
+        hz = SSD1306_SetBusSpeed(dev->base, sysclk, rates[i]);
+        // once TPR is at its minimum, faster steps only retest the same rate
+        if (hz <= best_hz) break;
+        if (!probe_frame(dev)) break;
+        best = rates[i];
+        best_hz = hz;
+    }
+    // settle on the last good rate and leave the panel on and up to date
+    SSD1306_SetBusSpeed(dev->base, sysclk, best ? best : rates[0]);
+    if (!best) return 0;
+    writeCommand(dev, 0xAF);
+    ssd1306_dirty_all(dev);
+    ssd1306_display_blocking(dev);
+    return best_hz;
+}
+
+// --- Initialization ---
+static void device_init(SSD1306_Device *dev, uint32_t i2c_base, uint8_t i2c_addr, uint8_t width,
+                        uint8_t rows, uint8_t height, uint8_t *framebuf, uint8_t *backbuf)
+{
+    ssd1306_device_init(dev, width, rows, height, framebuf, backbuf);
+    dev->base = i2c_base;
+    dev->i2c_addr = i2c_addr;
+
+    // Master interrupt drives SSD1306_DisplayAsync(); it stays masked until used
+    MAP_I2CMasterIntDisable(i2c_base);
+    I2CIntRegister(i2c_base, g_bus_handler[I2C_BUS(i2c_base)]);
+
+    ssd1306_device_start(dev);
+}
+
+void SSD1306_InitDevice(SSD1306_Device *dev, uint32_t i2c_base, uint8_t i2c_addr,
+                        uint8_t width, uint8_t height, uint8_t *framebuf, uint8_t *backbuf)
+{
+    device_init(dev, i2c_base, i2c_addr, width, height, height, framebuf, backbuf);
+}
+
+void SSD1306_InitDeviceRing(SSD1306_Device *dev, uint32_t i2c_base, uint8_t i2c_addr,
+                            uint8_t width, uint8_t rows, uint8_t *framebuf, uint8_t *backbuf)
+{
+    device_init(dev, i2c_base, i2c_addr, width, rows, 64, framebuf, backbuf);
+}
+
+void SSD1306_Init(uint32_t i2c_base, uint8_t i2c_addr)
+{
+    uint8_t *fb, *back;
+    SSD1306_Device *dev = ssd1306_default_device(&fb, &back);
+    SSD1306_InitDevice(dev, i2c_base, i2c_addr, SSD1306_WIDTH, SSD1306_HEIGHT, fb, back);
+}
+
+#endif // SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
@@ -0,0 +1,229 @@
+// SSD1306 over 4-wire SPI: an SSI master in Freescale SPI mode 0 with the FSS
+// pin as CS# and a GPIO as D/C. Frame data is streamed by uDMA, page rows at
+// a time; short command writes go through the FIFO directly.
+// Built when SSD1306_TRANSPORT is SSD1306_TRANSPORT_SSI.
+#include "ssd1306.h"
+
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_SSI
+
+#include "ssd1306_transport.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Tiva headers */
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_ssi.h"
+#include "driverlib/gpio.h"
+#include "driverlib/ssi.h"
+#include "driverlib/udma.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+
+// uDMA moves at most 1024 items per transfer
+#define DMA_MAX_ITEMS 1024
+
+// uDMA channel control table, installed unless the application has one.
+// The controller needs it aligned to its size.
+#if defined(ccs)
+#pragma DATA_ALIGN(g_dma_table, 1024)
+static uint8_t g_dma_table[1024];
+#else
+static uint8_t g_dma_table[1024] __attribute__((aligned(1024)));
+#endif
+
+#define SSI_MODULE(base) (((base) >> 12) & 3)
+
+// Per SSI module (SSI0..SSI3): TX channel, its interrupt and the panel on it.
+// FSS is the only chip select, so each module drives one panel.
+static const uint32_t g_ssi_dma[4] = {
+    UDMA_CH11_SSI0TX, UDMA_CH25_SSI1TX, UDMA_CH13_SSI2TX, UDMA_CH15_SSI3TX
+};
+static const uint32_t g_ssi_int[4] = { INT_SSI0, INT_SSI1, INT_SSI2, INT_SSI3 };
+static SSD1306_Device *g_ssi[4];
+
+// D/C is sampled with the last bit of each byte, so it only changes once the
+// FIFO has drained
+static void dc_set(SSD1306_Device *dev, uint8_t control)
+{
+    while (MAP_SSIBusy(dev->base)) {
+#ifdef SSD1306_STATS
+        dev->stats.busy_polls++;
+#endif
+    }
+    MAP_GPIOPinWrite(dev->dc_port, dev->dc_pin, control ? dev->dc_pin : 0);
+}
+
+// Start uDMA on the rows of d from row on: all the rest when they are
+// contiguous in the framebuffer (full-width spans), else just that row.
+// Returns the number of rows queued.
+static uint8_t dma_rows(SSD1306_Device *dev, const SSD1306_TxDesc *d, uint8_t row)
+{
+    uint8_t n = 1;
+    if (d->len == d->stride) {
+        n = d->rows - row;
+        if (n * d->len > DMA_MAX_ITEMS) n = DMA_MAX_ITEMS / d->len;
+    }
+    MAP_uDMAChannelTransferSet(dev->dma_channel | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+                               (void *)&d->data[row * d->stride],
+                               (void *)(uintptr_t)(dev->base + SSI_O_DR), n * d->len);
+    MAP_uDMAChannelEnable(dev->dma_channel);
+    return n;
+}
+
+void ssd1306_link_wait(SSD1306_Device *dev)
+{
+    while (dev->tx.busy) {
+#ifdef SSD1306_STATS
+        dev->stats.wait_polls++;
+#endif
+    }
+}
+
+bool ssd1306_link_write(SSD1306_Device *dev, uint8_t control, const uint8_t *data, uint32_t len)
+{
+    uint32_t i;
+    dc_set(dev, control);
+    for (i = 0; i < len; ++i) MAP_SSIDataPut(dev->base, data[i]);
+    while (MAP_SSIBusy(dev->base));
+    return true;
+}
+
+// Blocking frame: the same uDMA transfers as the async path, polled
+bool ssd1306_link_send(SSD1306_Device *dev, const SSD1306_TxDesc *d, uint8_t n)
+{
+    uint8_t i, r;
+    for (i = 0; i < n; ++i, ++d) {
+        dc_set(dev, d->control);
+        for (r = 0; r < d->rows; ) {
+            r += dma_rows(dev, d, r);
+            while (MAP_uDMAChannelIsEnabled(dev->dma_channel)) {
+#ifdef SSD1306_STATS
+                dev->stats.busy_polls++;
+#endif
+            }
+        }
+    }
+    while (MAP_SSIBusy(dev->base));
+    return true;
+}
+
+// --- Interrupt-driven transmit ---
+// tx.row is the next row of tx.desc to queue. Returns false once the whole
+// frame has left the SSI.
+static bool tx_next(SSD1306_Device *dev)
+{
+    const SSD1306_TxDesc *d = dev->tx.desc;
+    if (dev->tx.row == d->rows) {
+        if (--dev->tx.count == 0) {
+            while (MAP_SSIBusy(dev->base));
+            return false;
+        }
+        dev->tx.desc = ++d;
+        dev->tx.row = 0;
+    }
+    // switching D/C waits out the FIFO: at most 8 bytes, under 7 us at 10 MHz
+    if (dev->tx.row == 0) dc_set(dev, d->control);
+    dev->tx.row += dma_rows(dev, d, dev->tx.row);
+    return true;
+}
+
+// SSI interrupt: on the TM4C123 the completion of a uDMA transfer for the SSI
+// is signalled on the SSI's own vector. Only enabled while an async flush runs.
+void SSD1306_SSIIntHandler(uint32_t ssi_base)
+{
+    uint8_t m = SSI_MODULE(ssi_base);
+    SSD1306_Device *dev = g_ssi[m];
+
+    MAP_SSIIntClear(ssi_base, MAP_SSIIntStatus(ssi_base, true));
+    if (!dev || !dev->tx.busy) return;
+    if (MAP_uDMAChannelModeGet(dev->dma_channel | UDMA_PRI_SELECT) != UDMA_MODE_STOP) return;
+#ifdef SSD1306_STATS
+    dev->stats.interrupts++;
+#endif
+    if (!tx_next(dev)) {
+        MAP_IntDisable(g_ssi_int[m]);
+        ssd1306_frame_done(dev);
+    }
+}
+
+// Handlers registered with SSIIntRegister(), one per SSI module
+static void ssi0IntHandler(void) { SSD1306_SSIIntHandler(SSI0_BASE); }
+static void ssi1IntHandler(void) { SSD1306_SSIIntHandler(SSI1_BASE); }
+static void ssi2IntHandler(void) { SSD1306_SSIIntHandler(SSI2_BASE); }
+static void ssi3IntHandler(void) { SSD1306_SSIIntHandler(SSI3_BASE); }
+
+static void (* const g_ssi_handler[4])(void) = {
+    ssi0IntHandler, ssi1IntHandler, ssi2IntHandler, ssi3IntHandler
+};
+
+void ssd1306_link_start(SSD1306_Device *dev)
+{
+    uint8_t m = SSI_MODULE(dev->base);
+    bool masked = MAP_IntMasterDisable();
+    // a completion left pending by a blocking frame must not end this one
+    MAP_IntPendClear(g_ssi_int[m]);
+    MAP_IntEnable(g_ssi_int[m]);
+    dev->tx.row = 0;
+    tx_next(dev);
+    if (!masked) MAP_IntMasterEnable();
+}
+
+// --- Initialization ---
+static void device_init(SSD1306_Device *dev, uint32_t ssi_base, uint32_t dc_port, uint8_t dc_pin,
+                        uint8_t width, uint8_t rows, uint8_t height, uint8_t *framebuf, uint8_t *backbuf)
+{
+    uint8_t m = SSI_MODULE(ssi_base);
+
+    ssd1306_device_init(dev, width, rows, height, framebuf, backbuf);
+    dev->base = ssi_base;
+    dev->dc_port = dc_port;
+    dev->dc_pin = dc_pin;
+    dev->dma_channel = g_ssi_dma[m] & 0x1F;
+    g_ssi[m] = dev;
+
+    MAP_GPIOPinTypeGPIOOutput(dc_port, dc_pin);
+
+    if (!MAP_uDMAControlBaseGet()) {
+        MAP_uDMAEnable();
+        MAP_uDMAControlBaseSet(g_dma_table);
+    }
+    MAP_uDMAChannelAssign(g_ssi_dma[m]);
+    MAP_uDMAChannelAttributeDisable(dev->dma_channel, UDMA_ATTR_ALTSELECT |
+                                    UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    // bytes from the framebuffer into the data register; the TX FIFO asks
+    // for more when half empty
+    MAP_uDMAChannelControlSet(dev->dma_channel | UDMA_PRI_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_4);
+    MAP_SSIDMAEnable(ssi_base, SSI_DMA_TX);
+
+    // uDMA completion drives SSD1306_DisplayAsync(); masked until used
+    SSIIntRegister(ssi_base, g_ssi_handler[m]);
+    MAP_IntDisable(g_ssi_int[m]);
+
+    ssd1306_device_start(dev);
+}
+
+void SSD1306_InitDevice(SSD1306_Device *dev, uint32_t ssi_base, uint32_t dc_port, uint8_t dc_pin,
+                        uint8_t width, uint8_t height, uint8_t *framebuf, uint8_t *backbuf)
+{
+    device_init(dev, ssi_base, dc_port, dc_pin, width, height, height, framebuf, backbuf);
+}
+
+void SSD1306_InitDeviceRing(SSD1306_Device *dev, uint32_t ssi_base, uint32_t dc_port, uint8_t dc_pin,
+                            uint8_t width, uint8_t rows, uint8_t *framebuf, uint8_t *backbuf)
+{
+    device_init(dev, ssi_base, dc_port, dc_pin, width, rows, 64, framebuf, backbuf);
+}
+
+void SSD1306_Init(uint32_t ssi_base, uint32_t dc_port, uint8_t dc_pin)
+{
+    uint8_t *fb, *back;
+    SSD1306_Device *dev = ssd1306_default_device(&fb, &back);
+    SSD1306_InitDevice(dev, ssi_base, dc_port, dc_pin, SSD1306_WIDTH, SSD1306_HEIGHT, fb, back);
+}
+
+#endif // SSD1306_TRANSPORT == SSD1306_TRANSPORT_SSI
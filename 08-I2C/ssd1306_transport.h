@@ -0,0 +1,47 @@
+#ifndef SSD1306_TRANSPORT_H
+#define SSD1306_TRANSPORT_H
+
+// Internal interface between the transport-independent driver (ssd1306.c:
+// framebuffer, drawing, flush planning) and the link to the controller.
+// Exactly one backend is compiled in, picked by SSD1306_TRANSPORT:
+// ssd1306_i2c.c or ssd1306_ssi.c. Not for application use.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+// TxDesc.control values: the I2C control byte, or on SPI the D/C level
+// (any non-zero value means data)
+#define SSD1306_CMD  0x00
+#define SSD1306_DATA 0x40
+
+// --- Provided by the backend ---
+// Blocking transfer of len bytes of one kind on dev. Returns false if the
+// link reported an error.
+bool ssd1306_link_write(SSD1306_Device *dev, uint8_t control, const uint8_t *data, uint32_t len);
+// Blocking transfer of a planned frame; stops at the first failed descriptor
+bool ssd1306_link_send(SSD1306_Device *dev, const SSD1306_TxDesc *d, uint8_t n);
+// Spin until neither dev nor another device on the same bus has an
+// interrupt-driven transfer running
+void ssd1306_link_wait(SSD1306_Device *dev);
+// Start sending dev->tx.desc/tx.count in the background (tx.busy is already
+// set) or queue it behind the transfer holding the bus. The backend calls
+// ssd1306_frame_done() when the last descriptor is out.
+void ssd1306_link_start(SSD1306_Device *dev);
+
+// --- Provided by ssd1306.c ---
+// Geometry, buffers and defaults; no bus traffic. Selects dev.
+void ssd1306_device_init(SSD1306_Device *dev, uint8_t width, uint8_t rows, uint8_t height,
+                         uint8_t *framebuf, uint8_t *backbuf);
+// Built-in instance set up by SSD1306_Init()
+SSD1306_Device *ssd1306_default_device(uint8_t **framebuf, uint8_t **backbuf);
+// Send the init sequence once the link is ready
+void ssd1306_device_start(SSD1306_Device *dev);
+// Flush the dirty spans with blocking writes
+bool ssd1306_display_blocking(SSD1306_Device *dev);
+// Invalidate the whole screen
+void ssd1306_dirty_all(SSD1306_Device *dev);
+// Background transfer finished: releases dev and reports to its callback
+void ssd1306_frame_done(SSD1306_Device *dev);
+
+#endif // SSD1306_TRANSPORT_H
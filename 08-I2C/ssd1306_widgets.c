@@ -0,0 +1,228 @@
+#include "ssd1306_widgets.h"
+#include <string.h>
+
+static void widget_init(SSD1306_Widget *w, uint8_t type, int16_t x, int16_t y,
+                        int16_t width, int16_t height, const FontDef *font)
+{
+    memset(w, 0, sizeof(*w));
+    w->type = type;
+    w->x = x;
+    w->y = y;
+    w->w = width;
+    w->h = height;
+    w->font = font;
+    w->visible = true;
+    w->dirty = true;
+    w->full = true;
+}
+
+// Filled width of a bar inside its 1-pixel outline
+static int16_t bar_fill(const SSD1306_Widget *w)
+{
+    int32_t span = w->u.bar.max - w->u.bar.min;
+    int32_t v = w->u.bar.value;
+    if (span <= 0 || v <= w->u.bar.min) return 0;
+    if (v >= w->u.bar.max) return w->w - 2;
+    return (int16_t)(((int64_t)(v - w->u.bar.min) * (w->w - 2)) / span);
+}
+
+void SSD1306_LabelInit(SSD1306_Widget *w, int16_t x, int16_t y, int16_t width,
+                       const FontDef *font, const char *text)
+{
+    widget_init(w, SSD1306_WIDGET_LABEL, x, y, width, font->height, font);
+    w->u.text = text;
+}
+
+void SSD1306_NumberInit(SSD1306_Widget *w, int16_t x, int16_t y, int16_t width,
+                        const FontDef *font, int32_t value, uint8_t decimals)
+{
+    widget_init(w, SSD1306_WIDGET_NUMBER, x, y, width, font->height, font);
+    w->u.number.value = value;
+    w->u.number.decimals = decimals;
+}
+
+void SSD1306_BarInit(SSD1306_Widget *w, int16_t x, int16_t y, int16_t width, int16_t height,
+                     int32_t min, int32_t max, int32_t value)
+{
+    widget_init(w, SSD1306_WIDGET_BAR, x, y, width, height, NULL);
+    w->u.bar.min = min;
+    w->u.bar.max = max;
+    w->u.bar.value = value;
+    w->u.bar.fill = bar_fill(w);
+}
+
+void SSD1306_IconInit(SSD1306_Widget *w, int16_t x, int16_t y, int16_t width, int16_t height,
+                      const uint8_t *bitmap)
+{
+    widget_init(w, SSD1306_WIDGET_ICON, x, y, width, height, NULL);
+    w->u.bitmap = bitmap;
+}
+
+void SSD1306_WidgetSetText(SSD1306_Widget *w, const char *text)
+{
+    // same pointer may hold new contents, so always redraw
+    w->u.text = text;
+    SSD1306_WidgetInvalidate(w);
+}
+
+void SSD1306_WidgetSetValue(SSD1306_Widget *w, int32_t value)
+{
+    if (w->type == SSD1306_WIDGET_NUMBER) {
+        if (w->u.number.value == value) return;
+        w->u.number.value = value;
+        w->dirty = true;
+    } else if (w->type == SSD1306_WIDGET_BAR) {
+        int16_t fill;
+        w->u.bar.value = value;
+        fill = bar_fill(w);
+        // a value change that moves the bar by less than a pixel costs nothing
+        if (fill == w->u.bar.fill) return;
+        w->u.bar.fill = fill;
+        w->dirty = true;
+    }
+}
+
+void SSD1306_WidgetSetBitmap(SSD1306_Widget *w, const uint8_t *bitmap)
+{
+    if (w->u.bitmap == bitmap) return;
+    w->u.bitmap = bitmap;
+    SSD1306_WidgetInvalidate(w);
+}
+
+void SSD1306_WidgetSetVisible(SSD1306_Widget *w, bool visible)
+{
+    if (w->visible == visible) return;
+    w->visible = visible;
+    SSD1306_WidgetInvalidate(w);
+}
+
+void SSD1306_WidgetInvalidate(SSD1306_Widget *w)
+{
+    w->dirty = true;
+    w->full = true;
+}
+
+void SSD1306_ScreenInit(SSD1306_Screen *screen, SSD1306_Device *dev)
+{
+    screen->dev = dev;
+    screen->first = NULL;
+}
+
+void SSD1306_ScreenAdd(SSD1306_Screen *screen, SSD1306_Widget *w)
+{
+    SSD1306_Widget **tail = &screen->first;
+    while (*tail) tail = &(*tail)->next;
+    w->next = NULL;
+    SSD1306_WidgetInvalidate(w);
+    *tail = w;
+}
+
+void SSD1306_ScreenInvalidate(SSD1306_Screen *screen)
+{
+    SSD1306_Widget *w;
+    for (w = screen->first; w; w = w->next) SSD1306_WidgetInvalidate(w);
+}
+
+// One line of text from the left edge, cut at the last glyph that fits in the
+// widget
+static void render_text(const SSD1306_Widget *w, const char *text)
+{
+    int16_t x = w->x, right = w->x + w->w;
+    while (*text && x + w->font->width <= right) {
+        SSD1306_SetCursor(x, w->y);
+        SSD1306_WriteChar(*text++);
+        x += w->font->width + 1;
+    }
+}
+
+// Right-aligned number in character cells counted from the right edge; a
+// value too wide for the widget keeps its rightmost characters. Unless full,
+// only the cells that differ from the value on screen are rewritten, so a
+// counter ticking 199 -> 200 touches three cells and 200 -> 201 just one.
+static void render_number(const SSD1306_Widget *w, bool full)
+{
+    char now[13], was[13];
+    uint8_t n = SSD1306_FormatFixed(now, w->u.number.value, w->u.number.decimals);
+    uint8_t o = full ? 0 : SSD1306_FormatFixed(was, w->u.number.drawn, w->u.number.decimals);
+    int16_t cell = w->font->width + 1;
+    int16_t x = w->x + w->w - cell + 1;
+    uint8_t i;
+
+    for (i = 0; (i < n || i < o) && x >= w->x; ++i, x -= cell) {
+        char c = i < n ? now[n - 1 - i] : ' ';
+        if (c == (i < o ? was[o - 1 - i] : ' ')) continue;
+        // a full render has cleared the background already
+        if (!full) SSD1306_FillRect(x, w->y, w->font->width, w->h, false);
+        if (c != ' ') {
+            SSD1306_SetCursor(x, w->y);
+            SSD1306_WriteChar(c);
+        }
+    }
+}
+
+static void render(SSD1306_Widget *w)
+{
+    if (!w->full && w->shown && w->visible) {
+        // only the value changed since the last render
+        if (w->type == SSD1306_WIDGET_NUMBER) {
+            render_number(w, false);
+            w->u.number.drawn = w->u.number.value;
+        } else if (w->type == SSD1306_WIDGET_BAR) {
+            int16_t a = w->u.bar.drawn, b = w->u.bar.fill;
+            SSD1306_FillRect(w->x + 1 + (a < b ? a : b), w->y + 1,
+                             a < b ? b - a : a - b, w->h - 2, b > a);
+            w->u.bar.drawn = b;
+        }
+        return;
+    }
+
+    // background first: the widget owns its whole rectangle
+    w->full = false;
+    SSD1306_FillRect(w->x, w->y, w->w, w->h, false);
+    w->shown = w->visible;
+    if (!w->visible) return;
+
+    switch (w->type) {
+    case SSD1306_WIDGET_LABEL:
+        if (w->u.text) render_text(w, w->u.text);
+        break;
+    case SSD1306_WIDGET_NUMBER:
+        render_number(w, true);
+        w->u.number.drawn = w->u.number.value;
+        break;
+    case SSD1306_WIDGET_BAR:
+        SSD1306_DrawRect(w->x, w->y, w->w, w->h, true);
+        SSD1306_FillRect(w->x + 1, w->y + 1, w->u.bar.fill, w->h - 2, true);
+        w->u.bar.drawn = w->u.bar.fill;
+        break;
+    case SSD1306_WIDGET_ICON:
+        if (w->u.bitmap) SSD1306_DrawBitmap(w->x, w->y, w->u.bitmap, w->w, w->h, true);
+        break;
+    }
+}
+
+bool SSD1306_ScreenRender(SSD1306_Screen *screen)
+{
+    SSD1306_Device *prev = SSD1306_Selected();
+    const FontDef *font = screen->dev->font;
+    int16_t cursor_x = screen->dev->cursor_x, cursor_y = screen->dev->cursor_y;
+    SSD1306_Widget *w;
+    bool drawn = false;
+
+    // the application's font and text cursor survive the render
+    SSD1306_Select(screen->dev);
+    for (w = screen->first; w; w = w->next) {
+        if (!w->dirty) continue;
+        w->dirty = false;
+        // hidden and already cleared: nothing to send
+        if (!w->visible && !w->shown) continue;
+        if (w->font) ssd1306_SetFont(w->font);
+        render(w);
+        drawn = true;
+    }
+    ssd1306_SetFont(font);
+    screen->dev->cursor_x = cursor_x;
+    screen->dev->cursor_y = cursor_y;
+    SSD1306_Select(prev);
+    return drawn;
+}
@@ -0,0 +1,82 @@
+#ifndef SSD1306_WIDGETS_H
+#define SSD1306_WIDGETS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+// Retained widgets on top of the SSD1306 driver. Each widget owns a rectangle
+// of the screen and marks itself dirty when its content changes;
+// SSD1306_ScreenRender() redraws only the dirty ones, so the next Display()
+// sends just their page spans. Widgets must not overlap.
+
+typedef enum {
+    SSD1306_WIDGET_LABEL,     // left-aligned text
+    SSD1306_WIDGET_NUMBER,    // right-aligned fixed-point value
+    SSD1306_WIDGET_BAR,       // horizontal bar graph with outline
+    SSD1306_WIDGET_ICON       // page-format bitmap (see SSD1306_DrawBitmap)
+} SSD1306_WidgetType;
+
+typedef struct SSD1306_Widget {
+    uint8_t type;
+    bool dirty;                 // needs rendering
+    bool full;                  // ... of the whole rectangle, not just the value
+    bool visible;
+    bool shown;                 // visible when last rendered
+    int16_t x, y, w, h;
+    const FontDef *font;        // label and number
+    union {
+        const char *text;       // label
+        struct {
+            int32_t value;
+            int32_t drawn;      // value on screen
+            uint8_t decimals;
+        } number;
+        struct {
+            int32_t min, max, value;
+            int16_t fill;       // filled width for value
+            int16_t drawn;      // filled width on screen
+        } bar;
+        const uint8_t *bitmap;  // icon
+    } u;
+    struct SSD1306_Widget *next;
+} SSD1306_Widget;
+
+typedef struct {
+    SSD1306_Device *dev;
+    SSD1306_Widget *first;
+} SSD1306_Screen;
+
+// Widgets are placed by the caller; width/height is the area they clear and
+// draw into. Text widgets are one line of font->height pixels; a label too
+// long for its width is cut after the last whole glyph, a number too wide
+// keeps its rightmost characters.
+void SSD1306_LabelInit(SSD1306_Widget *w, int16_t x, int16_t y, int16_t width,
+                       const FontDef *font, const char *text);
+void SSD1306_NumberInit(SSD1306_Widget *w, int16_t x, int16_t y, int16_t width,
+                        const FontDef *font, int32_t value, uint8_t decimals);
+void SSD1306_BarInit(SSD1306_Widget *w, int16_t x, int16_t y, int16_t width, int16_t height,
+                     int32_t min, int32_t max, int32_t value);
+void SSD1306_IconInit(SSD1306_Widget *w, int16_t x, int16_t y, int16_t width, int16_t height,
+                      const uint8_t *bitmap);
+
+// Setters only invalidate the widget if what it shows changes. A new number
+// redraws just the digits that differ and a bar just the part that moved.
+// The label text is not copied: after editing a text buffer in place, set it
+// again.
+void SSD1306_WidgetSetText(SSD1306_Widget *w, const char *text);
+void SSD1306_WidgetSetValue(SSD1306_Widget *w, int32_t value);
+void SSD1306_WidgetSetBitmap(SSD1306_Widget *w, const uint8_t *bitmap);
+void SSD1306_WidgetSetVisible(SSD1306_Widget *w, bool visible);
+void SSD1306_WidgetInvalidate(SSD1306_Widget *w);
+
+// A screen is the list of widgets shown on one panel
+void SSD1306_ScreenInit(SSD1306_Screen *screen, SSD1306_Device *dev);
+void SSD1306_ScreenAdd(SSD1306_Screen *screen, SSD1306_Widget *w);
+void SSD1306_ScreenInvalidate(SSD1306_Screen *screen);
+// Redraws the dirty widgets into the panel's framebuffer and returns true if
+// there were any; follow with SSD1306_Display() or SSD1306_DisplayAsync().
+// The selected device, its font and its text cursor are left as they were.
+bool SSD1306_ScreenRender(SSD1306_Screen *screen);
+
+#endif // SSD1306_WIDGETS_H
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Generate ssd1306_fonts_subset.c holding only the glyphs a build draws.
+
+Reads the glyph tables from ssd1306_fonts.c (one glyph per line, tagged with
+its /* code 'c' */ comment) and writes the same FontDefs restricted to the
+requested characters. A contiguous character range is stored densely; a
+sparse set gets a map[] index table (0xFF = glyph not present). '?' is always
+kept, since SSD1306_WriteChar() falls back to it, and Font6x8 is always
+emitted because SSD1306_Init() selects it as the default font.
+
+Numbers drawn at run time (SSD1306_WriteInt/WriteFixed/WriteFloat, widgets,
+printf conversions) never appear as literals, so --scan always keeps the
+digits, '-' and '.', plus the hex digits when a format string holds %x/%X.
+
+Build the project with SSD1306_FONT_SUBSET defined so ssd1306_fonts.c steps
+aside and the generated file provides the fonts instead.
+
+Usage:
+  fontsubset.py --scan main.c                  # characters from string literals
+  fontsubset.py --chars "0123456789.-" --fonts Font12x16
+"""
+
+import argparse
+import os
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+FONTS_C = os.path.join(HERE, "..", "ssd1306_fonts.c")
+OUT_C = os.path.join(HERE, "..", "ssd1306_fonts_subset.c")
+
+DATA_RE = re.compile(r"static const uint8_t (\w+)_data\[\] = \{(.*?)\n\};", re.S)
+GLYPH_RE = re.compile(r"^\s*((?:0x[0-9A-Fa-f]{2}\s*,\s*)+)/\*\s*(\d+)\s*'.*'\s*\*/", re.M)
+DEF_RE = re.compile(r"const FontDef (\w+) = \{\s*(\d+),\s*(\d+),\s*(\d+),")
+STRING_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"|\'((?:[^\'\\\n]|\\.))\'')
+HEX_CONV_RE = re.compile(r"%[-+ #0-9.]*l*([xX])")
+NUMERIC = "0123456789-."
+
+
+def load_fonts(path):
+    src = open(path).read()
+    fonts = {}
+    for m in DEF_RE.finditer(src):
+        fonts[m.group(1)] = {"width": int(m.group(2)), "height": int(m.group(3)),
+                             "bytes": int(m.group(4)), "glyphs": {}}
+    for m in DATA_RE.finditer(src):
+        name = m.group(1)
+        if name not in fonts:
+            continue
+        for g in GLYPH_RE.finditer(m.group(2)):
+            data = [b.strip() for b in g.group(1).split(",") if b.strip()]
+            if len(data) != fonts[name]["bytes"]:
+                sys.exit("%s: glyph %s has %d bytes, expected %d"
+                         % (name, g.group(2), len(data), fonts[name]["bytes"]))
+            fonts[name]["glyphs"][int(g.group(2))] = data
+    return fonts
+
+
+def scan_sources(paths, font_names):
+    chars, used = set(), set()
+    for p in paths:
+        src = re.sub(r"^\s*#\s*include.*$", "", open(p).read(), flags=re.M)
+        for m in STRING_RE.finditer(src):
+            text = m.group(1) if m.group(1) is not None else m.group(2)
+            for conv in HEX_CONV_RE.findall(text):
+                chars.update(ord(c) for c in ("abcdef" if conv == "x" else "ABCDEF"))
+            text = re.sub(r"\\.", "", text)
+            chars.update(ord(c) for c in text)
+        used.update(n for n in font_names if re.search(r"\b%s\b" % n, src))
+    if paths:
+        chars.update(ord(c) for c in NUMERIC)
+    return chars, used
+
+
+def emit_font(name, font, codes):
+    codes = sorted(c for c in codes if c in font["glyphs"])
+    first, last = codes[0], codes[-1]
+    dense = len(codes) == last - first + 1
+    out = ["// %s: %d of %d glyphs" % (name, len(codes), len(font["glyphs"])),
+           "static const uint8_t %s_data[] = {" % name]
+    for c in codes:
+        out.append("%s, /* %d %r */" % (",".join(font["glyphs"][c]), c, chr(c)))
+    out.append("};")
+    map_ref = "NULL"
+    if not dense:
+        slots = {c: i for i, c in enumerate(codes)}
+        row = ["0x%02X" % slots.get(c, 0xFF) for c in range(first, last + 1)]
+        out.append("static const uint8_t %s_map[] = {" % name)
+        for i in range(0, len(row), 16):
+            out.append("    " + ", ".join(row[i:i + 16]) + ",")
+        out.append("};")
+        map_ref = "%s_map" % name
+    out.append("const FontDef %s = { %d, %d, %d, %s_data, %d, %d, %s };"
+               % (name, font["width"], font["height"], font["bytes"], name,
+                  first, last, map_ref))
+    out.append("")
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("--chars", help="characters to keep")
+    ap.add_argument("--scan", nargs="*", default=[], help="sources to scan for literals and font names")
+    ap.add_argument("--fonts", nargs="*", help="fonts to emit (default: those referenced by --scan, else all)")
+    ap.add_argument("--in", dest="src", default=FONTS_C)
+    ap.add_argument("-o", dest="out", default=OUT_C)
+    args = ap.parse_args()
+
+    fonts = load_fonts(args.src)
+    chars, used = scan_sources(args.scan, fonts)
+    if args.chars:
+        chars.update(ord(c) for c in args.chars)
+    if not chars:
+        sys.exit("no characters selected; use --chars or --scan")
+    chars.add(ord("?"))
+    names = set(args.fonts or used or fonts)
+    names.add("Font6x8")
+    names = sorted(names)
+
+    out = ["// Generated by tools/fontsubset.py -- do not edit.",
+           "// Glyph subset of ssd1306_fonts.c; build with SSD1306_FONT_SUBSET.",
+           "",
+           "#include <stddef.h>",
+           '#include "ssd1306_fonts.h"',
+           "",
+           "#ifdef SSD1306_FONT_SUBSET",
+           ""]
+    full = kept = 0
+    for name in names:
+        if name not in fonts:
+            sys.exit("unknown font %s" % name)
+        out += emit_font(name, fonts[name], chars)
+        full += len(fonts[name]["glyphs"]) * fonts[name]["bytes"]
+        kept += len([c for c in chars if c in fonts[name]["glyphs"]]) * fonts[name]["bytes"]
+    # Fonts the build does not reference are still declared in the header;
+    # leaving them undefined turns an accidental use into a link error.
+    out.append("#endif // SSD1306_FONT_SUBSET")
+    open(args.out, "w").write("\n".join(out) + "\n")
+    print("%s: %d glyph bytes (full fonts: %d)" % (args.out, kept, full))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,505 @@
+// ssd1306_bench.c - Host frame-rate benchmark for the SSD1306 driver.
+//
+// Runs the driver against the model bus and panel of ssd1306_host.h and
+// draws representative scenes on a 128x64 panel, flushing each frame with
+// SSD1306_Display():
+//
+//   full clear   the whole screen filled, alternately on and off;
+//   text         18 x 8 characters of Font6x8, all changing;
+//   bitmaps      six 32x32 sprites moving over a cleared screen;
+//   counter      a five-digit counter in Font8x12_bold counting up, so one
+//                digit changes per frame;
+//   counter, delta   the same with delta flushes.
+//
+// For each it reports the bus traffic of one frame as the model counted it
+// (payload bytes, STARTs and STOPs, SCL bit times, busy polls of the
+// blocking writes at 400 kHz, interrupts when sent with DisplayAsync()), the
+// frame rate the bus sustains at 100 kHz, 400 kHz and 1 MHz, and the host
+// time per frame spent drawing and planning the flush. Built with
+// -DSSD1306_TRANSPORT=1 it does the same over SPI: bytes, SCK periods, polls
+// at 10 MHz and frame rates at 4, 8 and 10 MHz.
+//
+// It then times drawing calls against the code they replaced:
+//
+//   fills    FillRect, DrawHLine, DrawVLine and DrawRect against DrawPixel
+//            loops.
+//   glyphs   WriteChar in each font, on a page boundary and across two
+//            pages, and a line of text, against drawing every pixel of the
+//            glyph box.
+//   rotation the glyphs again with the display turned 90, 180 and 270
+//            degrees: quarter turns go through the 8x8 transpose, a half turn
+//            is the panel's remap and costs nothing.
+//   shapes   FillCircle against concentric DrawCircle outlines, the way
+//            discs were drawn without it, and FillTriangle, FillRoundRect
+//            and FillArc against per-pixel inside tests.
+//   numbers  the integer formatter behind WriteInt and WriteFixed against
+//            the float_to_string() they used to go through, as WriteInt
+//            called it and with the value scaled to a float for decimals.
+//
+// The bus figures are those of the real bus; the times only compare revisions
+// of the driver, they say little about a Cortex-M4.
+//
+// Build from this directory against the TivaWare headers, for example:
+//
+//   gcc -O2 -I$TIVAWARE -o ssd1306_bench ssd1306_bench.c -lm && ./ssd1306_bench
+//
+// An optional argument gives the number of frames per scene (default 200).
+
+#include "ssd1306_host.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// System clocks per pass of a busy polling loop (a guess: the ROM call and
+// the loop around it)
+#define BENCH_POLL_CYCLES 12
+
+// Bit rates the frame rates are given for, and the one the busy polls are
+// counted at
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+#define BENCH_LINK "I2C"
+#define BENCH_CLOCK "SCL"
+#define BENCH_POLL_HZ 400000
+static const uint32_t g_rates[3] = { 100000, 400000, 1000000 };
+#else
+#define BENCH_LINK "SPI"
+#define BENCH_CLOCK "SCK"
+#define BENCH_POLL_HZ 10000000
+static const uint32_t g_rates[3] = { 4000000, 8000000, 10000000 };
+#endif
+
+// "400k", "10M"
+static const char *rate_label(char *buf, uint32_t hz)
+{
+    if (hz >= 1000000 && hz % 1000000 == 0) sprintf(buf, "%luM", (unsigned long)(hz / 1000000));
+    else sprintf(buf, "%luk", (unsigned long)(hz / 1000));
+    return buf;
+}
+
+static SSD1306_Device g_bench_dev;
+static uint8_t g_bench_fb[2][SSD1306_BUFFER_BYTES(64)];
+static uint8_t g_bench_shadow[SSD1306_BUFFER_BYTES(64)];
+static uint8_t g_sprite[32 * 4];
+
+typedef struct {
+    const char *name;
+    void (*setup)(void);
+    void (*draw)(uint32_t frame);
+} BenchScene;
+
+// --- Scenes ---
+static void scene_clear(uint32_t frame)
+{
+    SSD1306_FillRect(0, 0, 128, 64, frame & 1);
+}
+
+static void setup_text(void)
+{
+    ssd1306_SetFont(&Font6x8);
+}
+
+static void scene_text(uint32_t frame)
+{
+    char line[24];
+    uint8_t row;
+    for (row = 0; row < 8; ++row) {
+        snprintf(line, sizeof(line), "%u:%08lX %7lu", (unsigned)row,
+                 (unsigned long)(frame * 2654435761u + row), (unsigned long)frame);
+        SSD1306_SetCursor(0, row * 8);
+        SSD1306_WriteString(line);
+    }
+}
+
+static void setup_bitmaps(void)
+{
+    uint8_t x, y;
+    // a ring, page-major like the exporters produce
+    memset(g_sprite, 0, sizeof(g_sprite));
+    for (y = 0; y < 32; ++y) {
+        for (x = 0; x < 32; ++x) {
+            int16_t dx = 2 * x - 31, dy = 2 * y - 31, d2 = dx * dx + dy * dy;
+            if (d2 < 31 * 31 && d2 > 20 * 20) g_sprite[(y / 8) * 32 + x] |= 1 << (y & 7);
+        }
+    }
+}
+
+static void scene_bitmaps(uint32_t frame)
+{
+    uint8_t i;
+    SSD1306_FillRect(0, 0, 128, 64, false);
+    for (i = 0; i < 6; ++i) {
+        int16_t x = (frame * (i + 1) + i * 21) % 112 - 8;
+        int16_t y = (frame * (7 - i) + i * 11) % 48 - 8;
+        SSD1306_BlitBitmap(x, y, g_sprite, 32, 32, SSD1306_ROP_OR);
+    }
+}
+
+static void setup_counter(void)
+{
+    scene_text(0);
+    SSD1306_Display();
+    ssd1306_SetFont(&Font8x12_bold);
+}
+
+static void setup_counter_delta(void)
+{
+    setup_counter();
+    SSD1306_SetDeltaFlush(true, g_bench_shadow);
+    SSD1306_Invalidate();
+}
+
+static void scene_counter(uint32_t frame)
+{
+    SSD1306_SetCursor(40, 26);
+    SSD1306_WriteInt(10000 + frame);
+}
+
+static const BenchScene g_scenes[] = {
+    { "full clear", NULL, scene_clear },
+    { "text", setup_text, scene_text },
+    { "bitmaps", setup_bitmaps, scene_bitmaps },
+    { "counter", setup_counter, scene_counter },
+    { "counter, delta", setup_counter_delta, scene_counter },
+};
+
+static void bench_scene(const BenchScene *scene, uint32_t frames)
+{
+    SSD1306_Stats stats;
+    uint64_t draw = 0, plan = 0, t0;
+    uint32_t bytes, starts, stops, bits, polls, irqs, i;
+    uint8_t page, col;
+
+    host_reset();
+    host_init_device(&g_bench_dev, 128, 64, g_bench_fb[0], g_bench_fb[1]);
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+    SSD1306_SetBusSpeed(I2C0_BASE, HOST_SYSCLK, BENCH_POLL_HZ);
+#else
+    g_host.ssi_hz = BENCH_POLL_HZ;
+#endif
+    if (scene->setup) scene->setup();
+    // the first frame sends what setup left dirty
+    scene->draw(0);
+    SSD1306_Display();
+
+    g_host.poll_cycles = BENCH_POLL_CYCLES;
+    g_host.starts = g_host.stops = g_host.bytes = g_host.bit_times = g_host.polls = 0;
+    SSD1306_ResetStats();
+    for (i = 1; i <= frames; ++i) {
+        t0 = host_now();
+        scene->draw(i);
+        draw += host_now() - t0;
+        SSD1306_Display();
+        SSD1306_GetStats(&stats);
+        plan += stats.last_cpu_cycles;
+    }
+    bytes = g_host.bytes / frames;
+    starts = g_host.starts / frames;
+    stops = g_host.stops / frames;
+    bits = g_host.bit_times / frames;
+    polls = g_host.polls / frames;
+    if (stats.bit_times != g_host.bit_times)
+        printf("  (driver counted %lu bit times, the bus %lu)\n",
+               (unsigned long)stats.bit_times, (unsigned long)g_host.bit_times);
+
+    // one more frame in the background, for the interrupt count
+    g_host.poll_cycles = 0;
+    scene->draw(frames + 1);
+    SSD1306_DisplayAsync(NULL);
+    SSD1306_WaitFrame();
+    SSD1306_GetStats(&stats);
+    irqs = stats.interrupts;
+    for (page = 0; page < 8; ++page) {
+        for (col = 0; col < 128; ++col) {
+            if (host_panel_ram(HOST_PANEL, page, col) !=
+                g_bench_dev.buffer[page * SSD1306_STRIDE + col]) {
+                printf("  (the panel does not show the framebuffer)\n");
+                page = 8;
+                break;
+            }
+        }
+    }
+
+    printf("%-15s %6lu %5lu %5lu %7lu %8lu %5lu %7.1f %7.1f %7.1f %8lu %7lu\n",
+           scene->name, (unsigned long)bytes, (unsigned long)starts, (unsigned long)stops,
+           (unsigned long)bits, (unsigned long)polls, (unsigned long)irqs,
+           bits ? (double)g_rates[0] / bits : 0.0, bits ? (double)g_rates[1] / bits : 0.0,
+           bits ? (double)g_rates[2] / bits : 0.0,
+           (unsigned long)(draw / frames), (unsigned long)(plan / frames));
+}
+
+// --- Drawing kernels against per-pixel code ---
+typedef struct {
+    const char *name;
+    void (*now)(void);
+    void (*before)(void);       // the same the way it was done before
+} BenchPair;
+
+static uint64_t bench_time(void (*fn)(void), uint32_t reps)
+{
+    uint64_t t0 = host_now();
+    uint32_t i;
+    for (i = 0; i < reps; ++i) fn();
+    return (host_now() - t0) / reps;
+}
+
+static void bench_pairs(const char *title, const char *before, const BenchPair *pair, uint8_t n,
+                        uint32_t reps)
+{
+    uint8_t i;
+    printf("\n%-24s %10s %10s %8s\n", title, "driver", before, "speedup");
+    for (i = 0; i < n; ++i, ++pair) {
+        uint64_t k = bench_time(pair->now, reps);
+        uint64_t p = bench_time(pair->before, reps);
+        printf("%-24s %10lu %10lu %7.1fx\n", pair->name, (unsigned long)k, (unsigned long)p,
+               k ? (double)p / k : 0.0);
+    }
+}
+
+// The loops FillRect and DrawRect ran before the page kernels
+static void pixel_rect(int16_t x, int16_t y, int16_t w, int16_t h, bool color)
+{
+    int16_t i, j;
+    for (i = x; i < x + w; ++i)
+        for (j = y; j < y + h; ++j) SSD1306_DrawPixel(i, j, color);
+}
+
+static void fill_screen(void) { SSD1306_FillRect(0, 0, 128, 64, true); }
+static void pixel_screen(void) { pixel_rect(0, 0, 128, 64, true); }
+static void fill_box(void) { SSD1306_FillRect(5, 3, 30, 21, false); }
+static void pixel_box(void) { pixel_rect(5, 3, 30, 21, false); }
+static void hline(void) { SSD1306_DrawHLine(10, 37, 100, true); }
+static void pixel_hline(void) { pixel_rect(10, 37, 100, 1, true); }
+static void vline(void) { SSD1306_DrawVLine(77, 2, 60, true); }
+static void pixel_vline(void) { pixel_rect(77, 2, 1, 60, true); }
+static void frame(void) { SSD1306_DrawRect(3, 5, 110, 50, true); }
+
+static void pixel_frame(void)
+{
+    pixel_rect(3, 5, 110, 1, true);
+    pixel_rect(3, 54, 110, 1, true);
+    pixel_rect(3, 5, 1, 50, true);
+    pixel_rect(112, 5, 1, 50, true);
+}
+
+static const BenchPair g_fills[] = {
+    { "FillRect 128x64", fill_screen, pixel_screen },
+    { "FillRect 30x21", fill_box, pixel_box },
+    { "DrawHLine 100", hline, pixel_hline },
+    { "DrawVLine 60", vline, pixel_vline },
+    { "DrawRect 110x50", frame, pixel_frame },
+};
+
+// WriteChar before the blitter: every pixel of the glyph box through
+// DrawPixel, then the cursor moves on
+static void pixel_char(char c)
+{
+    SSD1306_Device *dev = g_dev;
+    const FontDef *font = dev->font;
+    const uint8_t *data = font_glyph(font, c);
+    uint8_t col, row, per_col = (font->height + 7) / 8;
+    if (!data) data = font_glyph(font, '?');
+    for (col = 0; col < font->width; ++col)
+        for (row = 0; row < font->height; ++row)
+            SSD1306_DrawPixel(dev->cursor_x + col, dev->cursor_y + row,
+                              (data[col * per_col + row / 8] >> (row & 7)) & 1);
+    dev->cursor_x += font->width + 1;
+    if (dev->cursor_x + font->width >= dev->view_width) {
+        dev->cursor_x = 0;
+        dev->cursor_y += font->height + 1;
+    }
+}
+
+static void glyph_at(const FontDef *font, int16_t y, bool pixels)
+{
+    ssd1306_SetFont(font);
+    SSD1306_SetCursor(40, y);
+    if (pixels) pixel_char('g');
+    else SSD1306_WriteChar('g');
+}
+
+static void char6(void) { glyph_at(&Font6x8, 8, false); }
+static void pixel_char6(void) { glyph_at(&Font6x8, 8, true); }
+static void char6_shifted(void) { glyph_at(&Font6x8, 11, false); }
+static void pixel_char6_shifted(void) { glyph_at(&Font6x8, 11, true); }
+static void char8(void) { glyph_at(&Font8x12_bold, 16, false); }
+static void pixel_char8(void) { glyph_at(&Font8x12_bold, 16, true); }
+static void char8_shifted(void) { glyph_at(&Font8x12_bold, 13, false); }
+static void pixel_char8_shifted(void) { glyph_at(&Font8x12_bold, 13, true); }
+static void char12(void) { glyph_at(&Font12x16, 24, false); }
+static void pixel_char12(void) { glyph_at(&Font12x16, 24, true); }
+static void char12_shifted(void) { glyph_at(&Font12x16, 21, false); }
+static void pixel_char12_shifted(void) { glyph_at(&Font12x16, 21, true); }
+
+static const char g_line[] = "Temp 23.5C RPM 1200";
+
+static void text_line(void)
+{
+    ssd1306_SetFont(&Font6x8);
+    SSD1306_SetCursor(0, 40);
+    SSD1306_WriteString(g_line);
+}
+
+static void pixel_text_line(void)
+{
+    const char *s;
+    ssd1306_SetFont(&Font6x8);
+    SSD1306_SetCursor(0, 40);
+    for (s = g_line; *s; ++s) pixel_char(*s);
+}
+
+static const BenchPair g_glyphs[] = {
+    { "Font6x8", char6, pixel_char6 },
+    { "Font6x8, 3 rows down", char6_shifted, pixel_char6_shifted },
+    { "Font8x12_bold", char8, pixel_char8 },
+    { "Font8x12_bold, 5 down", char8_shifted, pixel_char8_shifted },
+    { "Font12x16", char12, pixel_char12 },
+    { "Font12x16, 3 down", char12_shifted, pixel_char12_shifted },
+    { "line of 19 in Font6x8", text_line, pixel_text_line },
+};
+
+// Filled shapes against the way they were drawn before there were fills:
+// a disc as concentric outlines, the rest pixel by pixel
+static void circle(void) { SSD1306_FillCircle(64, 32, 30, true); }
+
+static void concentric_circle(void)
+{
+    int16_t r;
+    for (r = 0; r <= 30; ++r) SSD1306_DrawCircle(64, 32, r, true);
+}
+
+static void triangle(void) { SSD1306_FillTriangle(10, 60, 64, 4, 118, 50, true); }
+
+static int32_t edge(int16_t ax, int16_t ay, int16_t bx, int16_t by, int16_t x, int16_t y)
+{
+    return (int32_t)(bx - ax) * (y - ay) - (int32_t)(by - ay) * (x - ax);
+}
+
+static void pixel_triangle(void)
+{
+    int16_t x, y;
+    for (x = 10; x <= 118; ++x)
+        for (y = 4; y <= 60; ++y)
+            if (edge(10, 60, 64, 4, x, y) >= 0 && edge(64, 4, 118, 50, x, y) >= 0
+                && edge(118, 50, 10, 60, x, y) >= 0)
+                SSD1306_DrawPixel(x, y, true);
+}
+
+static void round_rect(void) { SSD1306_FillRoundRect(14, 12, 100, 40, 8, true); }
+
+static void pixel_round_rect(void)
+{
+    int16_t x, y;
+    for (x = 0; x < 100; ++x) {
+        for (y = 0; y < 40; ++y) {
+            int16_t dx = x < 8 ? 8 - x : (x > 91 ? x - 91 : 0);
+            int16_t dy = y < 8 ? 8 - y : (y > 31 ? y - 31 : 0);
+            if (dx * dx + dy * dy <= 8 * 8 + 8) SSD1306_DrawPixel(14 + x, 12 + y, true);
+        }
+    }
+}
+
+static void arc(void) { SSD1306_FillArc(64, 40, 30, 20, 200, 340, true); }
+
+static void pixel_arc(void)
+{
+    int16_t dx, dy;
+    for (dx = -30; dx <= 30; ++dx) {
+        for (dy = -30; dy <= 30; ++dy) {
+            int32_t d2 = dx * dx + dy * dy;
+            double deg = atan2(dy, dx) * 180.0 / M_PI;
+            if (deg < 0) deg += 360.0;
+            if (d2 <= 30 * 30 + 30 && d2 > 20 * 20 - 20 && deg >= 200.0 && deg <= 340.0)
+                SSD1306_DrawPixel(64 + dx, 40 + dy, true);
+        }
+    }
+}
+
+static const BenchPair g_shapes[] = {
+    { "FillCircle r30", circle, concentric_circle },
+    { "FillTriangle", triangle, pixel_triangle },
+    { "FillRoundRect 100x40 r8", round_rect, pixel_round_rect },
+    { "FillArc r30-20 140deg", arc, pixel_arc },
+};
+
+// Formatting alone. The value is read back through a volatile so the calls
+// are not folded at compile time, and the text is kept.
+static volatile int32_t g_value;
+static char g_text[32];
+static volatile char g_text_sink;
+
+static void format_int(int32_t v)
+{
+    g_value = v;
+    g_text_sink = *fixed_to_string(g_value, 0, g_text + sizeof(g_text));
+}
+
+static void float_int(int32_t v)
+{
+    g_value = v;
+    float_to_string(g_value, g_text, 0);
+    g_text_sink = g_text[0];
+}
+
+static void format_fixed(int32_t v)
+{
+    g_value = v;
+    g_text_sink = *fixed_to_string(g_value, 2, g_text + sizeof(g_text));
+}
+
+static void float_fixed(int32_t v)
+{
+    g_value = v;
+    float_to_string(g_value / 100.0f, g_text, 2);
+    g_text_sink = g_text[0];
+}
+
+static void int_small(void) { format_int(7); }
+static void float_small(void) { float_int(7); }
+static void int_5(void) { format_int(-12345); }
+static void float_5(void) { float_int(-12345); }
+static void int_10(void) { format_int(2000000001); }
+static void float_10(void) { float_int(2000000001); }
+static void fixed_2(void) { format_fixed(-2345); }
+static void float_2(void) { float_fixed(-2345); }
+static void fixed_8(void) { format_fixed(12345678); }
+static void float_8(void) { float_fixed(12345678); }
+
+static const BenchPair g_numbers[] = {
+    { "7", int_small, float_small },
+    { "-12345", int_5, float_5 },
+    { "2000000001", int_10, float_10 },
+    { "-23.45", fixed_2, float_2 },
+    { "123456.78", fixed_8, float_8 },
+};
+
+int main(int argc, char *argv[])
+{
+    uint32_t frames = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200;
+    char poll_at[12], rate[3][8], title[32];
+    uint8_t i;
+
+    if (frames == 0) frames = 1;
+    sprintf(poll_at, "@%sHz", rate_label(rate[0], BENCH_POLL_HZ));
+    for (i = 0; i < 3; ++i) rate_label(rate[i], g_rates[i]);
+    printf("128x64 panel on " BENCH_LINK ", %lu frames per scene; per frame:\n", (unsigned long)frames);
+    printf("%-15s %6s %5s %5s %7s %8s %5s %23s %16s\n", "", "", "", "", "bit",
+           "polls", "", "frames/s at " BENCH_CLOCK, "host " HOST_UNIT "s");
+    printf("%-15s %6s %5s %5s %7s %8s %5s %7s %7s %7s %8s %7s\n", "scene", "bytes",
+           "START", "STOP", "times", poll_at, "irqs", rate[0], rate[1], rate[2], "draw", "plan");
+    for (i = 0; i < sizeof(g_scenes) / sizeof(g_scenes[0]); ++i)
+        bench_scene(&g_scenes[i], frames);
+
+    printf("\nhost %ss per call\n", HOST_UNIT);
+    bench_pairs("fills", "per-pixel", g_fills, sizeof(g_fills) / sizeof(g_fills[0]), 20 * frames);
+    bench_pairs("glyphs", "per-pixel", g_glyphs, sizeof(g_glyphs) / sizeof(g_glyphs[0]), 20 * frames);
+    for (i = SSD1306_ROTATE_90; i <= SSD1306_ROTATE_270; ++i) {
+        SSD1306_SetRotation(i);
+        sprintf(title, "glyphs, %u degrees", 90u * i);
+        bench_pairs(title, "per-pixel", g_glyphs, sizeof(g_glyphs) / sizeof(g_glyphs[0]), 20 * frames);
+    }
+    SSD1306_SetRotation(SSD1306_ROTATE_0);
+    bench_pairs("shapes", "before", g_shapes, sizeof(g_shapes) / sizeof(g_shapes[0]), 20 * frames);
+    bench_pairs("numbers", "float", g_numbers, sizeof(g_numbers) / sizeof(g_numbers[0]), 200 * frames);
+    return 0;
+}
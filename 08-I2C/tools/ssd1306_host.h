@@ -0,0 +1,681 @@
+// ssd1306_host.h - The SSD1306 driver on a PC, against a model bus and panel.
+//
+// Included once by each host tool in this directory. It builds ../ssd1306.c,
+// the transport picked by SSD1306_TRANSPORT and the fonts into the tool, with
+// SSD1306_STATS on, and replaces the driverlib calls they make:
+//
+//   I2C master   executes each I2CMasterControl() command at once, counting
+//                STARTs, STOPs, payload bytes (control bytes included) and
+//                SCL bit times, and keeps I2CMasterBusy() true for as many
+//                polls as the command would take on the bus at the rate set
+//                in MTPR, if g_host.poll_cycles says how long one poll is.
+//                Addresses 0x3C and 0x3D on each module answer; others, and
+//                every panel above g_host.panel_max_hz, are not acknowledged.
+//   SSI master   with SSD1306_TRANSPORT_SSI: SSIDataPut() and uDMA transfers
+//                clock each byte into the panel at once, as data or command
+//                by the D/C pin of the module (PA6 for SSI0, as in main.c).
+//                Bytes stay in flight until SSIBusy() returns false; a D/C
+//                change before that counts in g_host.dc_glitches. A uDMA
+//                transfer must be a basic one of 1 to 1024 bytes into the
+//                data register of the SSI its channel serves, with a control
+//                table aligned to 1 KiB, or it counts in g_host.dma_errors.
+//                It raises the SSI interrupt when started and keeps
+//                uDMAChannelIsEnabled() true for as many polls as it would
+//                take at g_host.ssi_hz.
+//   panel        one per I2C address and per SSI module: an SSD1306 in
+//                horizontal addressing mode: commands and their
+//                arguments, the column/page window, segment and COM remap,
+//                start line, display on/off and scrolling, and display RAM,
+//                which host_panel_pixel() shows as it appears on the glass.
+//   interrupts   IntMasterDisable()/IntMasterEnable() mask and unmask; a
+//                pending interrupt is taken as soon as it is enabled and
+//                unmasked, so an async flush runs to completion inside the
+//                call that starts it. Set g_host.hold to keep interrupts
+//                pending until host_step() or host_run() takes them.
+//
+// The DWT cycle counter reads the host's time stamp counter (nanoseconds where
+// there is none), so SSD1306_Stats.last_cpu_cycles is host time.
+#ifndef SSD1306_HOST_H
+#define SSD1306_HOST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "inc/hw_types.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOST_UNIT "cycle"
+#define host_now() __rdtsc()
+#else
+#define HOST_UNIT "ns"
+static uint64_t host_now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + t.tv_nsec;
+}
+#endif
+
+// Registers the driver touches through HWREG: the DWT and the I2C MTPR
+static volatile uint32_t *host_reg(uint32_t addr);
+#undef HWREG
+#define HWREG(x) (*host_reg(x))
+
+#ifndef SSD1306_STATS
+#define SSD1306_STATS
+#endif
+
+#include "../ssd1306.c"
+#include "../ssd1306_i2c.c"
+#include "../ssd1306_ssi.c"
+#include "../ssd1306_fonts.c"
+#include "../ssd1306_widgets.c"
+
+// System clock of the example, against which MTPR gives the SCL rate
+#define HOST_SYSCLK 80000000u
+
+// --- Model panel ---
+typedef struct {
+    uint8_t ram[8][128];        // display RAM, indexed by segment
+    uint8_t col0, col1, page0, page1;   // address window
+    uint8_t col, page;          // next byte goes here
+    uint8_t start_line;
+    uint8_t mux;                // rows shown
+    bool seg_remap;             // A1: column address c drives segment 127 - c
+    bool com_remap;             // C8: COM scan from COM[mux - 1] to COM0
+    bool on;
+    bool inverse;
+    bool scrolling;
+    uint8_t contrast;
+    uint8_t cmd[8];             // command being assembled
+    uint8_t cmd_len;
+} HostPanel;
+
+static struct {
+    uint32_t starts, stops;     // START and STOP conditions
+    uint32_t bytes;             // bytes acknowledged after the address, or sent on SSI
+    uint32_t bit_times;         // SCL or SSI clock periods
+    uint32_t polls;             // calls to I2CMasterBusy(), SSIBusy() and uDMAChannelIsEnabled()
+    uint32_t commands;          // commands parsed by the panels
+    uint32_t violations;        // data written to a scrolling panel
+    uint32_t dc_glitches;       // D/C changes with bytes in flight
+    uint32_t dma_errors;        // uDMA set up wrongly
+    uint32_t stale_irqs;        // I2C commands issued with the last one's interrupt pending
+    uint32_t poll_cycles;       // system clocks per busy poll, 0: never busy
+    uint32_t panel_max_hz;      // fastest SCL the panels follow, 0: any
+    uint32_t nack_after;        // bytes until one is not acknowledged, 0: never
+    uint32_t ssi_hz;            // SSI bit rate
+    uint8_t cmd_log[64];        // command bytes the panels took, oldest first
+    uint8_t cmd_logged;         // ... up to 64; clear to start again
+    uint32_t cyccnt;
+    bool masked;
+    bool in_isr;
+    bool hold;
+} g_host;
+
+static HostPanel g_host_panel[4][2];   // [I2C or SSI module][I2C address bit 0]
+
+static void host_panel_reset(HostPanel *p)
+{
+    memset(p, 0, sizeof(*p));
+    p->col1 = 127;
+    p->page1 = 7;
+    p->mux = 64;
+    p->contrast = 0x7F;
+}
+
+static uint8_t host_cmd_args(uint8_t cmd)
+{
+    switch (cmd) {
+    case 0x26: case 0x27:
+        return 6;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    }
+    return 0;
+}
+
+static void host_panel_command(HostPanel *p, uint8_t b)
+{
+    const uint8_t *c = p->cmd;
+    if (g_host.cmd_logged < sizeof(g_host.cmd_log)) g_host.cmd_log[g_host.cmd_logged++] = b;
+    p->cmd[p->cmd_len++] = b;
+    if (p->cmd_len <= host_cmd_args(c[0])) return;
+    p->cmd_len = 0;
+    g_host.commands++;
+    if (c[0] >= 0x40 && c[0] <= 0x7F) p->start_line = c[0] & 0x3F;
+    else if (c[0] >= 0xC0 && c[0] <= 0xCF) p->com_remap = c[0] >= 0xC8;
+    switch (c[0]) {
+    case 0x21: p->col0 = p->col = c[1] & 0x7F; p->col1 = c[2] & 0x7F; break;
+    case 0x22: p->page0 = p->page = c[1] & 7; p->page1 = c[2] & 7; break;
+    case 0x81: p->contrast = c[1]; break;
+    case 0xA8: p->mux = (c[1] & 0x3F) + 1; break;
+    case 0xA0: case 0xA1: p->seg_remap = c[0] & 1; break;
+    case 0xA6: case 0xA7: p->inverse = c[0] & 1; break;
+    case 0xAE: case 0xAF: p->on = c[0] & 1; break;
+    case 0x2E: p->scrolling = false; break;
+    case 0x2F: p->scrolling = true; break;
+    }
+}
+
+static void host_panel_data(HostPanel *p, uint8_t b)
+{
+    if (p->scrolling) g_host.violations++;
+    p->ram[p->page][p->seg_remap ? 127 - p->col : p->col] = b;
+    if (p->col++ == p->col1) {
+        p->col = p->col0;
+        p->page = (p->page == p->page1) ? p->page0 : p->page + 1;
+    }
+}
+
+// Byte of display RAM at column address col, as the current remap maps it
+static inline uint8_t host_panel_ram(const HostPanel *p, uint8_t page, uint8_t col)
+{
+    return p->ram[page][p->seg_remap ? 127 - col : col];
+}
+
+// Pixel (x, y) on the glass as the panel scans display RAM out: segment
+// 127 - x, and COM y counted from the end without the COM remap, both from
+// the start line on. With the driver's default remap (A1, C8) that is column
+// address x, row y.
+static inline bool host_panel_pixel(const HostPanel *p, uint8_t x, uint8_t y)
+{
+    uint8_t row = ((p->com_remap ? y : p->mux - 1 - y) + p->start_line) & 63;
+    return p->ram[row / 8][127 - x] >> (row & 7) & 1;
+}
+
+static void host_deliver(void);
+
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+// --- Model I2C master ---
+static struct {
+    uint32_t mtpr;
+    uint8_t addr;
+    bool receive;
+    uint8_t data;
+    HostPanel *panel;           // panel addressed by the transaction, NULL if none
+    bool control;               // next byte is the control byte
+    bool data_mode;             // ... which said data
+    uint32_t err;
+    uint32_t busy;              // polls left until the last command is done
+    bool int_enabled;
+    bool int_pending;
+    void (*handler)(void);
+} g_host_i2c[4];
+
+static uint32_t host_scl_hz(uint8_t bus)
+{
+    return HOST_SYSCLK / (20 * (g_host_i2c[bus].mtpr + 1));
+}
+
+static HostPanel *host_i2c_panel(uint32_t i2c_base, uint8_t addr)
+{
+    if (addr != 0x3C && addr != 0x3D) return NULL;
+    return &g_host_panel[I2C_BUS(i2c_base)][addr & 1];
+}
+
+static void host_i2c_byte(uint8_t bus, uint8_t b)
+{
+    HostPanel *p = g_host_i2c[bus].panel;
+    if (!p) return;
+    if (g_host.nack_after && --g_host.nack_after == 0) {
+        g_host_i2c[bus].err = I2C_MASTER_ERR_DATA_ACK;
+        g_host_i2c[bus].panel = NULL;
+        return;
+    }
+    g_host.bytes++;
+    if (g_host_i2c[bus].control) {
+        g_host_i2c[bus].control = false;
+        g_host_i2c[bus].data_mode = b & 0x40;
+        p->cmd_len = 0;
+    } else if (g_host_i2c[bus].data_mode) {
+        host_panel_data(p, b);
+    } else {
+        host_panel_command(p, b);
+    }
+}
+
+void I2CMasterSlaveAddrSet(uint32_t ui32Base, uint8_t ui8SlaveAddr, bool bReceive)
+{
+    g_host_i2c[I2C_BUS(ui32Base)].addr = ui8SlaveAddr;
+    g_host_i2c[I2C_BUS(ui32Base)].receive = bReceive;
+}
+
+void I2CMasterDataPut(uint32_t ui32Base, uint8_t ui8Data)
+{
+    g_host_i2c[I2C_BUS(ui32Base)].data = ui8Data;
+}
+
+uint32_t I2CMasterDataGet(uint32_t ui32Base)
+{
+    return g_host_i2c[I2C_BUS(ui32Base)].data;
+}
+
+void I2CMasterControl(uint32_t ui32Base, uint32_t ui32Cmd)
+{
+    uint8_t bus = I2C_BUS(ui32Base);
+    uint32_t bits = 0;
+
+    if (ui32Cmd == I2C_MASTER_CMD_BURST_SEND_START || ui32Cmd == I2C_MASTER_CMD_SINGLE_SEND) {
+        HostPanel *p = host_i2c_panel(ui32Base, g_host_i2c[bus].addr);
+        if (g_host.panel_max_hz && host_scl_hz(bus) > g_host.panel_max_hz) p = NULL;
+        g_host.starts++;
+        bits = 1 + 9;
+        g_host_i2c[bus].err = p ? I2C_MASTER_ERR_NONE : I2C_MASTER_ERR_ADDR_ACK;
+        g_host_i2c[bus].panel = p;
+        if (g_host_i2c[bus].receive) {
+            // single-byte read of the status register: bit 6 = display off
+            if (p) g_host_i2c[bus].data = p->on ? 0x00 : 0x40;
+            g_host_i2c[bus].panel = NULL;
+        } else {
+            g_host_i2c[bus].control = true;
+            host_i2c_byte(bus, g_host_i2c[bus].data);
+        }
+        bits += 9;
+        if (ui32Cmd == I2C_MASTER_CMD_SINGLE_SEND) {
+            g_host.stops++;
+            bits += 1;
+        }
+    } else if (ui32Cmd == I2C_MASTER_CMD_BURST_SEND_CONT || ui32Cmd == I2C_MASTER_CMD_BURST_SEND_FINISH) {
+        host_i2c_byte(bus, g_host_i2c[bus].data);
+        bits = 9;
+        if (ui32Cmd == I2C_MASTER_CMD_BURST_SEND_FINISH) {
+            g_host.stops++;
+            bits += 1;
+        }
+    } else if (ui32Cmd == I2C_MASTER_CMD_BURST_SEND_ERROR_STOP) {
+        g_host.stops++;
+        bits = 1;
+    }
+    g_host.bit_times += bits;
+    // the handler would be entered for the old interrupt with this command
+    // still on the bus
+    if (g_host_i2c[bus].int_pending && g_host_i2c[bus].int_enabled) g_host.stale_irqs++;
+    g_host_i2c[bus].busy = g_host.poll_cycles ?
+        (uint32_t)((uint64_t)bits * HOST_SYSCLK / host_scl_hz(bus) / g_host.poll_cycles) : 0;
+    g_host_i2c[bus].int_pending = true;
+    host_deliver();
+}
+
+bool I2CMasterBusy(uint32_t ui32Base)
+{
+    uint8_t bus = I2C_BUS(ui32Base);
+    g_host.polls++;
+    if (!g_host_i2c[bus].busy) return false;
+    g_host_i2c[bus].busy--;
+    return true;
+}
+
+uint32_t I2CMasterErr(uint32_t ui32Base)
+{
+    return g_host_i2c[I2C_BUS(ui32Base)].err;
+}
+
+void I2CMasterIntEnable(uint32_t ui32Base) { g_host_i2c[I2C_BUS(ui32Base)].int_enabled = true; }
+void I2CMasterIntDisable(uint32_t ui32Base) { g_host_i2c[I2C_BUS(ui32Base)].int_enabled = false; }
+void I2CMasterIntClear(uint32_t ui32Base) { g_host_i2c[I2C_BUS(ui32Base)].int_pending = false; }
+
+// Registers the handler and enables it in the NVIC, as the driverlib call does
+void I2CIntRegister(uint32_t ui32Base, void (*pfnHandler)(void))
+{
+    g_host_i2c[I2C_BUS(ui32Base)].handler = pfnHandler;
+}
+
+#else
+// --- Model SSI masters, D/C pins and uDMA ---
+static struct {
+    uint32_t dc_port;           // GPIO wired to the panel's D/C
+    uint8_t dc_pin;
+    bool dc;                    // D/C level: high = data
+    uint32_t in_flight;         // bytes sent since SSIBusy() last returned false
+    uint32_t busy;              // polls left until the FIFO is empty
+    bool int_enabled;           // in the NVIC
+    bool int_pending;
+    void (*handler)(void);
+} g_host_ssi[4];
+
+// uDMA channels by number
+static struct {
+    uint32_t control;
+    uint32_t mode;
+    const uint8_t *src;
+    uint32_t len;               // bytes set up, 0 once started
+    uint32_t busy;              // polls left until the transfer is done
+} g_host_dma[32];
+
+static void *g_host_dma_table;
+
+static const uint32_t g_host_ssi_base[4] = { SSI0_BASE, SSI1_BASE, SSI2_BASE, SSI3_BASE };
+static const uint32_t g_host_ssi_int[4] = { INT_SSI0, INT_SSI1, INT_SSI2, INT_SSI3 };
+
+// SSI module whose TX requests a uDMA channel serves, -1 if none
+static int8_t host_dma_ssi(uint32_t channel)
+{
+    switch (channel) {
+    case 11: return 0;
+    case 25: return 1;
+    case 13: return 2;
+    case 15: return 3;
+    }
+    return -1;
+}
+
+static int8_t host_int_ssi(uint32_t interrupt)
+{
+    int8_t m;
+    for (m = 0; m < 4; ++m)
+        if (g_host_ssi_int[m] == interrupt) return m;
+    return -1;
+}
+
+// Busy polls that bytes take on the SSI
+static uint32_t host_ssi_polls(uint32_t bytes)
+{
+    return g_host.poll_cycles ?
+        (uint32_t)((uint64_t)bytes * 8 * HOST_SYSCLK / g_host.ssi_hz / g_host.poll_cycles) : 0;
+}
+
+static void host_ssi_byte(uint8_t m, uint8_t b)
+{
+    HostPanel *p = &g_host_panel[m][0];
+    g_host.bytes++;
+    g_host.bit_times += 8;
+    g_host_ssi[m].in_flight++;
+    if (g_host_ssi[m].dc) host_panel_data(p, b);
+    else host_panel_command(p, b);
+}
+
+void SSIDataPut(uint32_t ui32Base, uint32_t ui32Data)
+{
+    uint8_t m = SSI_MODULE(ui32Base);
+    host_ssi_byte(m, (uint8_t)ui32Data);
+    g_host_ssi[m].busy += host_ssi_polls(1);
+}
+
+bool SSIBusy(uint32_t ui32Base)
+{
+    uint8_t m = SSI_MODULE(ui32Base);
+    g_host.polls++;
+    if (g_host_ssi[m].busy) {
+        g_host_ssi[m].busy--;
+        return true;
+    }
+    g_host_ssi[m].in_flight = 0;
+    return false;
+}
+
+void SSIDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    (void)ui32Base;
+    (void)ui32DMAFlags;
+}
+
+// The TM4C123 has no status bit for uDMA completion
+uint32_t SSIIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    (void)ui32Base;
+    (void)bMasked;
+    return 0;
+}
+
+void SSIIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    (void)ui32Base;
+    (void)ui32IntFlags;
+}
+
+// Registers the handler and enables it in the NVIC, as the driverlib call does
+void SSIIntRegister(uint32_t ui32Base, void (*pfnHandler)(void))
+{
+    g_host_ssi[SSI_MODULE(ui32Base)].handler = pfnHandler;
+    g_host_ssi[SSI_MODULE(ui32Base)].int_enabled = true;
+}
+
+void IntEnable(uint32_t ui32Interrupt)
+{
+    int8_t m = host_int_ssi(ui32Interrupt);
+    if (m < 0) return;
+    g_host_ssi[m].int_enabled = true;
+    host_deliver();
+}
+
+void IntDisable(uint32_t ui32Interrupt)
+{
+    int8_t m = host_int_ssi(ui32Interrupt);
+    if (m >= 0) g_host_ssi[m].int_enabled = false;
+}
+
+void IntPendClear(uint32_t ui32Interrupt)
+{
+    int8_t m = host_int_ssi(ui32Interrupt);
+    if (m >= 0) g_host_ssi[m].int_pending = false;
+}
+
+void GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    (void)ui32Port;
+    (void)ui8Pins;
+}
+
+void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    uint8_t m;
+    for (m = 0; m < 4; ++m) {
+        bool dc = ui8Val & g_host_ssi[m].dc_pin;
+        if (g_host_ssi[m].dc_port != ui32Port || !(ui8Pins & g_host_ssi[m].dc_pin)) continue;
+        if (dc != g_host_ssi[m].dc && g_host_ssi[m].in_flight) g_host.dc_glitches++;
+        g_host_ssi[m].dc = dc;
+    }
+}
+
+void *uDMAControlBaseGet(void)
+{
+    return g_host_dma_table;
+}
+
+// The controller ignores the low 10 bits of the table address
+void uDMAControlBaseSet(void *pControlTable)
+{
+    if ((uintptr_t)pControlTable & 1023) g_host.dma_errors++;
+    g_host_dma_table = pControlTable;
+}
+
+void uDMAEnable(void)
+{
+}
+
+void uDMAChannelAssign(uint32_t ui32Mapping)
+{
+    (void)ui32Mapping;
+}
+
+void uDMAChannelAttributeDisable(uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+    (void)ui32ChannelNum;
+    (void)ui32Attr;
+}
+
+void uDMAChannelControlSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Control)
+{
+    g_host_dma[ui32ChannelStructIndex & 0x1F].control = ui32Control;
+}
+
+void uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Mode,
+                            void *pvSrcAddr, void *pvDstAddr, uint32_t ui32TransferSize)
+{
+    uint8_t ch = ui32ChannelStructIndex & 0x1F;
+    int8_t m = host_dma_ssi(ch);
+    if (m < 0 || !g_host_dma_table || ui32Mode != UDMA_MODE_BASIC
+        || ui32TransferSize < 1 || ui32TransferSize > 1024
+        || (uintptr_t)pvDstAddr != g_host_ssi_base[m] + SSI_O_DR
+        || (g_host_dma[ch].control & UDMA_DST_INC_NONE) != UDMA_DST_INC_NONE) {
+        g_host.dma_errors++;
+        g_host_dma[ch].len = 0;
+        return;
+    }
+    g_host_dma[ch].mode = ui32Mode;
+    g_host_dma[ch].src = pvSrcAddr;
+    g_host_dma[ch].len = ui32TransferSize;
+}
+
+// The transfer goes into the SSI at once, leaving its last FIFO's worth to
+// drain, and raises the SSI interrupt
+void uDMAChannelEnable(uint32_t ui32ChannelNum)
+{
+    uint8_t ch = ui32ChannelNum & 0x1F;
+    int8_t m = host_dma_ssi(ch);
+    uint32_t i, len = g_host_dma[ch].len;
+
+    if (m < 0 || !len) {
+        g_host.dma_errors++;
+        return;
+    }
+    for (i = 0; i < len; ++i) host_ssi_byte(m, g_host_dma[ch].src[i]);
+    g_host_dma[ch].busy = host_ssi_polls(len);
+    g_host_ssi[m].busy += host_ssi_polls(len < 8 ? len : 8);
+    g_host_dma[ch].mode = UDMA_MODE_STOP;
+    g_host_dma[ch].len = 0;
+    g_host_ssi[m].int_pending = true;
+    host_deliver();
+}
+
+bool uDMAChannelIsEnabled(uint32_t ui32ChannelNum)
+{
+    uint8_t ch = ui32ChannelNum & 0x1F;
+    g_host.polls++;
+    if (!g_host_dma[ch].busy) return false;
+    g_host_dma[ch].busy--;
+    return true;
+}
+
+uint32_t uDMAChannelModeGet(uint32_t ui32ChannelStructIndex)
+{
+    return g_host_dma[ui32ChannelStructIndex & 0x1F].mode;
+}
+#endif
+
+// --- Interrupts ---
+// Takes one pending interrupt whatever the mask; false if none is pending
+static bool host_step(void)
+{
+    void (*handler)(void) = NULL;
+    bool in_isr;
+    uint8_t m;
+
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+    for (m = 0; m < 4 && !handler; ++m)
+        if (g_host_i2c[m].int_pending && g_host_i2c[m].int_enabled) handler = g_host_i2c[m].handler;
+#else
+    for (m = 0; m < 4 && !handler; ++m) {
+        if (g_host_ssi[m].int_pending && g_host_ssi[m].int_enabled && g_host_ssi[m].handler) {
+            // the NVIC clears the pending bit on entry
+            g_host_ssi[m].int_pending = false;
+            handler = g_host_ssi[m].handler;
+        }
+    }
+#endif
+    if (!handler) return false;
+    in_isr = g_host.in_isr;
+    g_host.in_isr = true;
+    handler();
+    g_host.in_isr = in_isr;
+    return true;
+}
+
+// Takes pending interrupts until there are none; returns how many
+static uint32_t host_run(void)
+{
+    uint32_t n = 0;
+    while (host_step()) ++n;
+    return n;
+}
+
+// What the NVIC would do now: nothing inside a handler or while masked
+static void host_deliver(void)
+{
+    if (!g_host.hold && !g_host.in_isr && !g_host.masked) host_run();
+}
+
+bool IntMasterDisable(void)
+{
+    bool was = g_host.masked;
+    g_host.masked = true;
+    return was;
+}
+
+bool IntMasterEnable(void)
+{
+    bool was = g_host.masked;
+    g_host.masked = false;
+    host_deliver();
+    return was;
+}
+
+// --- Registers ---
+static volatile uint32_t *host_reg(uint32_t addr)
+{
+    static uint32_t other;
+    if (addr == DWT_CYCCNT) {
+        g_host.cyccnt = (uint32_t)host_now();
+        return &g_host.cyccnt;
+    }
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+    if (addr >= I2C0_BASE && addr <= I2C3_BASE + I2C_O_MTPR && (addr & 0xFFF) == I2C_O_MTPR)
+        return &g_host_i2c[I2C_BUS(addr)].mtpr;
+#endif
+    return &other;
+}
+
+// Bus, panels and counters as after reset; interrupts unmasked
+static void host_reset(void)
+{
+    uint8_t i;
+    memset(&g_host, 0, sizeof(g_host));
+    for (i = 0; i < 8; ++i) host_panel_reset(&g_host_panel[i / 2][i % 2]);
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+    memset(g_host_i2c, 0, sizeof(g_host_i2c));
+    for (i = 0; i < 4; ++i) g_host_i2c[i].mtpr = 9;     // 400 kHz
+#else
+    memset(g_host_ssi, 0, sizeof(g_host_ssi));
+    memset(g_host_dma, 0, sizeof(g_host_dma));
+    g_host_dma_table = NULL;
+    g_host_ssi[0].dc_port = GPIO_PORTA_BASE;
+    g_host_ssi[0].dc_pin = GPIO_PIN_6;
+#endif
+    g_host.ssi_hz = 10000000;
+}
+
+// The panel host_init_device() connects
+#define HOST_PANEL (&g_host_panel[0][0])
+
+// dev on I2C0 at SSD1306_I2C_ADDR, or on SSI0 with D/C on PA6
+static void host_init_device(SSD1306_Device *dev, uint8_t width, uint8_t height,
+                             uint8_t *framebuf, uint8_t *backbuf)
+{
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+    SSD1306_InitDevice(dev, I2C0_BASE, SSD1306_I2C_ADDR, width, height, framebuf, backbuf);
+#else
+    SSD1306_InitDevice(dev, SSI0_BASE, GPIO_PORTA_BASE, GPIO_PIN_6, width, height, framebuf, backbuf);
+#endif
+}
+
+// The same with a 64-row framebuffer showing `rows` of the display RAM ring
+static inline void host_init_ring(SSD1306_Device *dev, uint8_t width, uint8_t rows,
+                                  uint8_t *framebuf, uint8_t *backbuf)
+{
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+    SSD1306_InitDeviceRing(dev, I2C0_BASE, SSD1306_I2C_ADDR, width, rows, framebuf, backbuf);
+#else
+    SSD1306_InitDeviceRing(dev, SSI0_BASE, GPIO_PORTA_BASE, GPIO_PIN_6, width, rows, framebuf, backbuf);
+#endif
+}
+
+#endif // SSD1306_HOST_H
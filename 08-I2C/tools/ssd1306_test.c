@@ -0,0 +1,1586 @@
+// ssd1306_test.c - Host tests for the SSD1306 driver.
+//
+// Runs the driver against the model bus and panel of ssd1306_host.h and
+// checks what it draws pixel for pixel against plain references, on random
+// backgrounds and at positions clipped by every edge:
+//
+//   fills    FillRect, DrawHLine, DrawVLine and DrawRect against the same
+//            shapes drawn with DrawPixel.
+//   glyphs   WriteChar in every font, page-aligned or not, against the glyph
+//            columns drawn bit by bit with DrawPixel; the cursor must advance
+//            and wrap as before.
+//   rotation DrawPixel at 90 and 270 degrees against the documented mapping
+//            to the framebuffer; fills, WriteChar, DrawBitmap and
+//            BlitBitmap in every raster op, turned 90, 180 and 270 degrees,
+//            against DrawPixel; and after a flush, every turn as seen on the
+//            model panel's glass, 180 degrees done by its remap.
+//   shapes   FillCircle and FillRoundRect against every column between the
+//            top and bottom of the DrawCircle/DrawRoundRect outline,
+//            FillTriangle against the span between its edges in each column,
+//            FillArc against the ring and an atan2() angle test per pixel.
+//   numbers  FormatFixed and WriteInt against snprintf() of the value as a
+//            64-bit integer, at 0 to 9 decimals: the edges of the int32 range,
+//            every value in [-100000, 100000] and a strided sweep of the rest
+//            (every value with --full, which takes minutes). WriteFloat with
+//            values whose decimal text is exact, up to 2^64 and past the
+//            int32 range once scaled, and with infinities and NaN.
+//   widgets  labels, numbers and a bar set to random values, hidden and shown:
+//            each partial ScreenRender() must leave the framebuffer a full
+//            render would, numbers too wide for their widget included, with
+//            the text cursor untouched; a counter step must dirty only the
+//            cells whose digits changed.
+//   terminal random text with newlines and carriage returns written to the
+//            terminal on 64- and 32-row panels in each font, flushed in
+//            random chunks: the model panel's glass must show the last
+//            lines of a reference terminal, wrapped at the right edge and
+//            scrolled through the start-line ring, and TermInit() must
+//            clear it.
+//   flushes  frames of random shapes and text sent with Display(),
+//            DisplayAsync(), delta flushes and double buffering: the model
+//            panel's display RAM must then hold the frame, with no data
+//            sent while scrolling, no D/C glitches and no uDMA errors.
+//   scroll   ScrollUp() by random line counts on 64- and 32-row rings against
+//            the start-line arithmetic: the returned row, exactly the rows
+//            that come into view cleared and dirty, and the start line on
+//            the model panel after the flush; refused where not possible.
+//            Horizontal and diagonal scrolls against the command bytes of
+//            the datasheet, as the panel receives them.
+//   commands (I2C) queued display commands: repeats of a kind coalesce,
+//            nothing is sent before the flush, and the flush carries them
+//            without extra transactions (counted as STARTs on the model
+//            bus) except a trailing start line or scroll start; rotation
+//            and a scroll stop lead a full rewrite, which is never written
+//            while the panel scrolls.
+//   recovery (I2C) a random byte of a frame carrying queued commands and a
+//            new start line NACKed, with Display() and DisplayAsync(): the
+//            whole screen must be dirty again, and the next flush must send
+//            what Invalidate() and the same commands would, leaving the
+//            panel with the frame, the start line and the latest commands.
+//   shared   (I2C) panels at 0x3C and 0x3D on one module flushing
+//            asynchronously, one byte of the pair NACKed: the other panel's
+//            frame must arrive whole, the next flushes must repair the
+//            failed one, and no command may be issued with the last one's
+//            interrupt still pending.
+//   speed    (I2C) SetBusSpeed's timer period against the rounded-up
+//            reference at several system clocks, and ProbeBusSpeed against
+//            model panels that follow SCL up to a given rate: it must return
+//            the rate achieved, leave the bus there and the frame on the
+//            panel, and stop stepping once the rate no longer rises.
+//
+// The framebuffer must match the reference exactly and the dirty spans must
+// cover every pixel the reference touched. Prints the first failures and
+// exits with status 1 if there are any.
+//
+// Build from this directory against the TivaWare headers, for example:
+//
+//   gcc -O2 -I$TIVAWARE -o ssd1306_test ssd1306_test.c -lm && ./ssd1306_test
+//
+// That tests the I2C transport; add -DSSD1306_TRANSPORT=1 for SPI over SSI
+// and uDMA.
+
+#include "ssd1306_host.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+static uint32_t g_checks, g_failures;
+
+static bool check(bool ok, const char *fmt, ...)
+{
+    va_list args;
+    ++g_checks;
+    if (!ok && g_failures++ < 20) {
+        va_start(args, fmt);
+        printf("FAIL: ");
+        vprintf(fmt, args);
+        printf("\n");
+        va_end(args);
+    }
+    return ok;
+}
+
+// xorshift32: the same sequence on every host
+static uint32_t g_seed = 2463534242u;
+
+static uint32_t rnd(uint32_t n)
+{
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 17;
+    g_seed ^= g_seed << 5;
+    return g_seed % n;
+}
+
+static int16_t rnd_range(int16_t lo, int16_t hi)
+{
+    return lo + (int16_t)rnd(hi - lo + 1);
+}
+
+// --- Devices ---
+static SSD1306_Device g_dev_test;
+static uint8_t g_fb[2][SSD1306_BUFFER_BYTES(64)];
+
+// Panel geometries the drawing tests run on
+static const uint8_t g_geometry[][2] = { { 128, 64 }, { 128, 32 }, { 96, 16 }, { 64, 48 } };
+#define GEOMETRIES (sizeof(g_geometry) / sizeof(g_geometry[0]))
+
+static void device_open(uint8_t width, uint8_t height)
+{
+    host_reset();
+    host_init_device(&g_dev_test, width, height, g_fb[0], g_fb[1]);
+}
+
+// --- Snapshots of the framebuffer and dirty spans ---
+typedef struct {
+    uint8_t fb[SSD1306_BUFFER_BYTES(64)];
+    uint8_t x0[SSD1306_MAX_PAGES];
+    uint8_t x1[SSD1306_MAX_PAGES];
+} Snapshot;
+
+static void snap(Snapshot *s)
+{
+    memcpy(s->fb, g_dev->buffer, SSD1306_BUFFER_BYTES(g_dev->height));
+    memcpy(s->x0, g_dev->dirty_x0, sizeof(s->x0));
+    memcpy(s->x1, g_dev->dirty_x1, sizeof(s->x1));
+}
+
+static void restore(const Snapshot *s)
+{
+    memcpy(g_dev->buffer, s->fb, SSD1306_BUFFER_BYTES(g_dev->height));
+    memcpy(g_dev->dirty_x0, s->x0, sizeof(s->x0));
+    memcpy(g_dev->dirty_x1, s->x1, sizeof(s->x1));
+}
+
+// Random framebuffer content with nothing dirty
+static void background(Snapshot *s)
+{
+    uint16_t i;
+    for (i = 0; i < SSD1306_BUFFER_BYTES(g_dev->height); ++i) g_dev->buffer[i] = (uint8_t)rnd(256);
+    dirty_clear(g_dev);
+    snap(s);
+}
+
+// The drawn framebuffer equals the reference and its dirty spans cover the
+// reference's; reports the first differing pixel
+static bool same(const Snapshot *got, const Snapshot *ref, const char *what)
+{
+    uint8_t p;
+    uint16_t i, n = SSD1306_BUFFER_BYTES(g_dev->height);
+    for (i = 0; i < n; ++i) {
+        if (got->fb[i] != ref->fb[i]) {
+            uint8_t bit = 0;
+            while (!((got->fb[i] ^ ref->fb[i]) >> bit & 1)) ++bit;
+            return check(false, "%s: pixel (%u, %u) on a %ux%u panel", what,
+                         (unsigned)(i % SSD1306_STRIDE), (unsigned)(i / SSD1306_STRIDE * 8 + bit),
+                         (unsigned)g_dev->width, (unsigned)g_dev->height);
+        }
+    }
+    for (p = 0; p < g_dev->pages; ++p) {
+        if (ref->x0[p] <= ref->x1[p] && (got->x0[p] > ref->x0[p] || got->x1[p] < ref->x1[p]))
+            return check(false, "%s: page %u dirty %u..%u, drawn %u..%u", what, (unsigned)p,
+                         (unsigned)got->x0[p], (unsigned)got->x1[p],
+                         (unsigned)ref->x0[p], (unsigned)ref->x1[p]);
+    }
+    return check(true, "");
+}
+
+// --- Fills ---
+static void pixel_rect(int16_t x, int16_t y, int16_t w, int16_t h, bool color)
+{
+    int16_t i, j;
+    for (i = x; i < x + w; ++i)
+        for (j = y; j < y + h; ++j) SSD1306_DrawPixel(i, j, color);
+}
+
+static void pixel_frame(int16_t x, int16_t y, int16_t w, int16_t h, bool color)
+{
+    if (w <= 0 || h <= 0) return;
+    pixel_rect(x, y, w, 1, color);
+    pixel_rect(x, y + h - 1, w, 1, color);
+    pixel_rect(x, y, 1, h, color);
+    pixel_rect(x + w - 1, y, 1, h, color);
+}
+
+static void test_fills(void)
+{
+    Snapshot bg, got, ref;
+    char what[64];
+    uint8_t g;
+    uint16_t i;
+
+    for (g = 0; g < GEOMETRIES; ++g) {
+        device_open(g_geometry[g][0], g_geometry[g][1]);
+        for (i = 0; i < 4000; ++i) {
+            int16_t x = rnd_range(-20, SSD1306_Width() + 4), y = rnd_range(-20, SSD1306_Height() + 4);
+            int16_t w = rnd_range(-4, SSD1306_Width() + 24), h = rnd_range(-4, SSD1306_Height() + 24);
+            bool color = rnd(2);
+            uint8_t shape = i % 4;
+
+            background(&bg);
+            switch (shape) {
+            case 0: SSD1306_FillRect(x, y, w, h, color); break;
+            case 1: SSD1306_DrawHLine(x, y, w, color); break;
+            case 2: SSD1306_DrawVLine(x, y, h, color); break;
+            default: SSD1306_DrawRect(x, y, w, h, color); break;
+            }
+            snap(&got);
+            restore(&bg);
+            switch (shape) {
+            case 0: pixel_rect(x, y, w, h, color); break;
+            case 1: pixel_rect(x, y, w, 1, color); break;
+            case 2: pixel_rect(x, y, 1, h, color); break;
+            default: pixel_frame(x, y, w, h, color); break;
+            }
+            snap(&ref);
+            snprintf(what, sizeof(what), "%s(%d, %d, %d, %d, %d)",
+                     (const char *[]){ "FillRect", "DrawHLine", "DrawVLine", "DrawRect" }[shape],
+                     x, y, w, h, color);
+            if (!same(&got, &ref, what)) break;
+        }
+    }
+}
+
+static bool fb_pixel(const Snapshot *s, int16_t x, int16_t y)
+{
+    return s->fb[(y / 8) * SSD1306_STRIDE + x] >> (y & 7) & 1;
+}
+
+// --- Filled shapes ---
+// g_circle_ext[r][dx]: how far DrawCircle(r) reaches above and below the
+// centre in the column dx away from it
+static uint8_t g_circle_ext[64][64];
+
+static void circle_extents(void)
+{
+    Snapshot s;
+    int16_t r, dx, y;
+
+    device_open(128, 64);
+    for (r = 0; r < 64; ++r) {
+        buffer_clear(g_dev);
+        SSD1306_DrawCircle(64, 63, r, true);
+        snap(&s);
+        for (dx = 0; dx <= r; ++dx)
+            for (y = 0; y < 64; ++y)
+                if (fb_pixel(&s, 64 + dx, y)) { g_circle_ext[r][dx] = 63 - y; break; }
+    }
+}
+
+static void pixel_circle(int16_t x0, int16_t y0, int16_t r, bool color)
+{
+    int16_t dx;
+    for (dx = -r; dx <= r; ++dx) {
+        int16_t e = g_circle_ext[r][dx < 0 ? -dx : dx];
+        pixel_rect(x0 + dx, y0 - e, 1, 2 * e + 1, color);
+    }
+}
+
+// Radius clamped as DrawRoundRect does; corner columns reach as far as the
+// quarter circles, the columns between them span the full height
+static void pixel_round_rect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, bool color)
+{
+    int16_t i, max_r = (w < h ? w : h) / 2;
+    if (w <= 0 || h <= 0) return;
+    if (r > max_r) r = max_r;
+    if (r < 0) r = 0;
+    for (i = 0; i < w; ++i) {
+        int16_t dx = i < r ? r - i : (i > w - r - 1 ? i - (w - r - 1) : 0);
+        int16_t e = g_circle_ext[r][dx];
+        pixel_rect(x + i, y + r - e, 1, h - 2 * r + 2 * e, color);
+    }
+}
+
+// Each column spans the edges that cross it, an edge's row taken from its
+// left end and rounded toward it; vertical edges count with both ends
+static void pixel_triangle(const int16_t *px, const int16_t *py, bool color)
+{
+    int16_t x, lo, hi, xmin = px[0], xmax = px[0];
+    uint8_t k;
+
+    for (k = 1; k < 3; ++k) {
+        if (px[k] < xmin) xmin = px[k];
+        if (px[k] > xmax) xmax = px[k];
+    }
+    for (x = xmin; x <= xmax; ++x) {
+        lo = INT16_MAX;
+        hi = INT16_MIN;
+        for (k = 0; k < 3; ++k) {
+            uint8_t a = k, b = (k + 1) % 3;
+            int16_t ya, yb;
+            if (px[a] > px[b]) { a = b; b = k; }
+            if (x < px[a] || x > px[b]) continue;
+            if (px[a] == px[b]) {
+                ya = py[a];
+                yb = py[b];
+            } else {
+                ya = yb = py[a] + (int32_t)(py[b] - py[a]) * (x - px[a]) / (px[b] - px[a]);
+            }
+            if (ya > yb) { int16_t t = ya; ya = yb; yb = t; }
+            if (ya < lo) lo = ya;
+            if (yb > hi) hi = yb;
+        }
+        pixel_rect(x, lo, 1, hi - lo + 1, color);
+    }
+}
+
+// Ring by distance as FillArc documents it, sector by atan2(). The driver's
+// sine table is exact to far less than a pixel but not to the last bit, so
+// on-screen pixels within 0.002 degrees of either end are left out and
+// listed in g_loose for arc_loose() to take from the driver's result.
+static int16_t g_loose[64][2];
+static uint8_t g_loose_n;
+
+static void pixel_arc(int16_t x0, int16_t y0, int16_t r_outer, int16_t r_inner, int16_t start,
+                      int16_t end, bool color)
+{
+    int32_t out2 = (int32_t)r_outer * r_outer + r_outer, in2 = (int32_t)r_inner * r_inner - r_inner;
+    int16_t sweep = ((end - start) % 360 + 360) % 360;
+    bool full = end != start && sweep == 0;
+    int16_t dx, dy;
+
+    g_loose_n = 0;
+    if (end == start) return;
+    for (dx = -r_outer; dx <= r_outer; ++dx) {
+        for (dy = -r_outer; dy <= r_outer; ++dy) {
+            int32_t d2 = (int32_t)dx * dx + (int32_t)dy * dy;
+            int16_t x = x0 + dx, y = y0 + dy;
+            double rel;
+            if (d2 > out2 || (r_inner >= 1 && d2 <= in2)) continue;
+            if (full || (dx == 0 && dy == 0)) {
+                SSD1306_DrawPixel(x, y, color);
+                continue;
+            }
+            rel = fmod(fmod(atan2(dy, dx) * 180.0 / M_PI - start, 360.0) + 360.0, 360.0);
+            if (fabs(rel) < 0.002 || fabs(rel - sweep) < 0.002 || fabs(rel - 360.0) < 0.002) {
+                if (x < 0 || x >= SSD1306_Width() || y < 0 || y >= SSD1306_Height()) continue;
+                if (g_loose_n < 64) {
+                    g_loose[g_loose_n][0] = x;
+                    g_loose[g_loose_n++][1] = y;
+                } else {
+                    check(false, "FillArc: more than 64 pixels on the ends");
+                }
+            } else if (rel <= sweep) {
+                SSD1306_DrawPixel(x, y, color);
+            }
+        }
+    }
+}
+
+static void arc_loose(Snapshot *ref, const Snapshot *got)
+{
+    uint8_t i;
+    for (i = 0; i < g_loose_n; ++i) {
+        int16_t x = g_loose[i][0], y = g_loose[i][1];
+        uint16_t k = (y / 8) * SSD1306_STRIDE + x;
+        ref->fb[k] = (ref->fb[k] & ~(1u << (y & 7))) | (got->fb[k] & (1u << (y & 7)));
+    }
+}
+
+static void test_shapes(void)
+{
+    Snapshot bg, got, ref;
+    char what[80];
+    uint8_t g, q;
+    uint16_t i;
+
+    circle_extents();
+    for (g = 0; g < GEOMETRIES; ++g) {
+        device_open(g_geometry[g][0], g_geometry[g][1]);
+        for (i = 0; i < 2000; ++i) {
+            int16_t x = rnd_range(-30, SSD1306_Width() + 30), y = rnd_range(-30, SSD1306_Height() + 30);
+            int16_t r = rnd_range(-2, 63);
+            bool color = rnd(2);
+
+            background(&bg);
+            switch (i % 4) {
+            case 0:
+                SSD1306_FillCircle(x, y, r, color);
+                snap(&got);
+                restore(&bg);
+                if (r >= 0) pixel_circle(x, y, r, color);
+                snprintf(what, sizeof(what), "FillCircle(%d, %d, %d, %d)", x, y, r, color);
+                break;
+            case 1: {
+                int16_t w = rnd_range(-2, 127), h = rnd_range(-2, SSD1306_Height() + 24);
+                SSD1306_FillRoundRect(x, y, w, h, r, color);
+                snap(&got);
+                restore(&bg);
+                pixel_round_rect(x, y, w, h, r, color);
+                snprintf(what, sizeof(what), "FillRoundRect(%d, %d, %d, %d, %d, %d)", x, y, w, h, r, color);
+                break;
+            }
+            case 2: {
+                int16_t px[3], py[3];
+                uint8_t k;
+                for (k = 0; k < 3; ++k) {
+                    px[k] = rnd_range(-40, SSD1306_Width() + 40);
+                    py[k] = rnd_range(-40, SSD1306_Height() + 40);
+                }
+                // collinear and repeated corners too
+                if (i % 32 == 2) { px[2] = px[0]; py[2] = py[1]; }
+                if (i % 32 == 6) { px[1] = px[0]; py[1] = py[0]; }
+                SSD1306_FillTriangle(px[0], py[0], px[1], py[1], px[2], py[2], color);
+                snap(&got);
+                restore(&bg);
+                pixel_triangle(px, py, color);
+                snprintf(what, sizeof(what), "FillTriangle(%d, %d, %d, %d, %d, %d, %d)",
+                         px[0], py[0], px[1], py[1], px[2], py[2], color);
+                break;
+            }
+            default: {
+                int16_t inner = rnd_range(-2, r + 2), start = rnd_range(-400, 400);
+                int16_t end = start + ((i % 16 == 3) ? 0 : (i % 16 == 7) ? 360 : rnd_range(-420, 420));
+                SSD1306_FillArc(x, y, r, inner, start, end, color);
+                snap(&got);
+                restore(&bg);
+                pixel_arc(x, y, r, inner, start, end, color);
+                snprintf(what, sizeof(what), "FillArc(%d, %d, %d, %d, %d, %d, %d)", x, y, r, inner,
+                         start, end, color);
+                break;
+            }
+            }
+            snap(&ref);
+            if (i % 4 == 3) arc_loose(&ref, &got);
+            if (!same(&got, &ref, what)) break;
+        }
+    }
+
+    // four quarters make the full ring
+    device_open(128, 64);
+    for (i = 0; i < 200; ++i) {
+        int16_t x = rnd_range(-10, 138), y = rnd_range(-10, 74), r = rnd_range(0, 40);
+        int16_t inner = rnd_range(0, r), start = rnd_range(-360, 360);
+
+        background(&bg);
+        SSD1306_FillArc(x, y, r, inner, start, start + 360, true);
+        snap(&ref);
+        restore(&bg);
+        for (q = 0; q < 4; ++q) SSD1306_FillArc(x, y, r, inner, start + 90 * q, start + 90 * (q + 1), true);
+        snap(&got);
+        snprintf(what, sizeof(what), "FillArc(%d, %d, %d, %d) in quarters from %d", x, y, r, inner, start);
+        same(&got, &ref, what);
+    }
+}
+
+// --- Glyphs ---
+static const FontDef *const g_fonts[] = { &Font6x8, &Font8x12_bold, &Font12x16 };
+#define FONTS (sizeof(g_fonts) / sizeof(g_fonts[0]))
+
+// Every pixel of the glyph box, set or cleared, as WriteChar drew it before
+// the blitter
+static void pixel_glyph(int16_t x, int16_t y, const FontDef *font, char c)
+{
+    const uint8_t *data = font_glyph(font, c);
+    uint8_t col, row, per_col = (font->height + 7) / 8;
+    if (!data) data = font_glyph(font, '?');
+    if (!data) return;
+    for (col = 0; col < font->width; ++col)
+        for (row = 0; row < font->height; ++row)
+            SSD1306_DrawPixel(x + col, y + row, (data[col * per_col + row / 8] >> (row & 7)) & 1);
+}
+
+static void test_glyphs(void)
+{
+    Snapshot bg, got, ref;
+    char what[64];
+    uint8_t g, f;
+    uint16_t i;
+
+    for (g = 0; g < GEOMETRIES; ++g) {
+        device_open(g_geometry[g][0], g_geometry[g][1]);
+        for (i = 0; i < 3000; ++i) {
+            const FontDef *font = g_fonts[i % FONTS];
+            int16_t x = rnd_range(-font->width, SSD1306_Width());
+            int16_t y = rnd_range(-font->height, SSD1306_Height());
+            // printable, plus codes outside the fonts that fall back to '?'
+            char c = (i % 16) ? (char)rnd_range(32, 126) : (char)rnd(256);
+            int16_t cx = x + font->width + 1, cy = y;
+
+            if (cx + font->width >= SSD1306_Width()) { cx = 0; cy = y + font->height + 1; }
+            background(&bg);
+            ssd1306_SetFont(font);
+            SSD1306_SetCursor(x, y);
+            SSD1306_WriteChar(c);
+            snap(&got);
+            snprintf(what, sizeof(what), "WriteChar(0x%02X) %ux%u at (%d, %d)", (unsigned)(uint8_t)c,
+                     (unsigned)font->width, (unsigned)font->height, x, y);
+            check(g_dev->cursor_x == cx && g_dev->cursor_y == cy, "%s: cursor (%d, %d), not (%d, %d)",
+                  what, g_dev->cursor_x, g_dev->cursor_y, cx, cy);
+            restore(&bg);
+            pixel_glyph(x, y, font, c);
+            snap(&ref);
+            if (!same(&got, &ref, what)) break;
+        }
+    }
+
+    // whole strings wrap the same way
+    device_open(128, 64);
+    for (f = 0; f < FONTS; ++f) {
+        const char *text = "The quick brown fox jumps over the lazy dog 0123456789";
+        const char *s;
+        int16_t x = 3, y = 2;
+
+        background(&bg);
+        ssd1306_SetFont(g_fonts[f]);
+        SSD1306_SetCursor(x, y);
+        SSD1306_WriteString(text);
+        snap(&got);
+        restore(&bg);
+        for (s = text; *s; ++s) {
+            pixel_glyph(x, y, g_fonts[f], *s);
+            x += g_fonts[f]->width + 1;
+            if (x + g_fonts[f]->width >= 128) { x = 0; y += g_fonts[f]->height + 1; }
+        }
+        snap(&ref);
+        snprintf(what, sizeof(what), "WriteString in %ux%u", (unsigned)g_fonts[f]->width,
+                 (unsigned)g_fonts[f]->height);
+        same(&got, &ref, what);
+    }
+}
+
+// --- Rotation ---
+// Logical pixel (x, y) in the framebuffer: 90 degrees puts it at (y,
+// height - 1 - x), 270 at (width - 1 - y, x)
+static void rotated(int16_t *x, int16_t *y)
+{
+    int16_t t = *x;
+    if (g_dev->rotation == SSD1306_ROTATE_90) {
+        *x = *y;
+        *y = g_dev->height - 1 - t;
+    } else if (g_dev->rotation == SSD1306_ROTATE_270) {
+        *x = g_dev->width - 1 - *y;
+        *y = t;
+    }
+}
+
+static bool logical_pixel(int16_t x, int16_t y)
+{
+    rotated(&x, &y);
+    return g_dev->buffer[(y / 8) * SSD1306_STRIDE + x] >> (y & 7) & 1;
+}
+
+// Bitmap blits pixel by pixel; source bits as documented for DrawBitmap
+static void pixel_blit(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h,
+                       SSD1306_RasterOp rop, bool invert)
+{
+    int16_t c, r;
+    for (c = 0; c < w; ++c) {
+        for (r = 0; r < h; ++r) {
+            bool bit = (bitmap[(r / 8) * w + c] >> (r & 7) & 1) ^ invert;
+            bool on = x + c >= 0 && x + c < SSD1306_Width() && y + r >= 0 && y + r < SSD1306_Height();
+            if (rop == SSD1306_ROP_COPY) SSD1306_DrawPixel(x + c, y + r, bit);
+            else if (!bit) continue;
+            else if (rop == SSD1306_ROP_OR) SSD1306_DrawPixel(x + c, y + r, true);
+            else if (rop == SSD1306_ROP_ANDNOT) SSD1306_DrawPixel(x + c, y + r, false);
+            else if (on) SSD1306_DrawPixel(x + c, y + r, !logical_pixel(x + c, y + r));
+        }
+    }
+}
+
+static void test_rotation(void)
+{
+    static const char *const rop_name[] = { "COPY", "OR", "ANDNOT", "XOR" };
+    static const uint8_t turns[] = { SSD1306_ROTATE_90, SSD1306_ROTATE_180, SSD1306_ROTATE_270 };
+    static uint8_t bitmap[64 * 8];
+    static bool image[128][128];
+    Snapshot bg, got, ref;
+    char what[80];
+    uint8_t g, t, turn;
+    int16_t x, y;
+    uint16_t i;
+
+    for (i = 0; i < sizeof(bitmap); ++i) bitmap[i] = (uint8_t)rnd(256);
+    for (g = 0; g < GEOMETRIES; ++g) {
+        device_open(g_geometry[g][0], g_geometry[g][1]);
+        for (t = 0; t < sizeof(turns); ++t) {
+            turn = turns[t];
+            check(SSD1306_SetRotation(turn), "SetRotation(%u) on a %ux%u panel", (unsigned)turn,
+                  (unsigned)g_dev->width, (unsigned)g_dev->height);
+            check(SSD1306_Width() == ((turn & 1) ? g_dev->height : g_dev->width)
+                  && SSD1306_Height() == ((turn & 1) ? g_dev->width : g_dev->height),
+                  "%u degrees: view %dx%d of a %ux%u panel", 90u * turn, SSD1306_Width(),
+                  SSD1306_Height(), (unsigned)g_dev->width, (unsigned)g_dev->height);
+
+            // DrawPixel flips just the framebuffer bit of the mapping
+            for (x = 0; x < SSD1306_Width(); ++x) {
+                for (y = 0; y < SSD1306_Height(); ++y) {
+                    int16_t fx = x, fy = y;
+                    if ((x * 7 + y) % 5) continue;
+                    background(&bg);
+                    rotated(&fx, &fy);
+                    SSD1306_DrawPixel(x, y, !fb_pixel(&bg, fx, fy));
+                    snap(&got);
+                    ref = bg;
+                    ref.fb[(fy / 8) * SSD1306_STRIDE + fx] ^= 1 << (fy & 7);
+                    snprintf(what, sizeof(what), "DrawPixel(%d, %d) at %u degrees", x, y, 90u * turn);
+                    if (memcmp(got.fb, ref.fb, SSD1306_BUFFER_BYTES(g_dev->height))) {
+                        check(false, "%s: not framebuffer (%d, %d) alone", what, fx, fy);
+                        x = SSD1306_Width();
+                        break;
+                    }
+                }
+            }
+            check(true, "");
+
+            for (i = 0; i < 1500; ++i) {
+                const FontDef *font = g_fonts[i % FONTS];
+                int16_t w = rnd_range(-2, 70), h = rnd_range(-2, 40);
+                bool color = rnd(2);
+                SSD1306_RasterOp rop = (SSD1306_RasterOp)rnd(4);
+                uint8_t shape = i % 7;
+                char c = (char)rnd_range(32, 126);
+
+                x = rnd_range(-w - 8, SSD1306_Width() + 4);
+                y = rnd_range(-h - 8, SSD1306_Height() + 4);
+                if (shape == 6 && h > 40) h = 40;
+                background(&bg);
+                ssd1306_SetFont(font);
+                SSD1306_SetCursor(x, y);
+                switch (shape) {
+                case 0: SSD1306_FillRect(x, y, w, h, color); break;
+                case 1: SSD1306_DrawHLine(x, y, w, color); break;
+                case 2: SSD1306_DrawVLine(x, y, h, color); break;
+                case 3: SSD1306_DrawRect(x, y, w, h, color); break;
+                case 4: SSD1306_WriteChar(c); break;
+                case 5: SSD1306_DrawBitmap(x, y, bitmap, w, h, color); break;
+                default: SSD1306_BlitBitmap(x, y, bitmap, w, h, rop); break;
+                }
+                snap(&got);
+                restore(&bg);
+                switch (shape) {
+                case 0: pixel_rect(x, y, w, h, color); break;
+                case 1: pixel_rect(x, y, w, 1, color); break;
+                case 2: pixel_rect(x, y, 1, h, color); break;
+                case 3: pixel_frame(x, y, w, h, color); break;
+                case 4: pixel_glyph(x, y, font, c); break;
+                case 5: pixel_blit(x, y, bitmap, w, h, SSD1306_ROP_COPY, !color); break;
+                default: pixel_blit(x, y, bitmap, w, h, rop, false); break;
+                }
+                snap(&ref);
+                switch (shape) {
+                case 4:
+                    snprintf(what, sizeof(what), "WriteChar(0x%02X) %ux%u at (%d, %d)", (unsigned)(uint8_t)c,
+                             (unsigned)font->width, (unsigned)font->height, x, y);
+                    break;
+                case 5:
+                    snprintf(what, sizeof(what), "DrawBitmap(%d, %d, %d, %d, %d)", x, y, w, h, color);
+                    break;
+                case 6:
+                    snprintf(what, sizeof(what), "BlitBitmap(%d, %d, %d, %d, %s)", x, y, w, h, rop_name[rop]);
+                    break;
+                default:
+                    snprintf(what, sizeof(what), "%s(%d, %d, %d, %d, %d)",
+                             (const char *[]){ "FillRect", "DrawHLine", "DrawVLine", "DrawRect" }[shape],
+                             x, y, w, h, color);
+                    break;
+                }
+                snprintf(what + strlen(what), sizeof(what) - strlen(what), " at %u degrees", 90u * turn);
+                if (!same(&got, &ref, what)) break;
+            }
+        }
+    }
+
+    // What the glass shows after a flush, turning a full-width panel round
+    // and back without reopening it
+    for (g = 0; g < GEOMETRIES; ++g) {
+        if (g_geometry[g][0] != 128) continue;
+        device_open(g_geometry[g][0], g_geometry[g][1]);
+        for (t = 0; t < 5; ++t) {
+            int16_t vw, vh, gx, gy;
+            turn = t & 3;
+            SSD1306_SetRotation(turn);
+            vw = SSD1306_Width();
+            vh = SSD1306_Height();
+            for (x = 0; x < vw; ++x) {
+                for (y = 0; y < vh; ++y) {
+                    image[x][y] = rnd(2);
+                    SSD1306_DrawPixel(x, y, image[x][y]);
+                }
+            }
+            SSD1306_Display();
+            for (x = 0; x < vw; ++x) {
+                for (y = 0; y < vh; ++y) {
+                    switch (turn) {
+                    case SSD1306_ROTATE_0: gx = x; gy = y; break;
+                    case SSD1306_ROTATE_90: gx = y; gy = vw - 1 - x; break;
+                    case SSD1306_ROTATE_180: gx = vw - 1 - x; gy = vh - 1 - y; break;
+                    default: gx = vh - 1 - y; gy = x; break;
+                    }
+                    if (host_panel_pixel(HOST_PANEL, gx, gy) != image[x][y]) {
+                        check(false, "%u degrees on a %ux%u panel: glass (%d, %d) does not show (%d, %d)",
+                              90u * turn, (unsigned)g_dev->width, (unsigned)g_dev->height, gx, gy, x, y);
+                        x = vw;
+                        break;
+                    }
+                }
+            }
+            check(true, "");
+        }
+    }
+}
+
+// --- Numbers ---
+static const int64_t g_pow10_ref[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// value / 10^decimals with all digits, computed in 64 bits
+static void ref_fixed(char *buf, size_t size, int32_t value, uint8_t decimals)
+{
+    int64_t mag = value < 0 ? -(int64_t)value : value;
+    if (decimals == 0)
+        snprintf(buf, size, "%lld", (long long)value);
+    else
+        snprintf(buf, size, "%s%lld.%0*lld", value < 0 ? "-" : "", (long long)(mag / g_pow10_ref[decimals]),
+                 (int)decimals, (long long)(mag % g_pow10_ref[decimals]));
+}
+
+// False after the first mismatch, so a broken formatter reports once per
+// decimal count rather than for every value
+static bool check_fixed(int32_t value, uint8_t decimals)
+{
+    char got[16], ref[24];
+    uint8_t len = SSD1306_FormatFixed(got, value, decimals);
+    ref_fixed(ref, sizeof(ref), value, decimals);
+    if (len == strlen(ref) && !strcmp(got, ref)) return true;
+    return check(false, "FormatFixed(%ld, %u) = \"%s\" (%u), not \"%s\"", (long)value,
+                 (unsigned)decimals, got, (unsigned)len, ref);
+}
+
+// What Write*() draws equals WriteString() of the expected text
+static void check_drawn(void (*write)(void), const char *text, const char *what)
+{
+    Snapshot bg, got, ref;
+    background(&bg);
+    SSD1306_SetCursor(2, 3);
+    write();
+    snap(&got);
+    restore(&bg);
+    SSD1306_SetCursor(2, 3);
+    SSD1306_WriteString(text);
+    snap(&ref);
+    same(&got, &ref, what);
+}
+
+static int32_t g_write_int;
+static float g_write_float;
+static uint8_t g_write_decimals;
+static void write_int(void) { SSD1306_WriteInt(g_write_int); }
+static void write_float(void) { SSD1306_WriteFloat(g_write_float, g_write_decimals); }
+
+static void test_numbers(bool full)
+{
+    static const int32_t edges[] = {
+        0, 1, -1, 9, -9, 10, -10, 99, 100, 999999999, 1000000000, -999999999, -1000000000,
+        2147483647, -2147483647, (-2147483647 - 1), 16777217, -16777217
+    };
+    char text[40], what[64];
+    uint8_t d, i;
+    int64_t v;
+    bool ok;
+    float f;
+
+    for (d = 0; d <= 9; ++d) {
+        ok = true;
+        for (i = 0; ok && i < sizeof(edges) / sizeof(edges[0]); ++i) ok = check_fixed(edges[i], d);
+        for (v = -100000; ok && v <= 100000; ++v) ok = check_fixed((int32_t)v, d);
+        // a stride prime to 10 reaches every last digit
+        for (v = INT32_MIN; ok && v <= INT32_MAX; v += full ? 1 : 65521) ok = check_fixed((int32_t)v, d);
+        if (ok) check(true, "");
+        if (full) break;        // the complete sweep once, with no decimals
+    }
+    // more than 9 decimals print as 9
+    for (i = 0; i < sizeof(edges) / sizeof(edges[0]); ++i) {
+        char a[16], b[16];
+        SSD1306_FormatFixed(a, edges[i], 12);
+        SSD1306_FormatFixed(b, edges[i], 9);
+        check(!strcmp(a, b), "FormatFixed(%ld, 12) = \"%s\", not \"%s\"", (long)edges[i], a, b);
+    }
+
+    device_open(128, 64);
+    for (i = 0; i < sizeof(edges) / sizeof(edges[0]); ++i) {
+        g_write_int = edges[i];
+        snprintf(text, sizeof(text), "%ld", (long)edges[i]);
+        snprintf(what, sizeof(what), "WriteInt(%s)", text);
+        check_drawn(write_int, text, what);
+    }
+    // quarters at two decimals and whole numbers at none are exact in a float
+    for (v = -4000; v <= 4000; v += 7) {
+        g_write_float = v / 4.0f;
+        g_write_decimals = 2;
+        snprintf(text, sizeof(text), "%.2f", v / 4.0);
+        snprintf(what, sizeof(what), "WriteFloat(%s, 2)", text);
+        check_drawn(write_float, text, what);
+        g_write_float = (float)(v * 1000);
+        g_write_decimals = 0;
+        snprintf(text, sizeof(text), "%ld", (long)(v * 1000));
+        snprintf(what, sizeof(what), "WriteFloat(%s, 0)", text);
+        check_drawn(write_float, text, what);
+    }
+    // past the int32 range once scaled: whole numbers up to 2^64, exact in a
+    // float from 2^24 on, and small values at many decimals
+    for (i = 0; i < 200; ++i) {
+        f = ldexpf((float)rnd_range(-16384, 16384), rnd_range(0, 50));
+        if (i < 40) f = (float)rnd_range(-99, 99);
+        g_write_float = f;
+        g_write_decimals = rnd(10);
+        if (fabsf(f) * powf(10.0f, g_write_decimals) < 2147483648.0f && fabsf(f) < 16777216.0f) continue;
+        snprintf(text, sizeof(text), "%.*f", (int)g_write_decimals, (double)f);
+        snprintf(what, sizeof(what), "WriteFloat(%s, %u)", text, (unsigned)g_write_decimals);
+        check_drawn(write_float, text, what);
+    }
+    g_write_decimals = 2;
+    for (i = 0; i < 4; ++i) {
+        static const char *const want[] = { "inf", "-inf", "inf", "nan" };
+        g_write_float = i == 0 ? 18446744073709551616.0f : i == 1 ? -INFINITY : i == 2 ? INFINITY : NAN;
+        snprintf(what, sizeof(what), "WriteFloat(%s, 2)", want[i]);
+        check_drawn(write_float, want[i], what);
+    }
+}
+
+// --- Widgets ---
+static int32_t rnd_value(int32_t was)
+{
+    switch (rnd(4)) {
+    case 0: return was + rnd_range(-1, 1);
+    case 1: return rnd_range(-1500, 1500);
+    case 2: return (int32_t)(rnd(65536) << 16 | rnd(65536));
+    }
+    return rnd(2) ? INT32_MIN : INT32_MAX;
+}
+
+static void test_widgets(void)
+{
+    static const char *const text[] = { "Widgets", "A longer label than fits", "" };
+    SSD1306_Screen screen;
+    SSD1306_Widget label, number[3], bar;
+    SSD1306_Widget *const all[] = { &label, &number[0], &number[1], &number[2], &bar };
+    Snapshot got, ref;
+    char what[64];
+    int16_t cell = Font6x8.width + 1;
+    uint16_t i, n;
+    uint8_t k, page;
+
+    device_open(128, 64);
+    SSD1306_LabelInit(&label, 0, 0, 60, &Font6x8, text[0]);
+    SSD1306_NumberInit(&number[0], 64, 0, 64, &Font6x8, 0, 0);
+    SSD1306_NumberInit(&number[1], 0, 16, 60, &Font8x12_bold, 0, 2);
+    SSD1306_NumberInit(&number[2], 70, 16, 20, &Font6x8, 0, 1);
+    SSD1306_BarInit(&bar, 0, 40, 128, 10, -1000, 1000, 0);
+    SSD1306_ScreenInit(&screen, g_dev);
+    for (k = 0; k < 5; ++k) SSD1306_ScreenAdd(&screen, all[k]);
+    SSD1306_ScreenRender(&screen);
+
+    for (i = 0; i < 3000; ++i) {
+        for (n = rnd(3) + 1; n; --n) {
+            SSD1306_Widget *w = all[rnd(5)];
+            if (!rnd(8)) SSD1306_WidgetSetVisible(w, !w->visible);
+            else if (w == &label) SSD1306_WidgetSetText(w, text[rnd(3)]);
+            else if (w == &bar) SSD1306_WidgetSetValue(w, rnd_range(-1200, 1200));
+            else SSD1306_WidgetSetValue(w, rnd_value(w->u.number.value));
+        }
+        SSD1306_SetCursor(rnd(128), rnd(64));
+        ref.x0[0] = g_dev->cursor_x;
+        ref.x1[0] = g_dev->cursor_y;
+        SSD1306_ScreenRender(&screen);
+        snprintf(what, sizeof(what), "widgets, update %u", (unsigned)i);
+        check(g_dev->cursor_x == ref.x0[0] && g_dev->cursor_y == ref.x1[0],
+              "%s: cursor moved from (%u, %u) to (%d, %d)", what, (unsigned)ref.x0[0],
+              (unsigned)ref.x1[0], g_dev->cursor_x, g_dev->cursor_y);
+        snap(&got);
+        SSD1306_ScreenInvalidate(&screen);
+        SSD1306_ScreenRender(&screen);
+        snap(&ref);
+        memcpy(ref.x0, got.x0, sizeof(ref.x0));
+        memcpy(ref.x1, got.x1, sizeof(ref.x1));
+        if (!same(&got, &ref, what)) break;
+    }
+
+    // 199 -> 200 rewrites three cells, 200 -> 201 one
+    SSD1306_WidgetSetVisible(&number[0], true);
+    SSD1306_WidgetSetValue(&number[0], 199);
+    SSD1306_ScreenRender(&screen);
+    for (n = 200; n <= 201; ++n) {
+        dirty_clear(g_dev);
+        SSD1306_WidgetSetValue(&number[0], n);
+        SSD1306_ScreenRender(&screen);
+        k = n == 200 ? 3 : 1;
+        for (page = 0; page < g_dev->pages; ++page) {
+            uint8_t x0 = page ? 255 : 128 - k * cell + 1, x1 = page ? 0 : 127;
+            check(g_dev->dirty_x0[page] == x0 && g_dev->dirty_x1[page] == x1,
+                  "counter to %u: page %u dirty from %u to %u, not %u to %u", (unsigned)n,
+                  (unsigned)page, (unsigned)g_dev->dirty_x0[page], (unsigned)g_dev->dirty_x1[page],
+                  (unsigned)x0, (unsigned)x1);
+        }
+    }
+}
+
+// --- Terminal ---
+// Reference terminal: the visible lines as character cells, 0 for empty
+static struct {
+    char line[8][32];
+    uint8_t lines, max_lines, cols, cur, col;
+    bool newline;
+} g_term;
+
+static void term_ref_init(uint8_t rows, const FontDef *font)
+{
+    memset(&g_term, 0, sizeof(g_term));
+    g_term.max_lines = rows / ((font->height + 7) & ~7);
+    g_term.cols = (128 - font->width) / (font->width + 1) + 1;
+    g_term.lines = 1;
+}
+
+static void term_ref_newline(void)
+{
+    g_term.col = 0;
+    g_term.newline = false;
+    if (g_term.lines < g_term.max_lines) {
+        g_term.cur = g_term.lines++;
+    } else {
+        memmove(g_term.line[0], g_term.line[1], sizeof(g_term.line[0]) * (g_term.max_lines - 1));
+        memset(g_term.line[g_term.cur], 0, sizeof(g_term.line[0]));
+    }
+}
+
+static void term_ref_putc(char c)
+{
+    if (c == '\n') {
+        if (g_term.newline) term_ref_newline();
+        g_term.newline = true;
+    } else if (c == '\r') {
+        g_term.col = 0;
+    } else {
+        if (g_term.newline || g_term.col == g_term.cols) term_ref_newline();
+        g_term.line[g_term.cur][g_term.col++] = c;
+    }
+}
+
+// The glass shows the reference lines, one per pitch rows
+static bool term_shows(uint8_t rows, const FontDef *font, const char *what)
+{
+    uint8_t pitch = (font->height + 7) & ~7, per_col = (font->height + 7) / 8, cell = font->width + 1;
+    uint8_t x, y, want;
+    for (y = 0; y < rows; ++y) {
+        for (x = 0; x < 128; ++x) {
+            char c = g_term.line[y / pitch][x / cell];
+            const uint8_t *data = c ? font_glyph(font, c) : NULL;
+            if (c && !data) data = font_glyph(font, '?');
+            want = data && x % cell < font->width && y % pitch < font->height ?
+                   data[x % cell * per_col + y % pitch / 8] >> (y % pitch & 7) & 1 : 0;
+            if (host_panel_pixel(HOST_PANEL, x, y) != want)
+                return check(false, "%s: pixel (%u, %u) of a %u-row panel in %ux%u text is %u",
+                             what, (unsigned)x, (unsigned)y, (unsigned)rows, (unsigned)font->width,
+                             (unsigned)font->height, (unsigned)!want);
+        }
+    }
+    return check(true, "");
+}
+
+static void test_terminal(void)
+{
+    static const uint8_t rows[] = { 64, 32 };
+    char text[40], what[64];
+    uint8_t r, f, k, len;
+    uint16_t i;
+
+    for (r = 0; r < sizeof(rows); ++r) {
+        for (f = 0; f < FONTS; ++f) {
+            host_reset();
+            if (rows[r] == 64) host_init_device(&g_dev_test, 128, 64, g_fb[0], NULL);
+            else host_init_ring(&g_dev_test, 128, rows[r], g_fb[0], NULL);
+            ssd1306_SetFont(g_fonts[f]);
+            check(SSD1306_TermInit(), "TermInit() on a %u-row panel", (unsigned)rows[r]);
+            term_ref_init(rows[r], g_fonts[f]);
+            for (i = 0; i < 400; ++i) {
+                if (!rnd(100)) {
+                    // start again on a clear screen
+                    SSD1306_TermInit();
+                    term_ref_init(rows[r], g_fonts[f]);
+                }
+                len = rnd(sizeof(text));
+                for (k = 0; k < len; ++k) {
+                    uint32_t n = rnd(40);
+                    text[k] = n < 4 ? '\n' : n == 4 ? '\r' : (char)rnd_range(32, 126);
+                    term_ref_putc(text[k]);
+                }
+                SSD1306_TermWrite(text, len);
+                SSD1306_Display();
+                snprintf(what, sizeof(what), "terminal, write %u", (unsigned)i);
+                if (!term_shows(rows[r], g_fonts[f], what)) break;
+            }
+            check(!g_host.violations, "terminal: %lu writes while scrolling", (unsigned long)g_host.violations);
+        }
+    }
+}
+
+// --- Flushes ---
+// The display RAM of panel p holds the frame s
+static bool panel_holds(const HostPanel *p, const Snapshot *s, const char *what)
+{
+    uint8_t page, col;
+    for (page = 0; page < g_dev->pages; ++page)
+        for (col = 0; col < g_dev->width; ++col)
+            if (host_panel_ram(p, page, col) != s->fb[page * SSD1306_STRIDE + col])
+                return check(false, "%s: panel shows 0x%02X at column %u of page %u on a %ux%u panel, "
+                             "not 0x%02X", what, (unsigned)host_panel_ram(p, page, col),
+                             (unsigned)col, (unsigned)page, (unsigned)g_dev->width,
+                             (unsigned)g_dev->height, (unsigned)s->fb[page * SSD1306_STRIDE + col]);
+    return check(true, "");
+}
+
+static bool panel_shows(const Snapshot *s, const char *what)
+{
+    return panel_holds(HOST_PANEL, s, what);
+}
+
+// A few random rectangles and maybe a character
+static void scribble(void)
+{
+    uint8_t k, n = rnd(6);
+    for (k = 0; k < n; ++k)
+        SSD1306_FillRect(rnd_range(-8, SSD1306_Width()), rnd_range(-8, SSD1306_Height()),
+                         rnd(40), rnd(24), rnd(2));
+    if (rnd(2)) {
+        SSD1306_SetCursor(rnd(SSD1306_Width()), rnd(SSD1306_Height()));
+        SSD1306_WriteChar((char)rnd_range(32, 126));
+    }
+}
+
+static void test_flushes(void)
+{
+    static const char *const mode_name[] = { "Display", "DisplayAsync", "delta Display", "DisplayFlush" };
+    static uint8_t shadow[SSD1306_BUFFER_BYTES(64)];
+    Snapshot frame;
+    char what[64];
+    uint8_t g, mode;
+    uint16_t i;
+
+    for (mode = 0; mode < 4; ++mode) {
+        for (g = 0; g < GEOMETRIES; ++g) {
+            device_open(g_geometry[g][0], g_geometry[g][1]);
+            if (mode == 2) SSD1306_SetDeltaFlush(true, shadow);
+            if (mode == 3) SSD1306_DisplayOnBuffer();
+            // background frames stay on the bus until host_run()
+            g_host.hold = mode & 1;
+            for (i = 0; i < 300; ++i) {
+                scribble();
+                snap(&frame);
+                snprintf(what, sizeof(what), "%s, frame %u", mode_name[mode], (unsigned)i);
+                if (mode == 1) SSD1306_DisplayAsync(NULL);
+                else if (mode == 3) SSD1306_DisplayFlush();
+                else SSD1306_Display();
+                if (mode & 1) {
+                    // the next frame is drawn while this one is sent
+                    if (mode == 3) scribble();
+                    host_run();
+                    check(SSD1306_FrameDone(), "%s: not done", what);
+                }
+                if (!panel_shows(&frame, what)) break;
+            }
+            check(!g_host.violations && !g_host.dc_glitches && !g_host.dma_errors,
+                  "%s on a %ux%u panel: %lu writes while scrolling, %lu D/C glitches, %lu uDMA errors",
+                  mode_name[mode], (unsigned)g_dev->width, (unsigned)g_dev->height,
+                  (unsigned long)g_host.violations, (unsigned long)g_host.dc_glitches,
+                  (unsigned long)g_host.dma_errors);
+        }
+    }
+}
+
+// --- Scrolling ---
+// The panel took exactly these command bytes since the log was cleared
+static bool commands_were(const uint8_t *want, uint8_t len, const char *what)
+{
+    uint8_t i;
+    for (i = 0; i < len && i < g_host.cmd_logged && g_host.cmd_log[i] == want[i]; ++i);
+    if (i == len && g_host.cmd_logged == len) return check(true, "");
+    if (i < len && i < g_host.cmd_logged)
+        return check(false, "%s: command byte %u is 0x%02X, not 0x%02X", what, (unsigned)i,
+                     (unsigned)g_host.cmd_log[i], (unsigned)want[i]);
+    return check(false, "%s: %u command bytes, not %u", what, (unsigned)g_host.cmd_logged, (unsigned)len);
+}
+
+static void test_scroll(void)
+{
+    static const uint8_t rows[] = { 64, 32 };
+    Snapshot before, after;
+    char what[64];
+    int16_t y, want_y;
+    uint8_t r, lines, start, row, x, page;
+    uint16_t i;
+
+    for (r = 0; r < sizeof(rows); ++r) {
+        host_reset();
+        if (rows[r] == 64) host_init_device(&g_dev_test, 128, 64, g_fb[0], NULL);
+        else host_init_ring(&g_dev_test, 128, rows[r], g_fb[0], NULL);
+        background(&before);
+        SSD1306_Invalidate();
+        SSD1306_Display();
+        start = 0;
+        for (i = 0; i < 500; ++i) {
+            snprintf(what, sizeof(what), "ScrollUp(), step %u of a %u-row ring", (unsigned)i, (unsigned)rows[r]);
+            lines = rnd(70);
+            snap(&before);
+            y = SSD1306_ScrollUp(lines);
+            snap(&after);
+            if (lines == 0 || lines > 64) {
+                check(y == -1 && !memcmp(before.fb, after.fb, sizeof(before.fb)) && g_dev->start_line == start,
+                      "%s: ScrollUp(%u) returned %d", what, (unsigned)lines, y);
+                continue;
+            }
+            want_y = (start + rows[r]) & 63;
+            check(y == want_y, "%s: ScrollUp(%u) from start line %u returned %d, not %d", what,
+                  (unsigned)lines, (unsigned)start, y, want_y);
+            for (row = 0; row < 64; ++row) {
+                bool exposed = ((row - want_y) & 63) < lines;
+                for (x = 0; x < 128; ++x)
+                    if (fb_pixel(&after, x, row) != (exposed ? false : fb_pixel(&before, x, row))) break;
+                if (!check(x == 128, "%s: row %u %s", what, (unsigned)row,
+                           exposed ? "not cleared" : "changed"))
+                    break;
+                page = row / 8;
+                if (exposed && !check(after.x0[page] == 0 && after.x1[page] == 127,
+                                      "%s: page %u of exposed row %u dirty from %u to %u", what,
+                                      (unsigned)page, (unsigned)row, (unsigned)after.x0[page],
+                                      (unsigned)after.x1[page]))
+                    break;
+            }
+            start = (start + lines) & 63;
+            // new text drawn into the exposed rows
+            SSD1306_FillRect(rnd(128), y, rnd(40), lines, true);
+            snap(&after);
+            SSD1306_Display();
+            check(HOST_PANEL->start_line == start, "%s: panel at start line %u, not %u", what,
+                  (unsigned)HOST_PANEL->start_line, (unsigned)start);
+            if (!panel_shows(&after, what)) break;
+        }
+    }
+
+    // no ring to scroll through, or turned
+    device_open(128, 32);
+    check(SSD1306_ScrollUp(8) == -1, "ScrollUp() on a 32-row framebuffer");
+    device_open(128, 64);
+    SSD1306_SetRotation(SSD1306_ROTATE_90);
+    check(SSD1306_ScrollUp(8) == -1, "ScrollUp() turned 90 degrees");
+
+    // continuous scrolling: deactivate, setup and activate after the data
+    for (r = 0; r < sizeof(rows); ++r) {
+        const uint8_t left[] = { 0x2E, 0x27, 0x00, 1, SSD1306_SCROLL_25_FRAMES, 6, 0x00, 0xFF, 0x2F };
+        const uint8_t right[] = { 0x2E, 0x26, 0x00, 0, SSD1306_SCROLL_2_FRAMES, 7, 0x00, 0xFF, 0x2F };
+        const uint8_t diagonal[] = {
+            0x2E, 0xA3, 0x00, rows[r], 0x29, 0x00, 2, SSD1306_SCROLL_256_FRAMES, 5, 3, 0x2F
+        };
+        const uint8_t diagonal_left[] = {
+            0x2E, 0xA3, 0x00, rows[r], 0x2A, 0x00, 0, SSD1306_SCROLL_5_FRAMES, 7, 63, 0x2F
+        };
+        const uint8_t stop[] = { 0x2E };
+
+        host_reset();
+        if (rows[r] == 64) host_init_device(&g_dev_test, 128, 64, g_fb[0], NULL);
+        else host_init_ring(&g_dev_test, 128, rows[r], g_fb[0], NULL);
+        SSD1306_Display();
+
+        g_host.cmd_logged = 0;
+        SSD1306_ScrollHorizontal(true, 1, 6, SSD1306_SCROLL_25_FRAMES);
+        SSD1306_Display();
+        commands_were(left, sizeof(left), "ScrollHorizontal(left)");
+        check(SSD1306_IsScrolling() && HOST_PANEL->scrolling, "not scrolling left");
+        g_host.cmd_logged = 0;
+        SSD1306_ScrollHorizontal(false, 0, 7, SSD1306_SCROLL_2_FRAMES);
+        SSD1306_Display();
+        commands_were(right, sizeof(right), "ScrollHorizontal(right)");
+        g_host.cmd_logged = 0;
+        SSD1306_ScrollDiagonal(false, 2, 5, SSD1306_SCROLL_256_FRAMES, 3);
+        SSD1306_Display();
+        commands_were(diagonal, sizeof(diagonal), "ScrollDiagonal(right)");
+        g_host.cmd_logged = 0;
+        SSD1306_ScrollDiagonal(true, 0, 7, SSD1306_SCROLL_5_FRAMES, 63);
+        SSD1306_Display();
+        commands_were(diagonal_left, sizeof(diagonal_left), "ScrollDiagonal(left)");
+        SSD1306_StopScroll();
+        g_host.cmd_logged = 0;
+        SSD1306_CommitCommands();
+        commands_were(stop, sizeof(stop), "StopScroll()");
+        check(!SSD1306_IsScrolling() && !HOST_PANEL->scrolling && !g_host.violations,
+              "after StopScroll(): scrolling %u, panel scrolling %u, %lu writes while scrolling",
+              (unsigned)SSD1306_IsScrolling(), (unsigned)HOST_PANEL->scrolling,
+              (unsigned long)g_host.violations);
+    }
+}
+
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+// --- Queued commands ---
+typedef struct {
+    uint32_t starts, bytes, commands;
+} Traffic;
+
+// Bus traffic of one Display()
+static Traffic flushed(void)
+{
+    Traffic t = { g_host.starts, g_host.bytes, g_host.commands };
+    SSD1306_Display();
+    t.starts = g_host.starts - t.starts;
+    t.bytes = g_host.bytes - t.bytes;
+    t.commands = g_host.commands - t.commands;
+    return t;
+}
+
+static bool same_traffic(Traffic got, Traffic want, const char *what)
+{
+    return check(got.starts == want.starts && got.bytes == want.bytes && got.commands == want.commands,
+                 "%s: %lu transactions, %lu bytes, %lu commands, not %lu, %lu, %lu", what,
+                 (unsigned long)got.starts, (unsigned long)got.bytes, (unsigned long)got.commands,
+                 (unsigned long)want.starts, (unsigned long)want.bytes, (unsigned long)want.commands);
+}
+
+static void test_commands(void)
+{
+    Traffic plain, full, t, want;
+    Snapshot frame;
+    uint32_t bytes;
+
+    device_open(128, 64);
+    flushed();
+
+    // repeats coalesce and wait for the flush, which sends them in one
+    // transaction when nothing is dirty
+    bytes = g_host.bytes;
+    SSD1306_Invert(true);
+    SSD1306_SetContrast(10);
+    SSD1306_Invert(false);
+    SSD1306_SetDisplayOn(false);
+    SSD1306_SetContrast(200);
+    SSD1306_Invert(true);
+    SSD1306_SetDisplayOn(true);
+    check(g_host.bytes == bytes, "commands sent before the flush");
+    check(g_dev->cmd_len == 4, "%u bytes queued for invert, contrast and display on, not 4",
+          (unsigned)g_dev->cmd_len);
+    want = (Traffic){ 1, 1 + 4, 3 };
+    same_traffic(flushed(), want, "invert, contrast and display on alone");
+    check(HOST_PANEL->inverse && HOST_PANEL->contrast == 200 && HOST_PANEL->on,
+          "panel left inverse %u, contrast %u, on %u", (unsigned)HOST_PANEL->inverse,
+          (unsigned)HOST_PANEL->contrast, (unsigned)HOST_PANEL->on);
+    same_traffic(flushed(), (Traffic){ 0, 0, 0 }, "empty flush");
+
+    // with data they ride in the window command's transaction
+    SSD1306_DrawPixel(10, 10, true);
+    plain = flushed();
+    SSD1306_DrawPixel(20, 10, true);
+    SSD1306_Invert(false);
+    SSD1306_SetContrast(50);
+    want = plain;
+    want.bytes += 3;
+    want.commands += 2;
+    same_traffic(flushed(), want, "invert and contrast with a pixel");
+
+    // the start line follows the data in a transaction of its own, which the
+    // other commands share when nothing is dirty
+    SSD1306_DrawPixel(30, 10, true);
+    SSD1306_SetStartLine(5);
+    want = plain;
+    want.starts += 1;
+    want.bytes += 2;
+    want.commands += 1;
+    same_traffic(flushed(), want, "start line with a pixel");
+    SSD1306_SetStartLine(9);
+    SSD1306_SetStartLine(7);
+    SSD1306_Invert(true);
+    same_traffic(flushed(), (Traffic){ 1, 1 + 2, 2 }, "start line and invert alone");
+    check(HOST_PANEL->start_line == 7 && HOST_PANEL->inverse, "panel left at start line %u, inverse %u",
+          (unsigned)HOST_PANEL->start_line, (unsigned)HOST_PANEL->inverse);
+    SSD1306_SetStartLine(0);
+    flushed();
+
+    // rotation leads the full rewrite it asks for
+    SSD1306_Invalidate();
+    full = flushed();
+    SSD1306_SetRotation(SSD1306_ROTATE_180);
+    SSD1306_SetRotation(SSD1306_ROTATE_0);
+    SSD1306_SetRotation(SSD1306_ROTATE_180);
+    want = full;
+    want.bytes += 2;
+    want.commands += 2;
+    same_traffic(flushed(), want, "rotation");
+    check(!HOST_PANEL->seg_remap && !HOST_PANEL->com_remap, "panel not turned");
+    SSD1306_SetRotation(SSD1306_ROTATE_0);
+    flushed();
+
+    // a scroll start follows the data between deactivate and activate; a
+    // later setup replaces it
+    SSD1306_DrawPixel(40, 10, true);
+    SSD1306_ScrollDiagonal(true, 0, 7, SSD1306_SCROLL_2_FRAMES, 1);
+    SSD1306_ScrollHorizontal(false, 0, 7, SSD1306_SCROLL_5_FRAMES);
+    want = plain;
+    want.starts += 1;
+    want.bytes += 1 + 1 + 7 + 1;
+    want.commands += 3;
+    same_traffic(flushed(), want, "horizontal scroll with a pixel");
+    check(HOST_PANEL->scrolling, "panel not scrolling");
+
+    // a stop leads the rewrite of the RAM the scroll moved
+    scribble();
+    snap(&frame);
+    SSD1306_StopScroll();
+    want = full;
+    want.bytes += 1;
+    want.commands += 1;
+    same_traffic(flushed(), want, "scroll stop");
+    check(!HOST_PANEL->scrolling && !g_host.violations, "panel scrolling %u, %lu bytes written while scrolling",
+          (unsigned)HOST_PANEL->scrolling, (unsigned long)g_host.violations);
+    panel_shows(&frame, "after the scroll stop");
+
+    // a start and a stop before the flush leave the panel still
+    SSD1306_ScrollHorizontal(true, 0, 3, SSD1306_SCROLL_2_FRAMES);
+    SSD1306_StopScroll();
+    flushed();
+    check(!HOST_PANEL->scrolling, "panel scrolling after start and stop in one flush");
+
+    // CommitCommands() sends the queue without a flush
+    SSD1306_DrawPixel(50, 10, true);
+    SSD1306_SetContrast(99);
+    t = (Traffic){ g_host.starts, g_host.bytes, g_host.commands };
+    check(SSD1306_CommitCommands(), "CommitCommands() failed");
+    check(g_host.starts - t.starts == 1 && HOST_PANEL->contrast == 99 && g_dev->dirty_x1[1] >= 50,
+          "CommitCommands(): %lu transactions, contrast %u, pixel %s",
+          (unsigned long)(g_host.starts - t.starts), (unsigned)HOST_PANEL->contrast,
+          g_dev->dirty_x1[1] >= 50 ? "still dirty" : "sent");
+}
+
+// --- Recovery from a failed flush ---
+static void test_recovery(void)
+{
+    static const char *const mode_name[] = { "Display", "DisplayAsync" };
+    Snapshot frame;
+    char what[64];
+    uint32_t errors, nacked, sent, ref;
+    uint16_t i;
+    uint8_t mode, page, line, contrast;
+    bool invert;
+
+    for (mode = 0; mode < 2; ++mode) {
+        device_open(128, 64);
+        g_host.hold = mode;
+        nacked = 0;
+        for (i = 0; i < 400; ++i) {
+            snprintf(what, sizeof(what), "%s, frame %u", mode_name[mode], (unsigned)i);
+            scribble();
+            invert = rnd(2);
+            contrast = rnd(256);
+            line = rnd(64);
+            SSD1306_Invert(invert);
+            SSD1306_SetContrast(contrast);
+            SSD1306_SetStartLine(line);
+            snap(&frame);
+            errors = g_dev->stats.errors;
+            g_host.nack_after = 1 + rnd(300);
+            if (mode) {
+                SSD1306_DisplayAsync(NULL);
+                host_run();
+            } else {
+                SSD1306_Display();
+            }
+            g_host.nack_after = 0;
+            if (g_dev->stats.errors == errors) continue;
+            ++nacked;
+            // a command queued since replaces the one the frame carried
+            if (rnd(2)) {
+                contrast = rnd(256);
+                SSD1306_SetContrast(contrast);
+            }
+            // async frames are recovered by the next flush; do that part now
+            flush_recover(g_dev);
+            for (page = 0; page < g_dev->pages; ++page)
+                if (!check(g_dev->dirty_x0[page] == 0 && g_dev->dirty_x1[page] == g_dev->width - 1,
+                           "%s: page %u dirty from %u to %u after the NACK", what, (unsigned)page,
+                           (unsigned)g_dev->dirty_x0[page], (unsigned)g_dev->dirty_x1[page]))
+                    break;
+
+            sent = g_host.bytes;
+            SSD1306_Display();
+            sent = g_host.bytes - sent;
+            panel_shows(&frame, what);
+            check(HOST_PANEL->inverse == invert && HOST_PANEL->contrast == contrast &&
+                  HOST_PANEL->start_line == line,
+                  "%s: panel left inverse %u, contrast %u, start line %u, not %u, %u, %u", what,
+                  (unsigned)HOST_PANEL->inverse, (unsigned)HOST_PANEL->contrast,
+                  (unsigned)HOST_PANEL->start_line, (unsigned)invert, (unsigned)contrast,
+                  (unsigned)line);
+
+            // the same again, asked for explicitly
+            ref = g_host.bytes;
+            SSD1306_Invert(invert);
+            SSD1306_SetContrast(contrast);
+            SSD1306_SetStartLine(line);
+            SSD1306_Invalidate();
+            SSD1306_Display();
+            ref = g_host.bytes - ref;
+            check(sent == ref, "%s: the retry sent %lu bytes, a full redraw with the same commands %lu",
+                  what, (unsigned long)sent, (unsigned long)ref);
+        }
+        check(nacked > 100, "%s: only %lu of 400 frames NACKed", mode_name[mode], (unsigned long)nacked);
+    }
+}
+
+// --- Shared bus ---
+static void test_shared(void)
+{
+    static SSD1306_Device dev[2];
+    static uint8_t fb[2][SSD1306_BUFFER_BYTES(64)];
+    Snapshot frame[2];
+    char what[64];
+    uint32_t errors[2], nacked = 0;
+    uint16_t i;
+    uint8_t k;
+
+    host_reset();
+    // busy polls, so the error STOP is still on the bus when first polled
+    g_host.poll_cycles = 40;
+    for (k = 0; k < 2; ++k) {
+        SSD1306_InitDevice(&dev[k], I2C0_BASE, 0x3C + k, 128, 64, fb[k], NULL);
+        check(SSD1306_Width() == 128, "0x%02X: not opened", 0x3C + k);
+    }
+    g_host.hold = true;
+    for (i = 0; i < 200; ++i) {
+        for (k = 0; k < 2; ++k) {
+            SSD1306_Select(&dev[k]);
+            scribble();
+            snap(&frame[k]);
+            errors[k] = dev[k].stats.errors;
+        }
+        // one byte of either frame, or none if both are short
+        g_host.nack_after = 1 + rnd(600);
+        for (k = 0; k < 2; ++k) {
+            SSD1306_Select(&dev[k]);
+            SSD1306_DisplayAsync(NULL);
+        }
+        host_run();
+        for (k = 0; k < 2; ++k) {
+            SSD1306_Select(&dev[k]);
+            snprintf(what, sizeof(what), "0x%02X, frame %u", 0x3C + k, (unsigned)i);
+            check(SSD1306_FrameDone(), "%s: not done", what);
+            if (dev[k].stats.errors == errors[k]) panel_holds(&g_host_panel[0][k], &frame[k], what);
+            else ++nacked;
+        }
+        // the failed frame is sent again with the next flush
+        g_host.nack_after = 0;
+        for (k = 0; k < 2; ++k) {
+            SSD1306_Select(&dev[k]);
+            SSD1306_DisplayAsync(NULL);
+        }
+        host_run();
+        for (k = 0; k < 2; ++k) {
+            SSD1306_Select(&dev[k]);
+            snprintf(what, sizeof(what), "0x%02X, frame %u repaired", 0x3C + k, (unsigned)i);
+            panel_holds(&g_host_panel[0][k], &frame[k], what);
+        }
+    }
+    check(nacked > 50, "only %lu of 400 frames NACKed", (unsigned long)nacked);
+    check(!g_host.stale_irqs, "%lu commands issued with an interrupt pending",
+          (unsigned long)g_host.stale_irqs);
+}
+
+// --- Bus speed ---
+// Timer period for scl_hz as documented: the smallest TPR in 1..127 for which
+// SCL = sysclk / (20 * (1 + TPR)) is not above scl_hz
+static uint32_t ref_tpr(uint32_t sysclk, uint32_t scl_hz)
+{
+    uint32_t tpr;
+    if (!scl_hz) return 127;
+    for (tpr = 1; tpr < 127 && (uint64_t)scl_hz * 20 * (tpr + 1) < sysclk; ++tpr);
+    return tpr;
+}
+
+// What ProbeBusSpeed() should settle on with panels following up to panel_hz
+static uint32_t ref_probe(uint32_t panel_hz, uint32_t max_hz)
+{
+    static const uint32_t rates[] = { 100000, 400000, 1000000, 1500000, 2000000, 3000000 };
+    uint32_t hz, best = 0;
+    uint8_t i;
+    for (i = 0; i < sizeof(rates) / sizeof(rates[0]) && rates[i] <= max_hz; ++i) {
+        hz = HOST_SYSCLK / (20 * (ref_tpr(HOST_SYSCLK, rates[i]) + 1));
+        if (hz <= best || (panel_hz && hz > panel_hz)) break;
+        best = hz;
+    }
+    return best;
+}
+
+static void test_speed(void)
+{
+    static const uint32_t sysclk[] = { 16000000, 50000000, 80000000 };
+    static const uint32_t panel_hz[] = { 0, 99999, 100000, 400000, 1000000, 1333333, 2000000, 2500000 };
+    static const uint32_t max_hz[] = { 0, 100000, 1000000, 3000000 };
+    Snapshot frame;
+    uint32_t hz, got, want, bytes[2];
+    uint8_t c, p, m;
+    uint16_t i;
+
+    device_open(128, 64);
+    for (c = 0; c < sizeof(sysclk) / sizeof(sysclk[0]); ++c) {
+        for (i = 0; i < 2000; ++i) {
+            hz = i < 2 ? i : rnd(4000000);
+            got = SSD1306_SetBusSpeed(I2C0_BASE, sysclk[c], hz);
+            want = ref_tpr(sysclk[c], hz);
+            if (!check(g_host_i2c[0].mtpr == want && got == sysclk[c] / (20 * (want + 1)),
+                       "SetBusSpeed(%lu Hz) at %lu Hz: TPR %lu returning %lu, not %lu returning %lu",
+                       (unsigned long)hz, (unsigned long)sysclk[c], (unsigned long)g_host_i2c[0].mtpr,
+                       (unsigned long)got, (unsigned long)want,
+                       (unsigned long)(sysclk[c] / (20 * (want + 1)))))
+                break;
+        }
+    }
+
+    for (p = 0; p < sizeof(panel_hz) / sizeof(panel_hz[0]); ++p) {
+        for (m = 0; m < sizeof(max_hz) / sizeof(max_hz[0]); ++m) {
+            device_open(128, 64);
+            scribble();
+            snap(&frame);
+            g_host.panel_max_hz = panel_hz[p];
+            got = SSD1306_ProbeBusSpeed(HOST_SYSCLK, max_hz[m]);
+            want = ref_probe(panel_hz[p], max_hz[m]);
+            check(got == want, "ProbeBusSpeed(%lu Hz) with a panel following %lu Hz: %lu, not %lu",
+                  (unsigned long)max_hz[m], (unsigned long)panel_hz[p], (unsigned long)got,
+                  (unsigned long)want);
+            if (!want) continue;
+            check(host_scl_hz(0) == want, "ProbeBusSpeed() returned %lu Hz but left SCL at %lu Hz",
+                  (unsigned long)want, (unsigned long)host_scl_hz(0));
+            check(HOST_PANEL->on, "probed panel left off");
+            panel_shows(&frame, "after ProbeBusSpeed()");
+        }
+    }
+
+    // at 16 MHz nothing is faster than 400 kHz: probing up to 3 MHz must not
+    // send more than probing up to 400 kHz
+    for (m = 0; m < 2; ++m) {
+        device_open(128, 64);
+        got = SSD1306_ProbeBusSpeed(16000000, m ? 3000000 : 400000);
+        bytes[m] = g_host.bytes;
+        check(got == 400000, "ProbeBusSpeed() at 16 MHz: %lu Hz, not 400 kHz", (unsigned long)got);
+    }
+    check(bytes[1] == bytes[0], "ProbeBusSpeed() at 16 MHz sent %lu bytes up to 3 MHz, %lu up to 400 kHz",
+          (unsigned long)bytes[1], (unsigned long)bytes[0]);
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    bool full = argc > 1 && !strcmp(argv[1], "--full");
+
+    test_fills();
+    test_glyphs();
+    test_rotation();
+    test_shapes();
+    test_numbers(full);
+    test_widgets();
+    test_terminal();
+    test_flushes();
+    test_scroll();
+#if SSD1306_TRANSPORT == SSD1306_TRANSPORT_I2C
+    test_commands();
+    test_recovery();
+    test_shared();
+    test_speed();
+#endif
+    printf("%lu checks, %lu failed\n", (unsigned long)g_checks, (unsigned long)g_failures);
+    return g_failures ? 1 : 0;
+}